@@ -0,0 +1,75 @@
+// Measures event log formatting throughput: the buffered to_chars EventLog against per-line ostream formatting
+// (PrintFieldVisitor + std::endl, the previous EventLog).
+// Usage: sw_battle_bench_log [events] [output_path]
+#include "IO/Events/UnitAttacked.hpp"
+#include "IO/Events/UnitMoved.hpp"
+#include "IO/Events/UnitSpawned.hpp"
+#include "IO/System/EventLog.hpp"
+#include "IO/System/details/PrintFieldVisitor.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+	using namespace sw::io;
+
+	template <class TLog>
+	void emit(TLog&& log, uint64_t events)
+	{
+		for (uint64_t i = 0; i < events; ++i)
+		{
+			const auto id = static_cast<uint32_t>(i);
+			switch (i % 3)
+			{
+				case 0:
+					log(i / 3, UnitSpawned{id, "Swordsman", id % 4096, id / 4096});
+					break;
+				case 1:
+					log(i / 3, UnitMoved{id, id % 4096, id / 4096});
+					break;
+				default:
+					log(i / 3, UnitAttacked{id, id + 1, 5, id % 100});
+					break;
+			}
+		}
+	}
+
+	template <class TLog>
+	void measure(const char* name, uint64_t events, TLog&& log)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		emit(log, events);
+		const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+		std::cout << name << ": " << static_cast<double>(events) / elapsed.count() / 1e6 << " M events/s\n";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const uint64_t events = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 3'000'000;
+	const char* path = argc > 2 ? argv[2] : "/dev/null";
+
+	{
+		std::ofstream out(path);
+		measure(
+			"ostream ",
+			events,
+			[&out](uint64_t tick, auto&& event)
+			{
+				out << "[" << tick << "] " << event.Name << " ";
+				sw::PrintFieldVisitor visitor(out);
+				event.visit(visitor);
+				out << std::endl;
+			});
+	}
+	{
+		std::ofstream out(path);
+		sw::EventLog log(out);
+		measure("EventLog", events, [&log](uint64_t tick, auto&& event) { log.log(tick, event); });
+	}
+	return 0;
+}
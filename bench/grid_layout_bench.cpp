@@ -0,0 +1,74 @@
+// Compares GridLayout::RowMajor against GridLayout::Tiled on a wide map.
+// Usage: sw_battle_bench_grid [width] [height] [density_percent]
+#include "Core/GameWorld.hpp"
+#include "Core/Unit.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+	using namespace sw::core;
+
+	struct Lcg
+	{
+		uint64_t state;
+
+		uint32_t next()
+		{
+			state = state * 6364136223846793005ull + 1442695040888963407ull;
+			return static_cast<uint32_t>(state >> 33);
+		}
+	};
+
+	void runLayout(const char* name, GridLayout layout, uint32_t width, uint32_t height, uint32_t density)
+	{
+		GameWorld world(width, height, layout);
+		std::vector<Position> positions;
+
+		Lcg rng{42};
+		const uint64_t target = static_cast<uint64_t>(width) * height * density / 100;
+		UnitId nextId = 1;
+		while (positions.size() < target)
+		{
+			const Position pos{rng.next() % width, rng.next() % height};
+			if (world.testCell(CellLayer::Occupied, pos))
+			{
+				continue;
+			}
+			world.addUnit(Unit(nextId++), pos);
+			positions.push_back(pos);
+		}
+
+		for (const uint32_t range : {1u, 8u})
+		{
+			uint64_t visited = 0;
+			const auto start = std::chrono::steady_clock::now();
+			for (const auto& pos : positions)
+			{
+				world.forEachUnitInRange(
+					CellLayer::Occupied, pos, 1, range, RangeStrategy::CellScan, [&](const Unit&) { ++visited; });
+			}
+			const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+			std::cout << name << " R=" << range << ": " << positions.size() << " queries, "
+					  << elapsed.count() / static_cast<double>(positions.size()) << " ns/query (visited " << visited
+					  << ")\n";
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const uint32_t width = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 8192;
+	const uint32_t height = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 512;
+	const uint32_t density = argc > 3 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 10;
+
+	std::cout << "Map " << width << "x" << height << ", density " << density << "%\n";
+	runLayout("RowMajor", GridLayout::RowMajor, width, height, density);
+	runLayout("Tiled   ", GridLayout::Tiled, width, height, density);
+	return 0;
+}
@@ -0,0 +1,89 @@
+// Measures a full battle played with the event log, with NullEvents behind IGameEvents& (virtual calls into empty
+// handlers) and with NullEvents itself (the --quiet path, where behaviors see the final type).
+// Usage: sw_battle_bench_quiet [units] [map_side] [output_path]
+#include "App/Simulation.hpp"
+#include "Core/GameWorld.hpp"
+#include "Core/NullEvents.hpp"
+#include "Features/Components.hpp"
+#include "Features/Hunter.hpp"
+#include "Features/Swordsman.hpp"
+#include "IO/System/EventLog.hpp"
+#include "IO/System/GameLogger.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+namespace
+{
+	using namespace sw::core;
+
+	struct Lcg
+	{
+		uint64_t state;
+
+		uint32_t next()
+		{
+			state = state * 6364136223846793005ull + 1442695040888963407ull;
+			return static_cast<uint32_t>(state >> 33);
+		}
+	};
+
+	// Every run starts from the same world: mixed units marching on the map's centre
+	std::unique_ptr<GameWorld> buildBattle(uint32_t units, uint32_t side)
+	{
+		auto world = std::make_unique<GameWorld>(side, side);
+		world->getRandom().reseed(7);
+		Lcg rng{42};
+		const Position centre{side / 2, side / 2};
+		for (UnitId id = 1; id <= units;)
+		{
+			const Position pos{rng.next() % side, rng.next() % side};
+			if (world->testCell(CellLayer::Occupied, pos))
+			{
+				continue;
+			}
+			auto unit =
+				id % 4 == 0 ? sw::features::makeHunter(id, 20, 3, 2, 6) : sw::features::makeSwordsman(id, 20, 3);
+			unit.addComponent<sw::features::MarchComponent>(centre);
+			world->addUnit(std::move(unit), pos);
+			++id;
+		}
+		return world;
+	}
+
+	template <class TEvents>
+	void measure(const char* name, uint32_t units, uint32_t side, TEvents& events, uint64_t& tick)
+	{
+		auto world = buildBattle(units, side);
+		tick = 1;
+		const auto start = std::chrono::steady_clock::now();
+		const auto stats = sw::app::runSimulation(*world, events, tick);
+		const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+		std::cout << name << ": " << stats.ticks << " ticks in " << elapsed.count() << " ms, "
+				  << world->getUnitCount() << " units left, hash " << world->getStateHash() << "\n";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const uint32_t units = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 20000;
+	const uint32_t side = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 400;
+	const char* path = argc > 3 ? argv[3] : "/dev/null";
+
+	uint64_t tick = 1;
+	{
+		std::ofstream out(path);
+		sw::EventLog log(out);
+		sw::io::GameLogger logger(log, tick);
+		measure("logged  ", units, side, logger, tick);
+	}
+	NullEvents nullEvents;
+	IGameEvents& virtualEvents = nullEvents;
+	measure("virtual ", units, side, virtualEvents, tick);
+	measure("quiet   ", units, side, nullEvents, tick);
+	return 0;
+}
@@ -0,0 +1,45 @@
+#include "Checkpoint.hpp"
+
+#include "../Features/Snapshot.hpp"
+#include "../IO/System/MappedFile.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace sw::app
+{
+	void writeCheckpoint(const std::string& path, const core::GameWorld& world, uint64_t tick)
+	{
+		const auto bytes = core::saveSnapshot(world, tick, features::snapshotTypes());
+		const std::string temporary = path + ".tmp";
+		{
+			std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+			if (!stream.is_open())
+			{
+				throw std::runtime_error("Failed to open file: " + temporary);
+			}
+
+			stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+			stream.flush();
+			if (!stream)
+			{
+				throw std::runtime_error("Failed to write checkpoint: " + temporary);
+			}
+		}
+		std::filesystem::rename(temporary, path);
+	}
+
+	core::WorldSnapshot readCheckpoint(const std::string& path)
+	{
+		io::MappedFile file(path);
+		try
+		{
+			return core::loadSnapshot(file.bytes(), features::snapshotTypes());
+		}
+		catch (const std::runtime_error& e)
+		{
+			throw std::runtime_error(path + ": " + e.what());
+		}
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "../Core/GameWorld.hpp"
+#include "../Core/Snapshot.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace sw::app
+{
+	// Saves the world between ticks (`tick` is the next tick to play). The snapshot is written in one pass to a
+	// temporary file and renamed over `path`, so a crash never leaves a partial checkpoint behind.
+	void writeCheckpoint(const std::string& path, const core::GameWorld& world, uint64_t tick);
+
+	// Loads a checkpoint written by writeCheckpoint (memory-mapped where available)
+	core::WorldSnapshot readCheckpoint(const std::string& path);
+}
@@ -0,0 +1,177 @@
+#include "CompiledScenario.hpp"
+
+#include "ScenarioRunner.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace sw::app
+{
+	namespace
+	{
+		constexpr char Magic[8] = {'S', 'W', 'S', 'C', 'N', '0', '0', '1'};
+		constexpr uint32_t Version = 1;
+		// The source fields follow the magic and version
+		constexpr size_t SourceOffset = sizeof(Magic) + sizeof(Version);
+
+		void writeSource(core::SnapshotWriter& writer, const ScenarioSource& source)
+		{
+			writer.write(source.size);
+			writer.write(source.modified);
+			writer.write(source.hash);
+		}
+
+		std::string cacheName(const std::filesystem::path& path)
+		{
+			char name[24];
+			const auto key = hashScenarioText(std::filesystem::absolute(path).lexically_normal().string());
+			std::snprintf(name, sizeof(name), "%016llx.swb", static_cast<unsigned long long>(key));
+			return name;
+		}
+	}
+
+	uint64_t hashScenarioText(std::string_view text)
+	{
+		uint64_t hash = 0xcbf2'9ce4'8422'2325ull;
+		for (const char c : text)
+		{
+			hash = (hash ^ static_cast<unsigned char>(c)) * 0x0000'0100'0000'01b3ull;
+		}
+		return hash;
+	}
+
+	ScenarioSource describeScenarioFile(const std::filesystem::path& path, std::string_view text)
+	{
+		return ScenarioSource{
+			text.size(),
+			static_cast<int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count()),
+			hashScenarioText(text)};
+	}
+
+	bool isCompiledScenario(std::span<const std::byte> bytes)
+	{
+		return bytes.size() >= sizeof(Magic) && std::memcmp(bytes.data(), Magic, sizeof(Magic)) == 0;
+	}
+
+	void writeScenarioHeader(
+		core::SnapshotWriter& writer, const ScenarioSource& source, std::span<const std::string_view> names)
+	{
+		writer.writeBytes(std::as_bytes(std::span(Magic)));
+		writer.write(Version);
+		writeSource(writer, source);
+		writer.write(static_cast<uint16_t>(names.size()));
+		for (const auto name : names)
+		{
+			writer.write(static_cast<uint8_t>(name.size()));
+			writer.writeBytes(std::as_bytes(std::span(name.data(), name.size())));
+		}
+	}
+
+	ScenarioHeader readScenarioHeader(core::SnapshotReader& reader)
+	{
+		if (!isCompiledScenario(reader.readBytes(std::min(sizeof(Magic), reader.remaining()))))
+		{
+			throw std::runtime_error("Not a compiled scenario");
+		}
+		if (const auto version = reader.read<uint32_t>(); version != Version)
+		{
+			throw std::runtime_error("Unsupported compiled scenario version: " + std::to_string(version));
+		}
+
+		ScenarioHeader header;
+		header.source.size = reader.read<uint64_t>();
+		header.source.modified = reader.read<int64_t>();
+		header.source.hash = reader.read<uint64_t>();
+		header.commands.resize(reader.read<uint16_t>());
+		for (auto& command : header.commands)
+		{
+			const auto name = reader.readBytes(reader.read<uint8_t>());
+			command.assign(reinterpret_cast<const char*>(name.data()), name.size());
+		}
+		return header;
+	}
+
+	void writeCompiledScenario(const std::filesystem::path& path, std::span<const std::byte> bytes)
+	{
+		// A name of its own, so concurrent runs sharing the cache never write into each other's file
+		char suffix[24];
+		std::snprintf(suffix, sizeof(suffix), ".%08x.tmp", std::random_device{}());
+		auto temporary = path;
+		temporary += suffix;
+		try
+		{
+			std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+			if (!stream.is_open())
+			{
+				throw std::runtime_error("Failed to open file: " + temporary.string());
+			}
+
+			stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+			stream.flush();
+			if (!stream)
+			{
+				throw std::runtime_error("Failed to write compiled scenario: " + temporary.string());
+			}
+			stream.close();
+			std::filesystem::rename(temporary, path);
+		}
+		catch (...)
+		{
+			std::error_code ignored;
+			std::filesystem::remove(temporary, ignored);
+			throw;
+		}
+	}
+
+	CompiledScenario loadCachedScenario(const std::filesystem::path& path, const std::filesystem::path& cacheDirectory)
+	{
+		const auto entry = cacheDirectory / cacheName(path);
+		const auto size = std::filesystem::file_size(path);
+		const auto modified = static_cast<int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+
+		std::unique_ptr<io::MappedFile> cached;
+		ScenarioSource recorded;
+		if (std::filesystem::exists(entry))
+		{
+			try
+			{
+				cached = std::make_unique<io::MappedFile>(entry.string());
+				core::SnapshotReader reader(cached->bytes());
+				recorded = readScenarioHeader(reader).source;
+				if (recorded.size == size && recorded.modified == modified)
+				{
+					return CompiledScenario(std::move(cached));
+				}
+			}
+			catch (const std::runtime_error&)
+			{
+				// Unreadable or outdated entries are rebuilt
+				cached.reset();
+			}
+		}
+
+		io::MappedFile file(path.string());
+		const std::string_view text(reinterpret_cast<const char*>(file.bytes().data()), file.bytes().size());
+		const auto source = describeScenarioFile(path, text);
+
+		std::filesystem::create_directories(cacheDirectory);
+		if (cached && recorded.size == source.size && recorded.hash == source.hash)
+		{
+			// Touched but unchanged: keep the records, refresh the recorded mtime
+			std::vector<std::byte> bytes(cached->bytes().begin(), cached->bytes().end());
+			std::vector<std::byte> patched;
+			core::SnapshotWriter writer(patched);
+			writeSource(writer, source);
+			std::copy(patched.begin(), patched.end(), bytes.begin() + SourceOffset);
+			writeCompiledScenario(entry, bytes);
+			return CompiledScenario(std::move(bytes));
+		}
+
+		auto bytes = ScenarioRunner::compile(text, source);
+		writeCompiledScenario(entry, bytes);
+		return CompiledScenario(std::move(bytes));
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../Core/SnapshotTypes.hpp"
+#include "../IO/System/MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sw::app
+{
+	// Compiled scenarios (.swb) hold the command stream of a text scenario, with comments and line parsing gone:
+	//     "SWSCN001", u32 version, source (u64 size, i64 mtime, u64 hash), u16 command count + names (u8 length),
+	//     then records: u8 index into the names followed by the command's fields (through its `visit`), or
+	//     TickRecord + u64 tick, which tags every following command with that tick (see ScenarioRunner).
+	namespace compiled
+	{
+		inline constexpr uint8_t TickRecord = 0xFF;
+	}
+
+	// Identifies the text a compiled scenario was built from
+	struct ScenarioSource
+	{
+		uint64_t size{};
+		// Modification time in file clock ticks
+		int64_t modified{};
+		uint64_t hash{};
+
+		bool operator==(const ScenarioSource&) const = default;
+	};
+
+	// FNV-1a over the scenario text
+	uint64_t hashScenarioText(std::string_view text);
+
+	// Size, modification time and text hash of a scenario file
+	ScenarioSource describeScenarioFile(const std::filesystem::path& path, std::string_view text);
+
+	[[nodiscard]]
+	bool isCompiledScenario(std::span<const std::byte> bytes);
+
+	void writeScenarioHeader(
+		core::SnapshotWriter& writer, const ScenarioSource& source, std::span<const std::string_view> names);
+
+	struct ScenarioHeader
+	{
+		ScenarioSource source;
+		std::vector<std::string> commands;
+	};
+
+	// Throws std::runtime_error unless `reader` starts with a supported compiled scenario header
+	ScenarioHeader readScenarioHeader(core::SnapshotReader& reader);
+
+	// Writes a uniquely named temporary file and renames it over `path`; the temporary is removed on failure
+	void writeCompiledScenario(const std::filesystem::path& path, std::span<const std::byte> bytes);
+
+	/// @brief A compiled scenario in memory: mapped from disk, or freshly compiled.
+	class CompiledScenario
+	{
+	private:
+		std::unique_ptr<io::MappedFile> _file;
+		std::vector<std::byte> _bytes;
+
+	public:
+		explicit CompiledScenario(std::unique_ptr<io::MappedFile> file) :
+				_file(std::move(file))
+		{}
+
+		explicit CompiledScenario(std::vector<std::byte> bytes) :
+				_bytes(std::move(bytes))
+		{}
+
+		[[nodiscard]]
+		std::span<const std::byte> bytes() const noexcept
+		{
+			return _file ? _file->bytes() : std::span<const std::byte>(_bytes);
+		}
+	};
+
+	// Compiled form of the scenario at `path`, kept in `cacheDirectory` under a name derived from the path.
+	// The cache entry is used while its recorded size and mtime match the file, or failing that its text hash;
+	// otherwise the text is compiled (ScenarioRunner::compile) and replaces the entry.
+	CompiledScenario loadCachedScenario(const std::filesystem::path& path, const std::filesystem::path& cacheDirectory);
+}
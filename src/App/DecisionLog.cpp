@@ -0,0 +1,115 @@
+#include "DecisionLog.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace sw::app
+{
+	namespace
+	{
+		constexpr char Magic[8] = {'S', 'W', 'D', 'E', 'C', '0', '0', '1'};
+		constexpr size_t BufferSize = size_t{64} << 10;
+
+		std::span<const std::byte> choicesOf(const io::MappedFile& file, const std::string& path)
+		{
+			const auto bytes = file.bytes();
+			if (bytes.size() < sizeof(Magic) || std::memcmp(bytes.data(), Magic, sizeof(Magic)) != 0)
+			{
+				throw std::runtime_error("Not a decision log: " + path);
+			}
+			return bytes.subspan(sizeof(Magic));
+		}
+	}
+
+	DecisionRecorder::DecisionRecorder(const std::string& path) :
+			_stream(path, std::ios::binary | std::ios::trunc),
+			_path(path)
+	{
+		if (!_stream.is_open())
+		{
+			throw std::runtime_error("Failed to open file: " + path);
+		}
+		_buffer.reserve(BufferSize + 16);
+		_stream.write(Magic, sizeof(Magic));
+	}
+
+	DecisionRecorder::~DecisionRecorder()
+	{
+		try
+		{
+			finish();
+		}
+		catch (...)
+		{
+			// Destructors must not throw; call finish() to see write errors
+		}
+	}
+
+	uint64_t DecisionRecorder::choose(uint64_t count, core::Random& random)
+	{
+		const uint64_t index = random.nextBelow(count);
+		io::appendVarint(_buffer, index);
+		++_count;
+		if (_buffer.size() >= BufferSize)
+		{
+			writeBuffer();
+		}
+		return index;
+	}
+
+	void DecisionRecorder::writeBuffer()
+	{
+		_stream.write(reinterpret_cast<const char*>(_buffer.data()), static_cast<std::streamsize>(_buffer.size()));
+		_buffer.clear();
+	}
+
+	void DecisionRecorder::finish()
+	{
+		if (_finished)
+		{
+			return;
+		}
+		_finished = true;
+		writeBuffer();
+		_stream.flush();
+		if (!_stream)
+		{
+			throw std::runtime_error("Failed to write decision log: " + _path);
+		}
+	}
+
+	DecisionReplayer::DecisionReplayer(const std::string& path) :
+			_file(path),
+			_reader(choicesOf(_file, path))
+	{}
+
+	uint64_t DecisionReplayer::choose(uint64_t count, core::Random&)
+	{
+		if (_reader.atEnd())
+		{
+			throw std::runtime_error(
+				"Decision log ended after " + std::to_string(_count)
+				+ " choices; it was recorded for another scenario");
+		}
+		const uint64_t index = _reader.read();
+		if (index >= count)
+		{
+			throw std::runtime_error(
+				"Decision " + std::to_string(_count + 1) + " picks item " + std::to_string(index) + " of "
+				+ std::to_string(count) + "; the log was recorded for another scenario");
+		}
+		++_count;
+		return index;
+	}
+
+	void DecisionReplayer::finish() const
+	{
+		if (!_reader.atEnd())
+		{
+			throw std::runtime_error(
+				"Battle ended after " + std::to_string(_count)
+				+ " choices, before the end of the decision log; it was recorded for another scenario");
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../Core/Random.hpp"
+#include "../IO/System/MappedFile.hpp"
+#include "../IO/System/Varint.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace sw::app
+{
+	// Decision logs (.swd) hold the index every Random::getItem call of a battle picked, in call order, so the
+	// battle replays from its scenario without the seed (or the generator) that produced it:
+	//     "SWDEC001", one varint per choice
+
+	/// @brief Choice tape that draws from the generator and records each choice.
+	class DecisionRecorder final : public core::IChoiceTape
+	{
+	private:
+		std::ofstream _stream;
+		std::string _path;
+		std::vector<std::byte> _buffer;
+		uint64_t _count{};
+		bool _finished{false};
+
+		void writeBuffer();
+
+	public:
+		explicit DecisionRecorder(const std::string& path);
+		~DecisionRecorder() override;
+
+		DecisionRecorder(const DecisionRecorder&) = delete;
+		DecisionRecorder& operator=(const DecisionRecorder&) = delete;
+
+		uint64_t choose(uint64_t count, core::Random& random) override;
+
+		// Writes the buffered choices; throws std::runtime_error if the file could not be written
+		void finish();
+
+		[[nodiscard]]
+		uint64_t getCount() const noexcept
+		{
+			return _count;
+		}
+	};
+
+	/// @brief Choice tape that plays a decision log back instead of drawing.
+	class DecisionReplayer final : public core::IChoiceTape
+	{
+	private:
+		io::MappedFile _file;
+		io::VarintReader _reader;
+		uint64_t _count{};
+
+	public:
+		// Throws std::runtime_error if the file is not a decision log
+		explicit DecisionReplayer(const std::string& path);
+
+		// Throws std::runtime_error once the log is exhausted or when a choice does not fit (another scenario)
+		uint64_t choose(uint64_t count, core::Random& random) override;
+
+		// Throws std::runtime_error if the battle ended before using every choice (another scenario)
+		void finish() const;
+
+		[[nodiscard]]
+		uint64_t getCount() const noexcept
+		{
+			return _count;
+		}
+	};
+}
@@ -0,0 +1,42 @@
+#include "EventStats.hpp"
+
+#include "../IO/Events/MapCreated.hpp"
+#include "../IO/Events/MarchEnded.hpp"
+#include "../IO/Events/MarchStarted.hpp"
+#include "../IO/Events/UnitAttacked.hpp"
+#include "../IO/Events/UnitDied.hpp"
+#include "../IO/Events/UnitMoved.hpp"
+#include "../IO/Events/UnitSpawned.hpp"
+
+#include <ostream>
+
+namespace sw::app
+{
+	void EventStats::onEvents(std::span<const core::GameEvent> events)
+	{
+		for (const auto& event : events)
+		{
+			++_counts[static_cast<size_t>(event.kind)];
+			_damage += event.damage;
+		}
+	}
+
+	void EventStats::write(std::ostream& out) const
+	{
+		// Same order as core::EventKind
+		constexpr std::array<const char*, core::EventKindCount> names{
+			io::MapCreated::Name,
+			io::UnitSpawned::Name,
+			io::MarchStarted::Name,
+			io::UnitAttacked::Name,
+			io::UnitMoved::Name,
+			io::UnitDied::Name,
+			io::MarchEnded::Name,
+		};
+		for (size_t kind = 0; kind < core::EventKindCount; ++kind)
+		{
+			out << names[kind] << '=' << _counts[kind] << ' ';
+		}
+		out << "damage=" << _damage << '\n';
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../Core/EventBus.hpp"
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+
+namespace sw::app
+{
+	/// @brief Batch sink counting events per kind and the damage dealt, for `--stats`.
+	class EventStats final : public core::IEventBatchSink
+	{
+	private:
+		std::array<uint64_t, core::EventKindCount> _counts{};
+		uint64_t _damage{};
+
+	public:
+		void onEvents(std::span<const core::GameEvent> events) override;
+
+		[[nodiscard]]
+		uint64_t count(core::EventKind kind) const noexcept
+		{
+			return _counts[static_cast<size_t>(kind)];
+		}
+
+		[[nodiscard]]
+		uint64_t getDamage() const noexcept
+		{
+			return _damage;
+		}
+
+		// "MAP_CREATED=N UNIT_SPAWNED=N ... MARCH_ENDED=N damage=N"
+		void write(std::ostream& out) const;
+	};
+}
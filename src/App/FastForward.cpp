@@ -0,0 +1,211 @@
+#include "FastForward.hpp"
+
+#include "../Features/Components.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace sw::app
+{
+	namespace
+	{
+		using core::Position;
+
+		uint64_t chebyshev(Position a, Position b)
+		{
+			const uint64_t dx = a.x > b.x ? a.x - b.x : b.x - a.x;
+			const uint64_t dy = a.y > b.y ? a.y - b.y : b.y - a.y;
+			return std::max(dx, dy);
+		}
+
+		// One straight (greedy) step per tick: each axis closes by one until it matches
+		Position positionAfter(Position from, Position target, uint64_t steps)
+		{
+			auto advance = [steps](uint32_t from, uint32_t to)
+			{
+				const uint64_t gap = from > to ? from - to : to - from;
+				const auto moved = static_cast<uint32_t>(std::min(gap, steps));
+				return from > to ? from - moved : from + moved;
+			};
+			return Position{advance(from.x, target.x), advance(from.y, target.y)};
+		}
+
+		// Cells within which a unit can affect another: melee reach is 1, shooters reach their range
+		uint32_t reachOf(const core::Unit& unit)
+		{
+			const auto* range = unit.getComponent<features::RangeComponent>();
+			return range ? std::max<uint32_t>(range->value, 1) : 1;
+		}
+
+		struct Marcher
+		{
+			core::UnitId id;
+			Position from;
+			Position target;
+			uint64_t remaining;
+		};
+
+		std::vector<Marcher> collectMarchers(const core::GameWorld& world)
+		{
+			std::vector<Marcher> marchers;
+			world.forEachUnit(
+				[&](const core::Unit& unit)
+				{
+					if (const auto* march = unit.getComponent<features::MarchComponent>())
+					{
+						const Position pos = world.getUnitPosition(unit.getId());
+						marchers.push_back({unit.getId(), pos, march->target, chebyshev(pos, march->target)});
+					}
+				});
+			return marchers;
+		}
+	}
+
+	uint64_t planQuietTicks(const core::GameWorld& world, uint64_t limit)
+	{
+		// The loop ends after any tick with a single unit left; let it run normally
+		if (world.getUnitCount() <= 1)
+		{
+			return 0;
+		}
+
+		uint32_t reach = 1;
+		bool plannable = true;
+		world.forEachUnit(
+			[&](const core::Unit& unit)
+			{
+				reach = std::max(reach, reachOf(unit));
+				const auto* march = unit.getComponent<features::MarchComponent>();
+				// Detours follow the flow field, and a march onto the current cell ends without a move
+				if (march && (march->detoured || world.getUnitPosition(unit.getId()) == march->target))
+				{
+					plannable = false;
+				}
+			});
+
+		const auto marchers = collectMarchers(world);
+		if (!plannable || marchers.empty())
+		{
+			return 0;
+		}
+
+		// Every tick of the window must still move someone, or the loop would have ended
+		uint64_t window = limit;
+		uint64_t longest = 0;
+		for (const auto& marcher : marchers)
+		{
+			longest = std::max(longest, marcher.remaining);
+		}
+		window = std::min(window, longest);
+
+		// Straight paths must stay clear of terrain
+		for (const auto& marcher : marchers)
+		{
+			const uint64_t steps = std::min(window, marcher.remaining);
+			for (uint64_t step = 1; step <= steps; ++step)
+			{
+				if (world.isTerrain(positionAfter(marcher.from, marcher.target, step)))
+				{
+					window = std::min(window, step - 1);
+					break;
+				}
+			}
+		}
+
+		// Spacing: nobody may be within reach now (or sharing a cell), and a marcher's neighbourhood must stay empty
+		// while both it and any neighbour close in by one cell per tick.
+		auto isolated = [&](Position pos, uint64_t radius)
+		{
+			return !world.anyCellInRange(core::CellLayer::Occupied, pos, 1, static_cast<uint32_t>(radius));
+		};
+
+		bool contested = false;
+		world.forEachUnit(
+			[&](const core::Unit& unit)
+			{
+				const Position pos = world.getUnitPosition(unit.getId());
+				if (contested || world.countUnitsInRange(core::CellLayer::Occupied, pos, 0, 0) > 1
+					|| !isolated(pos, reach))
+				{
+					contested = true;
+				}
+			});
+		if (contested)
+		{
+			return 0;
+		}
+
+		for (const auto& marcher : marchers)
+		{
+			if (window == 0)
+			{
+				break;
+			}
+			if (isolated(marcher.from, reach + 2 * window))
+			{
+				continue;
+			}
+
+			// Largest window this marcher allows; isolation shrinks monotonically with the radius
+			uint64_t low = 0;
+			uint64_t high = window;
+			while (low < high)
+			{
+				const uint64_t mid = (low + high + 1) / 2;
+				if (isolated(marcher.from, reach + 2 * mid))
+				{
+					low = mid;
+				}
+				else
+				{
+					high = mid - 1;
+				}
+			}
+			window = low;
+		}
+
+		return window;
+	}
+
+	void advanceQuietTicks(
+		core::GameWorld& world, core::IGameEvents& events, uint64_t& tick, uint64_t ticks, bool emitEvents)
+	{
+		const auto marchers = collectMarchers(world);
+
+		if (emitEvents)
+		{
+			for (uint64_t step = 1; step <= ticks; ++step, ++tick)
+			{
+				for (const auto& marcher : marchers)
+				{
+					if (step > marcher.remaining)
+					{
+						continue;
+					}
+
+					const Position from = positionAfter(marcher.from, marcher.target, step - 1);
+					const Position to = positionAfter(marcher.from, marcher.target, step);
+					events.onUnitMoved(marcher.id, from, to);
+					if (step == marcher.remaining)
+					{
+						events.onMarchEnded(marcher.id, marcher.target);
+					}
+				}
+			}
+		}
+		else
+		{
+			tick += ticks;
+		}
+
+		for (const auto& marcher : marchers)
+		{
+			world.moveUnit(marcher.id, positionAfter(marcher.from, marcher.target, ticks));
+			if (ticks >= marcher.remaining)
+			{
+				world.getUnitById(marcher.id).removeComponent<features::MarchComponent>();
+				world.syncUnitState(marcher.id);
+			}
+		}
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "../Core/GameWorld.hpp"
+#include "../Core/IGameEvents.hpp"
+
+#include <cstdint>
+
+namespace sw::app
+{
+	// Number of upcoming ticks (at most `limit`) in which every marching unit is guaranteed to take its straight step
+	// and no unit can attack or block another. Units interact only within their reach (1 for melee, RangeComponent
+	// for shooters), so the window follows from march vectors and the spacing between units: each tick closes the
+	// gap between two marchers by at most two cells. Returns 0 when the next tick has to run normally.
+	uint64_t planQuietTicks(const core::GameWorld& world, uint64_t limit);
+
+	// Plays `ticks` quiet ticks analytically, starting at `tick` (advanced in place): marchers move straight toward
+	// their targets and finish their marches exactly as MoveBehavior would. With `emitEvents` the per-tick
+	// UNIT_MOVED / MARCH_ENDED events are reproduced in turn order; otherwise only the final state is applied.
+	void advanceQuietTicks(
+		core::GameWorld& world, core::IGameEvents& events, uint64_t& tick, uint64_t ticks, bool emitEvents);
+}
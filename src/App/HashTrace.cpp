@@ -0,0 +1,99 @@
+#include "HashTrace.hpp"
+
+#include <charconv>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace sw::app
+{
+	namespace
+	{
+		struct HashLine
+		{
+			uint64_t tick{};
+			uint64_t hash{};
+		};
+
+		std::optional<HashLine> readHashLine(std::istream& stream)
+		{
+			std::string line;
+			while (std::getline(stream, line))
+			{
+				if (line.empty())
+				{
+					continue;
+				}
+
+				HashLine parsed;
+				const char* end = line.data() + line.size();
+				auto [tickEnd, tickError] = std::from_chars(line.data(), end, parsed.tick);
+				if (tickError != std::errc{} || tickEnd == end || *tickEnd != ' ')
+				{
+					throw std::runtime_error("Malformed hash trace line: " + line);
+				}
+
+				auto [hashEnd, hashError] = std::from_chars(tickEnd + 1, end, parsed.hash, 16);
+				if (hashError != std::errc{} || hashEnd != end)
+				{
+					throw std::runtime_error("Malformed hash trace line: " + line);
+				}
+				return parsed;
+			}
+			return std::nullopt;
+		}
+	}
+
+	void writeHashLine(std::ostream& stream, uint64_t tick, uint64_t hash)
+	{
+		constexpr char Digits[] = "0123456789abcdef";
+		char buffer[40];
+		char* end = std::to_chars(buffer, buffer + 20, tick).ptr;
+		*end++ = ' ';
+		// Fixed width, so traces also diff cleanly as text
+		for (int i = 15; i >= 0; --i, hash >>= 4)
+		{
+			end[i] = Digits[hash & 0xf];
+		}
+		end += 16;
+		*end++ = '\n';
+		stream.write(buffer, end - buffer);
+	}
+
+	std::optional<HashDivergence> findFirstDivergence(std::istream& expected, std::istream& actual)
+	{
+		auto left = readHashLine(expected);
+		auto right = readHashLine(actual);
+		while (left && right)
+		{
+			if (left->tick == right->tick)
+			{
+				if (left->hash != right->hash)
+				{
+					return HashDivergence{left->tick, left->hash, right->hash};
+				}
+				left = readHashLine(expected);
+				right = readHashLine(actual);
+			}
+			else if (left->tick < right->tick)
+			{
+				left = readHashLine(expected);
+			}
+			else
+			{
+				right = readHashLine(actual);
+			}
+		}
+
+		if (left)
+		{
+			return HashDivergence{left->tick, left->hash, std::nullopt};
+		}
+		if (right)
+		{
+			return HashDivergence{right->tick, std::nullopt, right->hash};
+		}
+		return std::nullopt;
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+
+namespace sw::app
+{
+	// Hash traces hold one line per tick, "<tick> <world hash as 16 hex digits>", in increasing tick order.
+	void writeHashLine(std::ostream& stream, uint64_t tick, uint64_t hash);
+
+	struct HashDivergence
+	{
+		uint64_t tick{};
+		// Empty when the run has no hash for this tick because it ended earlier
+		std::optional<uint64_t> expected;
+		std::optional<uint64_t> actual;
+	};
+
+	// Streams both traces and returns the first tick whose hashes differ, or at which one run has ended while the
+	// other continues. Ticks present in only one trace mid-run (fast-forward windows) are skipped.
+	// Throws std::runtime_error on malformed lines.
+	std::optional<HashDivergence> findFirstDivergence(std::istream& expected, std::istream& actual);
+}
@@ -0,0 +1,217 @@
+#include "Options.hpp"
+
+#include <charconv>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+
+namespace sw::app
+{
+	namespace
+	{
+		uint64_t parseNumber(std::string_view option, std::string_view text)
+		{
+			uint64_t value{};
+			const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+			if (error != std::errc{} || end != text.data() + text.size())
+			{
+				throw std::invalid_argument("Invalid value for " + std::string(option) + ": " + std::string(text));
+			}
+			return value;
+		}
+
+		core::GridLayout parseGridLayout(std::string_view text)
+		{
+			if (text == "row-major")
+			{
+				return core::GridLayout::RowMajor;
+			}
+			if (text == "tiled")
+			{
+				return core::GridLayout::Tiled;
+			}
+			throw std::invalid_argument("Invalid value for --grid-layout: " + std::string(text));
+		}
+	}
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg(argv[i]);
+			auto value = [&]() -> std::string_view
+			{
+				if (i + 1 >= argc)
+				{
+					throw std::invalid_argument("Missing value for " + std::string(arg));
+				}
+				return argv[++i];
+			};
+
+			if (arg == "--fast-forward")
+			{
+				options.fastForward = true;
+			}
+			else if (arg == "--fast-forward=silent")
+			{
+				options.fastForward = true;
+				options.fastForwardSilent = true;
+			}
+			else if (arg == "--hash-trace")
+			{
+				options.hashTrace = true;
+			}
+			else if (arg == "--quiet")
+			{
+				options.quiet = true;
+			}
+			else if (arg == "--stats")
+			{
+				options.stats = true;
+			}
+			else if (arg == "--archive")
+			{
+				options.archivePath = value();
+			}
+			else if (arg == "--record-decisions")
+			{
+				options.recordDecisionsPath = value();
+			}
+			else if (arg == "--replay-decisions")
+			{
+				options.replayDecisionsPath = value();
+			}
+			else if (arg == "--log-from")
+			{
+				options.logFromTick = parseNumber(arg, value());
+			}
+			else if (arg == "--checkpoint-every")
+			{
+				options.checkpointEvery = parseNumber(arg, value());
+			}
+			else if (arg == "--checkpoint-file")
+			{
+				options.checkpointPath = value();
+			}
+			else if (arg == "--resume")
+			{
+				options.resumePath = value();
+			}
+			else if (arg == "--seed")
+			{
+				options.seed = parseNumber(arg, value());
+			}
+			else if (arg == "--grid-layout")
+			{
+				options.gridLayout = parseGridLayout(value());
+			}
+			else if (arg == "--parse-threads")
+			{
+				options.parseThreads = static_cast<size_t>(parseNumber(arg, value()));
+			}
+			else if (arg == "--scenario-cache")
+			{
+				options.scenarioCacheDirectory = value();
+			}
+			else if (arg == "--serve")
+			{
+				options.serve = true;
+			}
+			else if (arg == "--serve-socket")
+			{
+				options.serveSocketPath = value();
+			}
+			else if (arg == "--workers")
+			{
+				options.workers = static_cast<size_t>(parseNumber(arg, value()));
+			}
+			else if (arg.starts_with("--"))
+			{
+				throw std::invalid_argument("Unknown option: " + std::string(arg));
+			}
+			else if (options.scenarioPath.empty())
+			{
+				options.scenarioPath = arg;
+			}
+			else
+			{
+				throw std::invalid_argument("Unexpected argument: " + std::string(arg));
+			}
+		}
+
+		if (options.serve || !options.serveSocketPath.empty())
+		{
+			if (options.serve && !options.serveSocketPath.empty())
+			{
+				throw std::invalid_argument("--serve and --serve-socket are exclusive");
+			}
+			if (!options.scenarioPath.empty() || !options.resumePath.empty() || options.seed)
+			{
+				throw std::invalid_argument("Server requests carry their own scenario and seed");
+			}
+		}
+		else if (!options.resumePath.empty())
+		{
+			if (!options.scenarioPath.empty())
+			{
+				throw std::invalid_argument("--resume replaces the scenario file");
+			}
+			if (options.seed)
+			{
+				throw std::invalid_argument("--seed cannot be combined with --resume (the checkpoint holds the state)");
+			}
+			if (options.stats || !options.archivePath.empty())
+			{
+				throw std::invalid_argument("--stats and --archive are only available for scenario runs");
+			}
+			if (!options.recordDecisionsPath.empty() || !options.replayDecisionsPath.empty() || options.logFromTick)
+			{
+				throw std::invalid_argument(
+					"--record-decisions, --replay-decisions and --log-from are only available for scenario runs");
+			}
+		}
+		else if (options.scenarioPath.empty())
+		{
+			throw std::invalid_argument("Missing scenario file");
+		}
+
+		if (options.gridLayout && (options.serve || !options.serveSocketPath.empty() || !options.resumePath.empty()))
+		{
+			throw std::invalid_argument("--grid-layout is only available for scenario runs");
+		}
+		// Streamed input may carry tick-tagged commands, which a checkpoint cannot hold (tagged files are
+		// rejected by app::ScenarioRunner once their first tag is read)
+		if (options.checkpointEvery > 0 && !options.scenarioPath.empty()
+			&& (options.scenarioPath == "-"
+				|| (std::filesystem::exists(options.scenarioPath)
+					&& !std::filesystem::is_regular_file(options.scenarioPath))))
+		{
+			throw std::invalid_argument("--checkpoint-every needs a scenario file, not streamed input");
+		}
+		if (!options.recordDecisionsPath.empty() && !options.replayDecisionsPath.empty())
+		{
+			throw std::invalid_argument("--record-decisions and --replay-decisions are exclusive");
+		}
+		if (options.logFromTick
+			&& (options.hashTrace || options.quiet || options.stats || !options.archivePath.empty()))
+		{
+			throw std::invalid_argument("--log-from only applies to the event log");
+		}
+		return options;
+	}
+
+	std::string usage(const char* program)
+	{
+		return std::string("Usage: ") + program
+			   + " [--fast-forward[=silent]]"
+				 " [--hash-trace] [--quiet] [--stats] [--archive PATH]"
+				 " [--record-decisions PATH | --replay-decisions PATH]"
+				 " [--log-from TICK] [--seed N]"
+				 " [--grid-layout row-major|tiled] [--parse-threads N] [--scenario-cache DIR]"
+				 " [--checkpoint-every N] [--checkpoint-file PATH]"
+				 " (<scenario_file> | - | --resume <snapshot>)\n"
+				 "       "
+			   + program + " (--serve | --serve-socket PATH) [--workers N]";
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../Core/GridLayout.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace sw::app
+{
+	struct Options
+	{
+		// "-" reads the scenario from stdin
+		std::string scenarioPath;
+
+		// Advance uncontested marches in bulk (see FastForward.hpp)
+		bool fastForward{false};
+		// Fast-forwarded ticks apply their moves without logging them
+		bool fastForwardSilent{false};
+
+		// Save the world every N played ticks (0 disables checkpoints); not for streamed or tick-tagged scenarios
+		uint64_t checkpointEvery{0};
+		std::string checkpointPath{"checkpoint.bin"};
+		// Continue from a checkpoint instead of running a scenario
+		std::string resumePath;
+		// Random seed for a new battle; drawn from std::random_device when absent
+		std::optional<uint64_t> seed;
+		// Cell storage order of the scenario's map (a checkpoint keeps the layout it was saved with)
+		std::optional<core::GridLayout> gridLayout;
+		// Threads decoding a large scenario file's setup (0: one per hardware thread)
+		size_t parseThreads{0};
+		// Keep compiled scenarios here and play them instead of reparsing unchanged text (see CompiledScenario.hpp)
+		std::string scenarioCacheDirectory;
+		// Print one world hash per tick (see HashTrace.hpp) instead of the event log
+		bool hashTrace{false};
+		// Headless run: no event log, only the final summary
+		bool quiet{false};
+		// Print event counts to stderr after a scenario run (see EventStats.hpp)
+		bool stats{false};
+		// Also write every event of a scenario run to this event archive (see IO/System/EventArchive.hpp)
+		std::string archivePath;
+		// Record the battle's random choices to this decision log, or replay them from one (see DecisionLog.hpp)
+		std::string recordDecisionsPath;
+		std::string replayDecisionsPath;
+		// Play headless before this tick, then log events (0 logs everything)
+		uint64_t logFromTick{0};
+
+		// Play framed requests from stdin, or from connections to a Unix domain socket (see Server.hpp)
+		bool serve{false};
+		std::string serveSocketPath;
+		// Server worker threads (0: one per hardware thread)
+		size_t workers{0};
+	};
+
+	// Parses `sw_battle_test [options] <scenario_file>`, `sw_battle_test [options] --resume <snapshot>` or
+	// `sw_battle_test (--serve | --serve-socket PATH) [--workers N]`; throws std::invalid_argument on bad usage.
+	Options parseOptions(int argc, char** argv);
+
+	std::string usage(const char* program);
+}
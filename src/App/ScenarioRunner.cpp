@@ -0,0 +1,671 @@
+#include "ScenarioRunner.hpp"
+
+#include "../Core/EventBus.hpp"
+#include "../Core/NullEvents.hpp"
+#include "../Features/Behaviors/Utils.hpp"
+#include "../Features/Components.hpp"
+#include "../Features/Hunter.hpp"
+#include "../Features/Swordsman.hpp"
+#include "../IO/System/EventLog.hpp"
+#include "../IO/System/GameLogger.hpp"
+#include "../IO/System/TerrainFile.hpp"
+#include "HashTrace.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+namespace sw::app
+{
+	using namespace sw::core;
+	using namespace sw::features;
+
+	namespace
+	{
+		// Smaller setups are parsed on the calling thread
+		constexpr size_t ParallelParseThreshold = size_t{8} << 20;
+
+		// A command failure surfaces as a parse error even when it happens mid-battle
+		class CommandError : public std::runtime_error
+		{
+		public:
+			explicit CommandError(const std::string& message) :
+					std::runtime_error("Error parsing commands: " + message)
+			{}
+
+			CommandError(const char* unit, uint64_t position, const std::string& message) :
+					CommandError(std::string(unit) + " " + std::to_string(position) + ": " + message)
+			{}
+		};
+
+		struct TaggedLine
+		{
+			uint64_t tick{};
+			// Empty for a bare tick announcement
+			std::string_view command;
+		};
+
+		// Read-only istream source over text in memory
+		class TextBuffer : public std::streambuf
+		{
+		public:
+			explicit TextBuffer(std::string_view text)
+			{
+				char* begin = const_cast<char*>(text.data());
+				setg(begin, begin, begin + text.size());
+			}
+
+			void skip(size_t count)
+			{
+				setg(eback(), gptr() + count, egptr());
+			}
+		};
+
+		// "@<tick> <command>"; std::nullopt for untagged lines
+		std::optional<TaggedLine> parseTag(std::string_view line)
+		{
+			if (!line.starts_with('@'))
+			{
+				return std::nullopt;
+			}
+
+			TaggedLine tagged;
+			const char* end = line.data() + line.size();
+			const auto [rest, error] = std::from_chars(line.data() + 1, end, tagged.tick);
+			if (error != std::errc{} || (rest != end && *rest != ' ' && *rest != '\t' && *rest != '\r'))
+			{
+				throw std::runtime_error("Invalid tick tag: " + std::string(line));
+			}
+			tagged.command = std::string_view(rest, end);
+			return tagged;
+		}
+
+		void startMarch(GameWorld& map, IGameEvents& events, UnitId unitId, Position target)
+		{
+			auto& unit = map.getUnitById(unitId);
+			unit.addComponent<MarchComponent>(target);
+			map.syncUnitState(unitId);
+			events.onMarchStarted(unitId, map.getUnitPosition(unitId), target);
+		}
+
+		// Spawns a formation command's block in one batch. Every cell and ID is checked first, so a rejected
+		// formation leaves the world unchanged.
+		template <class TFormation, class TMakeUnit>
+		void spawnFormation(
+			GameWorld& map,
+			IGameEvents& events,
+			const TFormation& command,
+			std::string_view unitType,
+			TMakeUnit makeUnit)
+		{
+			if (command.columns == 0 || command.rows == 0 || command.stride == 0)
+			{
+				throw std::runtime_error("Formation size and stride must be positive");
+			}
+			const uint64_t count = uint64_t{command.columns} * command.rows;
+			if (command.firstId + count - 1 > std::numeric_limits<UnitId>::max())
+			{
+				throw std::out_of_range("Formation unit IDs are out of range");
+			}
+			if (command.x + uint64_t{command.columns - 1} * command.stride >= map.getWidth()
+				|| command.y + uint64_t{command.rows - 1} * command.stride >= map.getHeight())
+			{
+				throw std::out_of_range("Formation is out of map bounds");
+			}
+
+			auto forEachSlot = [&](auto&& visitor)
+			{
+				UnitId id = command.firstId;
+				for (uint32_t row = 0; row < command.rows; ++row)
+				{
+					for (uint32_t column = 0; column < command.columns; ++column)
+					{
+						visitor(id++, Position{command.x + column * command.stride, command.y + row * command.stride});
+					}
+				}
+			};
+			forEachSlot(
+				[&](UnitId id, Position pos)
+				{
+					if (utils::isCellBlocked(map, pos))
+					{
+						throw std::runtime_error("Spawn position blocked");
+					}
+					if (map.hasUnit(id))
+					{
+						throw std::runtime_error("Unit ID already exists");
+					}
+				});
+
+			map.reserveUnits(static_cast<size_t>(count));
+			forEachSlot(
+				[&](UnitId id, Position pos)
+				{
+					map.addUnit(makeUnit(id), pos);
+					events.onUnitSpawned(id, unitType, pos);
+				});
+		}
+	}
+
+	void ScenarioRunner::readLine(std::string_view line, Item& item)
+	{
+		const auto tag = parseTag(line);
+		item.tick = tag ? std::optional(tag->tick) : std::nullopt;
+		item.error.clear();
+		if (!tag)
+		{
+			item.command = Parser::decode(line);
+			return;
+		}
+		try
+		{
+			item.command = Parser::decode(tag->command);
+		}
+		catch (const std::exception& e)
+		{
+			item.command.reset();
+			item.error = e.what();
+		}
+	}
+
+	ScenarioRunner::ScenarioRunner()
+	{
+		_parser
+			.add<io::CreateMap>(
+				[this](auto command)
+				{
+					if (_started)
+					{
+						throw std::runtime_error("CREATE_MAP is only allowed before the battle starts");
+					}
+					_map = std::make_unique<GameWorld>(command.width, command.height, _options->gridLayout);
+					_map->getRandom().reseed(_options->seed);
+					_map->getRandom().setChoiceTape(_options->choices);
+					_events->onMapCreated(command.width, command.height);
+				})
+			.add<io::Terrain>(
+				[this](auto command)
+				{
+					requireMap().addTerrainRect(Position{command.x1, command.y1}, Position{command.x2, command.y2});
+				})
+			.add<io::LoadTerrain>(
+				[this](auto command)
+				{
+					auto& map = requireMap();
+					std::filesystem::path path(command.path);
+					if (path.is_relative())
+					{
+						path = _options->baseDirectory / path;
+					}
+					map.setTerrain(io::loadTerrain(path.string()));
+				})
+			.add<io::SpawnSwordsman>(
+				[this](auto command)
+				{
+					auto& map = requireMap();
+					Position pos{command.x, command.y};
+					if (utils::isCellBlocked(map, pos))
+					{
+						throw std::runtime_error("Spawn position blocked");
+					}
+
+					map.addUnit(makeSwordsman(command.unitId, command.hp, command.strength), pos);
+					_events->onUnitSpawned(command.unitId, "Swordsman", pos);
+				})
+			.add<io::SpawnHunter>(
+				[this](auto command)
+				{
+					auto& map = requireMap();
+					Position pos{command.x, command.y};
+					if (utils::isCellBlocked(map, pos))
+					{
+						throw std::runtime_error("Spawn position blocked");
+					}
+
+					map.addUnit(
+						makeHunter(command.unitId, command.hp, command.agility, command.strength, command.range), pos);
+					_events->onUnitSpawned(command.unitId, "Hunter", pos);
+				})
+			.add<io::March>(
+				[this](auto command)
+				{
+					auto& map = requireMap();
+					if (command.targetX >= map.getWidth() || command.targetY >= map.getHeight())
+					{
+						throw std::out_of_range("March target is out of map bounds");
+					}
+
+					startMarch(map, *_events, command.unitId, Position{command.targetX, command.targetY});
+				})
+			.add<io::SpawnSwordsmanFormation>(
+				[this](auto command)
+				{
+					spawnFormation(
+						requireMap(),
+						*_events,
+						command,
+						"Swordsman",
+						[&](UnitId id) { return makeSwordsman(id, command.hp, command.strength); });
+				})
+			.add<io::SpawnHunterFormation>(
+				[this](auto command)
+				{
+					spawnFormation(
+						requireMap(),
+						*_events,
+						command,
+						"Hunter",
+						[&](UnitId id)
+						{ return makeHunter(id, command.hp, command.agility, command.strength, command.range); });
+				})
+			.add<io::MarchRange>(
+				[this](auto command)
+				{
+					auto& map = requireMap();
+					if (command.targetX >= map.getWidth() || command.targetY >= map.getHeight())
+					{
+						throw std::out_of_range("March target is out of map bounds");
+					}
+					if (command.firstId > command.lastId)
+					{
+						throw std::runtime_error("MARCH_RANGE needs firstId <= lastId");
+					}
+					// Every unit must exist before any of them starts marching
+					for (uint64_t id = command.firstId; id <= command.lastId; ++id)
+					{
+						if (!map.hasUnit(static_cast<UnitId>(id)))
+						{
+							throw std::runtime_error("Unknown unit: " + std::to_string(id));
+						}
+					}
+					for (uint64_t id = command.firstId; id <= command.lastId; ++id)
+					{
+						startMarch(map, *_events, static_cast<UnitId>(id), Position{command.targetX, command.targetY});
+					}
+				});
+	}
+
+	GameWorld& ScenarioRunner::requireMap()
+	{
+		if (!_map)
+		{
+			throw std::runtime_error("Map not created");
+		}
+		return *_map;
+	}
+
+	void ScenarioRunner::run(std::istream& scenario, const ScenarioOptions& options, std::ostream& out)
+	{
+		uint64_t lineNumber = 0;
+		std::string line;
+		auto source = [&](Item& item)
+		{
+			if (!std::getline(scenario, line))
+			{
+				return false;
+			}
+			item.position = ++lineNumber;
+			readLine(line, item);
+			return true;
+		};
+		play(source, "line", options, out, [] {});
+	}
+
+	void ScenarioRunner::run(std::string_view scenario, const ScenarioOptions& options, std::ostream& out)
+	{
+		TextBuffer buffer(scenario);
+		std::istream stream(&buffer);
+		uint64_t lineNumber = 0;
+		std::string line;
+		auto source = [&](Item& item)
+		{
+			if (!std::getline(stream, line))
+			{
+				return false;
+			}
+			item.position = ++lineNumber;
+			readLine(line, item);
+			return true;
+		};
+		auto preload = [&]
+		{
+			const size_t threads = options.parseThreads ? options.parseThreads : std::thread::hardware_concurrency();
+			if (scenario.size() < ParallelParseThreshold || threads <= 1)
+			{
+				return;
+			}
+			// Tagged lines end the setup; play() reads them (and the rest) line by line
+			const auto parsed =
+				_parser.parseParallel(scenario, threads, [](std::string_view text) { return text.starts_with('@'); });
+			buffer.skip(parsed.offset);
+			lineNumber = parsed.lines;
+		};
+		play(source, "line", options, out, preload);
+	}
+
+	void ScenarioRunner::runCompiled(
+		std::span<const std::byte> scenario, const ScenarioOptions& options, std::ostream& out)
+	{
+		SnapshotReader reader(scenario);
+		std::vector<size_t> commands;
+		try
+		{
+			// Map the recorded names onto the parser, so the command list may be reordered between builds
+			const auto names = Parser::getCommandNames();
+			for (const auto& name : readScenarioHeader(reader).commands)
+			{
+				const auto known = std::find(names.begin(), names.end(), name);
+				if (known == names.end())
+				{
+					throw std::runtime_error("Compiled scenario uses an unknown command: " + name);
+				}
+				commands.push_back(static_cast<size_t>(known - names.begin()));
+			}
+		}
+		catch (const std::exception& e)
+		{
+			throw CommandError(e.what());
+		}
+
+		uint64_t record = 0;
+		std::optional<uint64_t> tick;
+		auto source = [&](Item& item)
+		{
+			if (reader.remaining() == 0)
+			{
+				return false;
+			}
+			item.position = ++record;
+			const auto index = reader.read<uint8_t>();
+			if (index == compiled::TickRecord)
+			{
+				tick = reader.read<uint64_t>();
+				item.tick = tick;
+				item.command.reset();
+				return true;
+			}
+			if (index >= commands.size())
+			{
+				throw std::runtime_error("Invalid command index: " + std::to_string(index));
+			}
+			item.tick = tick;
+			item.command = Parser::readFields(commands[index], reader);
+			return true;
+		};
+		play(source, "record", options, out, [] {});
+	}
+
+	std::vector<std::byte> ScenarioRunner::compile(std::string_view text, const ScenarioSource& source)
+	{
+		std::vector<std::byte> bytes;
+		bytes.reserve(text.size() / 2);
+		SnapshotWriter writer(bytes);
+		writeScenarioHeader(writer, source, Parser::getCommandNames());
+
+		std::optional<uint64_t> tick;
+		uint64_t lineNumber = 0;
+		while (!text.empty())
+		{
+			const size_t end = std::min(text.find('\n'), text.size());
+			const auto line = text.substr(0, end);
+			text.remove_prefix(std::min(end + 1, text.size()));
+			++lineNumber;
+
+			try
+			{
+				const auto tag = parseTag(line);
+				if (tag && tag->tick != tick)
+				{
+					tick = tag->tick;
+					writer.write(compiled::TickRecord);
+					writer.write(*tick);
+				}
+				if (const auto command = Parser::decode(tag ? tag->command : line))
+				{
+					if (tick && !tag)
+					{
+						throw std::runtime_error("Commands after the setup must be tagged with a tick");
+					}
+					writer.write(static_cast<uint8_t>(command->index()));
+					Parser::writeFields(*command, writer);
+				}
+			}
+			catch (const std::exception& e)
+			{
+				throw std::runtime_error("line " + std::to_string(lineNumber) + ": " + e.what());
+			}
+		}
+		return bytes;
+	}
+
+	void ScenarioRunner::play(
+		FunctionRef<bool(Item&)> source,
+		const char* unit,
+		const ScenarioOptions& options,
+		std::ostream& out,
+		FunctionRef<void()> preload)
+	{
+		uint64_t tick = 1;
+		EventLog log(out);
+		io::GameLogger logger(log, tick);
+		// Hash traces and quiet runs replace the event log
+		NullEvents nullEvents;
+		const bool headless = options.hashTrace || options.quiet;
+		const bool deferLog = options.logFromTick > tick;
+		if (deferLog && (headless || options.subscribe))
+		{
+			throw std::invalid_argument("Logging from a later tick is only available for plain event logs");
+		}
+		_events = headless ? static_cast<IGameEvents*>(&nullEvents) : &logger;
+		// Extra sinks share the events through a bus; plain runs keep calling the log directly. Deferred logs
+		// start with an empty bus and subscribe the log once the battle reaches logFromTick.
+		EventBus bus;
+		if (deferLog)
+		{
+			_events = &bus;
+		}
+		if (options.subscribe)
+		{
+			if (!headless)
+			{
+				bus.subscribe(logger);
+			}
+			options.subscribe(bus, tick);
+			_events = &bus;
+		}
+		_options = &options;
+		_map.reset();
+		_started = false;
+
+		// --- Parse Setup ---
+
+		try
+		{
+			preload();
+		}
+		catch (const std::exception& e)
+		{
+			throw CommandError(e.what());
+		}
+
+		Item item;
+		auto read = [&]
+		{
+			try
+			{
+				return source(item);
+			}
+			catch (const std::exception& e)
+			{
+				throw CommandError(unit, item.position, e.what());
+			}
+		};
+
+		// First tagged item not applied yet
+		std::optional<Item> next;
+		try
+		{
+			while (read())
+			{
+				if (item.tick)
+				{
+					next = std::move(item);
+					break;
+				}
+				if (item.command)
+				{
+					_parser.apply(std::move(*item.command));
+				}
+			}
+		}
+		catch (const CommandError&)
+		{
+			throw;
+		}
+		catch (const std::exception& e)
+		{
+			throw CommandError(unit, item.position, e.what());
+		}
+
+		if (!_map)
+		{
+			throw std::runtime_error("Map was not created!");
+		}
+		// A checkpoint holds only the world, so a run resumed from it would miss the commands still to come
+		if (next && options.simulation.checkpointEvery > 0 && options.simulation.onCheckpoint)
+		{
+			throw CommandError(unit, next->position, "Checkpoints cannot be combined with tick-tagged commands");
+		}
+
+		if (options.hashTrace)
+		{
+			writeHashLine(out, tick, _map->getStateHash());
+		}
+
+		// Increment tick before simulation starts (Setup was tick 1)
+		tick++;
+		_started = true;
+
+		// --- Simulation Loop ---
+
+		auto applyScheduled = [&](GameWorld&, uint64_t current)
+		{
+			uint64_t position = 0;
+			try
+			{
+				while (next && *next->tick <= current)
+				{
+					position = next->position;
+					if (!next->error.empty())
+					{
+						throw std::runtime_error(next->error);
+					}
+					if (next->command)
+					{
+						_parser.apply(std::move(*next->command));
+					}
+					const uint64_t previous = *next->tick;
+					next.reset();
+					// A live controller may wait for the events so far before it sends more
+					log.flush();
+					while (!next && read())
+					{
+						position = item.position;
+						if (!item.tick)
+						{
+							if (item.command)
+							{
+								throw std::runtime_error("Commands after the setup must be tagged with a tick");
+							}
+							continue;
+						}
+						if (*item.tick < previous)
+						{
+							throw std::runtime_error("Tick tags must not decrease");
+						}
+						next = std::move(item);
+					}
+				}
+			}
+			catch (const CommandError&)
+			{
+				throw;
+			}
+			catch (const std::exception& e)
+			{
+				throw CommandError(unit, position, e.what());
+			}
+			return next ? *next->tick : NoScheduledTick;
+		};
+
+		try
+		{
+			auto simulation = options.simulation;
+			simulation.beforeTick = applyScheduled;
+			// Nothing would see the moves of fast-forwarded ticks
+			simulation.fastForwardSilent = simulation.fastForwardSilent || headless;
+			if (options.hashTrace)
+			{
+				simulation.onTickEnd = [&out](const GameWorld& world, uint64_t playedTick)
+				{ writeHashLine(out, playedTick, world.getStateHash()); };
+			}
+			if (options.subscribe)
+			{
+				// Setup events form the first batch
+				bus.flush();
+				simulation.onTickEnd = [&bus, hashLine = std::move(simulation.onTickEnd)](
+										   const GameWorld& world, uint64_t playedTick)
+				{
+					if (hashLine)
+					{
+						hashLine(world, playedTick);
+					}
+					bus.flush();
+				};
+				runSimulation(*_map, bus, tick, simulation);
+			}
+			else if (headless)
+			{
+				runSimulation(*_map, nullEvents, tick, simulation);
+			}
+			else if (deferLog)
+			{
+				// One run, so checkpoints and fast-forward windows keep their phase across logFromTick
+				bool logged = false;
+				simulation.reachTick = options.logFromTick;
+				simulation.onReachTick = [&](uint64_t)
+				{
+					bus.subscribe(logger);
+					logged = true;
+				};
+				runSimulation(*_map, bus, tick, simulation);
+				if (!logged)
+				{
+					writeBattleSummary(out, *_map, tick);
+				}
+			}
+			else
+			{
+				runSimulation(*_map, logger, tick, simulation);
+			}
+		}
+		catch (const CommandError&)
+		{
+			throw;
+		}
+		catch (const std::exception& e)
+		{
+			throw std::runtime_error(std::string("Simulation error: ") + e.what());
+		}
+		if (options.quiet)
+		{
+			writeBattleSummary(out, *_map, tick);
+		}
+		_map.reset();
+	}
+}
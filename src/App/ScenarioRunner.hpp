@@ -0,0 +1,136 @@
+#pragma once
+
+#include "../Core/EventBus.hpp"
+#include "../Core/FunctionRef.hpp"
+#include "../Core/GameWorld.hpp"
+#include "../Core/IGameEvents.hpp"
+#include "../Core/Random.hpp"
+#include "../IO/Commands/CreateMap.hpp"
+#include "../IO/Commands/LoadTerrain.hpp"
+#include "../IO/Commands/March.hpp"
+#include "../IO/Commands/MarchRange.hpp"
+#include "../IO/Commands/SpawnHunter.hpp"
+#include "../IO/Commands/SpawnHunterFormation.hpp"
+#include "../IO/Commands/SpawnSwordsman.hpp"
+#include "../IO/Commands/SpawnSwordsmanFormation.hpp"
+#include "../IO/Commands/Terrain.hpp"
+#include "../IO/System/CommandParser.hpp"
+#include "CompiledScenario.hpp"
+#include "Simulation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sw::app
+{
+	struct ScenarioOptions
+	{
+		uint64_t seed{core::Random::DefaultSeed};
+		// Cell storage order of the map CREATE_MAP builds; queries and logs do not depend on it
+		core::GridLayout gridLayout{core::GridLayout::RowMajor};
+		// Relative LOAD_TERRAIN paths are resolved against this directory
+		std::filesystem::path baseDirectory;
+		// Print one world hash per tick (see HashTrace.hpp) instead of the event log
+		bool hashTrace{false};
+		// Drop the event log and print only a final summary (see writeBattleSummary)
+		bool quiet{false};
+		// Play headless before this tick and log events from it on (setup is tick 1, so 0 and 1 log everything);
+		// a battle over by then prints only its summary. Not combined with hashTrace, quiet or subscribe.
+		uint64_t logFromTick{0};
+		// Takes over the world's random choices, e.g. to record or replay them (see DecisionLog.hpp)
+		core::IChoiceTape* choices{};
+		// Subscribes extra event sinks (stats, archives, ...) next to the log; they receive every event of the run,
+		// batch sinks once per played tick (see core::EventBus). `tick` is the tick events are reported for.
+		std::function<void(core::EventBus&, const uint64_t& tick)> subscribe;
+		// Threads decoding a large in-memory setup (0: one per hardware thread; 1 parses serially)
+		size_t parseThreads{0};
+		SimulationOptions simulation;
+	};
+
+	/// @brief Parses a scenario and plays the battle to its end: the pipeline behind `sw_battle_test <scenario>`.
+	/// The command parser and its handlers are built once, so one runner can play many scenarios in a row
+	/// (one at a time; give each thread its own runner).
+	/// Scenarios are read as the battle runs. Its untagged prefix is the setup; the first line tagged `@N` starts
+	/// the battle, and from then on every command is tagged with the tick it must be applied before
+	/// (`@N COMMAND`, non-decreasing; a bare `@N` only announces that nothing else comes before tick N). Each tick
+	/// waits for the first line tagged past it, so a piped controller steers the battle deterministically.
+	class ScenarioRunner
+	{
+	private:
+		using Parser = io::CommandParser<
+			io::CreateMap,
+			io::Terrain,
+			io::LoadTerrain,
+			io::SpawnSwordsman,
+			io::SpawnHunter,
+			io::March,
+			io::SpawnSwordsmanFormation,
+			io::SpawnHunterFormation,
+			io::MarchRange>;
+
+		Parser _parser;
+		std::unique_ptr<core::GameWorld> _map;
+		// Scenario being played
+		core::IGameEvents* _events{};
+		const ScenarioOptions* _options{};
+		bool _started{false};
+
+		// One scenario line (or compiled record)
+		struct Item
+		{
+			// Set for tagged items: the command is applied before this tick
+			std::optional<uint64_t> tick;
+			// Empty for comments, blank lines and bare tick announcements
+			std::optional<Parser::Command> command;
+			// 1-based line (or record) number for errors
+			uint64_t position{};
+			// A tagged command that failed to decode; reported once its tick is reached, so earlier ticks still play
+			std::string error;
+		};
+
+		// Decodes a text line; tagged lines that fail keep the error for when their tick is reached
+		static void readLine(std::string_view line, Item& item);
+
+		core::GameWorld& requireMap();
+
+		// Plays the items `source` yields until it returns false; `preload` runs first and may apply part of the
+		// setup itself. `unit` names positions in errors ("line", "record").
+		void play(
+			core::FunctionRef<bool(Item&)> source,
+			const char* unit,
+			const ScenarioOptions& options,
+			std::ostream& out,
+			core::FunctionRef<void()> preload);
+
+	public:
+		ScenarioRunner();
+
+		// Handlers refer back to the runner
+		ScenarioRunner(const ScenarioRunner&) = delete;
+		ScenarioRunner& operator=(const ScenarioRunner&) = delete;
+
+		// Writes the event log (or hash trace) to `out`. Throws std::runtime_error naming the failed stage
+		// ("Error parsing commands: line N: ...", "Map was not created!", "Simulation error: ...").
+		void run(std::istream& scenario, const ScenarioOptions& options, std::ostream& out);
+
+		// Same for a scenario held in memory (e.g. a mapped file): a large setup is decoded on several threads and
+		// applied in file order (see CommandParser::parseParallel)
+		void run(std::string_view scenario, const ScenarioOptions& options, std::ostream& out);
+
+		// Same for a compiled scenario (see CompiledScenario.hpp); errors name records instead of lines
+		void runCompiled(std::span<const std::byte> scenario, const ScenarioOptions& options, std::ostream& out);
+
+		// Compiles a text scenario into the binary form runCompiled() plays.
+		// Throws std::runtime_error ("line N: ...") on lines that do not decode.
+		static std::vector<std::byte> compile(std::string_view text, const ScenarioSource& source = {});
+	};
+}
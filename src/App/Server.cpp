@@ -0,0 +1,344 @@
+#include "Server.hpp"
+
+#include "../IO/System/FdStream.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <cerrno>
+	#include <csignal>
+	#include <cstring>
+	#include <sys/socket.h>
+	#include <sys/un.h>
+	#include <unistd.h>
+	#define SW_HAS_UNIX_SOCKETS 1
+#endif
+
+namespace sw::app
+{
+	// Responses of one input stream; requests stay pending until a worker has written their response
+	struct Server::Connection
+	{
+		std::ostream& out;
+		std::mutex mutex;
+		std::condition_variable idle;
+		size_t pending{0};
+
+		explicit Connection(std::ostream& stream) :
+				out(stream)
+		{}
+
+		void respond(std::string_view id, bool ok, std::string_view body)
+		{
+			std::lock_guard lock(mutex);
+			out << id << (ok ? " ok " : " error ") << body.size() << '\n';
+			out.write(body.data(), static_cast<std::streamsize>(body.size()));
+			out.flush();
+			if (--pending == 0)
+			{
+				idle.notify_all();
+			}
+		}
+	};
+
+	namespace
+	{
+		// Larger payloads are taken for a corrupt header rather than allocated
+		constexpr uint64_t MaxPayloadSize = uint64_t{1} << 30;
+
+		uint64_t parseNumber(std::string_view field, std::string_view text)
+		{
+			uint64_t value{};
+			const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+			if (text.empty() || error != std::errc{} || end != text.data() + text.size())
+			{
+				throw std::invalid_argument("Invalid " + std::string(field) + ": " + std::string(text));
+			}
+			return value;
+		}
+
+		void parseFlags(std::string_view flags, ScenarioOptions& options)
+		{
+			if (flags == "-")
+			{
+				return;
+			}
+			while (!flags.empty())
+			{
+				const auto comma = flags.find(',');
+				const auto flag = flags.substr(0, comma);
+				if (flag == "fast-forward")
+				{
+					options.simulation.fastForward = true;
+				}
+				else if (flag == "fast-forward=silent")
+				{
+					options.simulation.fastForward = true;
+					options.simulation.fastForwardSilent = true;
+				}
+				else if (flag == "hash-trace")
+				{
+					options.hashTrace = true;
+				}
+				else if (flag == "quiet")
+				{
+					options.quiet = true;
+				}
+				else
+				{
+					throw std::invalid_argument("Unknown flag: " + std::string(flag));
+				}
+				flags = comma == std::string_view::npos ? std::string_view{} : flags.substr(comma + 1);
+			}
+		}
+	}
+
+	Server::Server(ServerOptions options)
+	{
+		size_t workers = options.workers ? options.workers : std::thread::hardware_concurrency();
+		workers = std::max<size_t>(workers, 1);
+		// Enough queued requests to keep every worker busy while the reader parses the next frames
+		_capacity = workers * 4;
+		_workers.reserve(workers);
+		for (size_t i = 0; i < workers; ++i)
+		{
+			_workers.emplace_back([this] { work(); });
+		}
+	}
+
+	Server::~Server()
+	{
+		{
+			std::lock_guard lock(_mutex);
+			_stopping = true;
+		}
+		_ready.notify_all();
+		for (auto& worker : _workers)
+		{
+			worker.join();
+		}
+	}
+
+	void Server::submit(Job job)
+	{
+		{
+			std::unique_lock lock(_mutex);
+			_space.wait(lock, [this] { return _queue.size() < _capacity; });
+			_queue.push_back(std::move(job));
+		}
+		_ready.notify_one();
+	}
+
+	void Server::work()
+	{
+		ScenarioRunner runner;
+		std::ostringstream result;
+		for (;;)
+		{
+			Job job;
+			{
+				std::unique_lock lock(_mutex);
+				_ready.wait(lock, [this] { return _stopping || !_queue.empty(); });
+				if (_queue.empty())
+				{
+					return;
+				}
+				job = std::move(_queue.front());
+				_queue.pop_front();
+			}
+			_space.notify_one();
+
+			result.str({});
+			result.clear();
+			try
+			{
+				if (job.fromFile)
+				{
+					std::ifstream stream(job.payload);
+					if (!stream.is_open())
+					{
+						throw std::runtime_error("Failed to open file: " + job.payload);
+					}
+					runner.run(stream, job.options, result);
+				}
+				else
+				{
+					std::istringstream stream(std::move(job.payload));
+					runner.run(stream, job.options, result);
+				}
+				job.connection->respond(job.id, true, result.view());
+			}
+			catch (const std::exception& e)
+			{
+				job.connection->respond(job.id, false, e.what());
+			}
+		}
+	}
+
+	bool Server::serve(std::istream& in, std::ostream& out)
+	{
+		Connection connection(out);
+		bool wellFormed = true;
+		std::string header;
+		while (std::getline(in, header))
+		{
+			if (header.empty())
+			{
+				continue;
+			}
+
+			Job job;
+			try
+			{
+				std::istringstream fields(header);
+				std::string source, seed, flags, length;
+				if (!(fields >> job.id >> source >> seed >> flags >> length) || !(fields >> std::ws).eof())
+				{
+					throw std::invalid_argument("Malformed request header: " + header);
+				}
+				if (source != "text" && source != "file")
+				{
+					throw std::invalid_argument("Unknown request source: " + source);
+				}
+				job.fromFile = source == "file";
+				job.options.seed = parseNumber("seed", seed);
+				parseFlags(flags, job.options);
+
+				const uint64_t size = parseNumber("length", length);
+				if (size > MaxPayloadSize)
+				{
+					throw std::invalid_argument("Request payload is too large: " + length);
+				}
+				job.payload.resize(size);
+				in.read(job.payload.data(), static_cast<std::streamsize>(job.payload.size()));
+				if (static_cast<size_t>(in.gcount()) != job.payload.size())
+				{
+					throw std::invalid_argument("Request payload is truncated");
+				}
+			}
+			catch (const std::invalid_argument& e)
+			{
+				{
+					std::lock_guard lock(connection.mutex);
+					++connection.pending;
+				}
+				connection.respond("-", false, e.what());
+				wellFormed = false;
+				break;
+			}
+
+			if (job.fromFile)
+			{
+				job.options.baseDirectory = std::filesystem::path(job.payload).parent_path();
+			}
+			job.connection = &connection;
+			{
+				std::lock_guard lock(connection.mutex);
+				++connection.pending;
+			}
+			submit(std::move(job));
+		}
+
+		std::unique_lock lock(connection.mutex);
+		connection.idle.wait(lock, [&] { return connection.pending == 0; });
+		return wellFormed;
+	}
+
+	void Server::serveSocket(const std::string& path)
+	{
+#if defined(SW_HAS_UNIX_SOCKETS)
+		sockaddr_un address{};
+		address.sun_family = AF_UNIX;
+		if (path.size() >= sizeof(address.sun_path))
+		{
+			throw std::runtime_error("Socket path is too long: " + path);
+		}
+		std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+		// A client hanging up mid-response must not kill the server
+		std::signal(SIGPIPE, SIG_IGN);
+
+		const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (listener < 0)
+		{
+			throw std::runtime_error("Failed to create socket: " + std::string(std::strerror(errno)));
+		}
+		::unlink(path.c_str());
+		if (::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+			::listen(listener, SOMAXCONN) != 0)
+		{
+			const std::string reason = std::strerror(errno);
+			::close(listener);
+			throw std::runtime_error("Failed to listen on " + path + ": " + reason);
+		}
+
+		// Each connection gets a reader thread feeding the shared workers, so a slow client only delays itself.
+		// The readers use this frame: it is only left once every connection is closed.
+		std::mutex mutex;
+		std::condition_variable closed;
+		std::vector<int> clients;
+		auto closeAll = [&]
+		{
+			::close(listener);
+			std::unique_lock lock(mutex);
+			for (const int client : clients)
+			{
+				::shutdown(client, SHUT_RDWR);
+			}
+			closed.wait(lock, [&] { return clients.empty(); });
+		};
+
+		for (;;)
+		{
+			const int client = ::accept(listener, nullptr, nullptr);
+			if (client < 0)
+			{
+				if (errno == EINTR || errno == ECONNABORTED)
+				{
+					continue;
+				}
+				const std::string reason = std::strerror(errno);
+				closeAll();
+				throw std::runtime_error("Failed to accept connection: " + reason);
+			}
+
+			std::lock_guard lock(mutex);
+			clients.push_back(client);
+			try
+			{
+				std::thread(
+					[&, client]
+					{
+						{
+							io::FdStreamBuf buffer(client);
+							std::istream in(&buffer);
+							std::ostream out(&buffer);
+							serve(in, out);
+						}
+						std::lock_guard lock(mutex);
+						clients.erase(std::find(clients.begin(), clients.end(), client));
+						::close(client);
+						closed.notify_all();
+					})
+					.detach();
+			}
+			catch (const std::system_error&)
+			{
+				// Out of threads: drop this connection, keep serving the others
+				clients.pop_back();
+				::close(client);
+			}
+		}
+#else
+		throw std::runtime_error("Unix domain sockets are not supported on this platform: " + path);
+#endif
+	}
+}
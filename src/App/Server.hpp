@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ScenarioRunner.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sw::app
+{
+	struct ServerOptions
+	{
+		// Worker threads; 0 uses one per hardware thread
+		size_t workers{0};
+	};
+
+	/// @brief Plays many scenarios in one process: `sw_battle_test --serve` and `--serve-socket`.
+	/// Requests are framed as a header line followed by a payload of exactly `length` bytes:
+	///     <id> <text|file> <seed> <flags> <length>\n<payload>
+	/// The payload is the scenario text, or for `file` the scenario path (relative LOAD_TERRAIN paths then resolve
+	/// against its directory). `flags` is `-` or a comma-separated list of `fast-forward`, `fast-forward=silent`,
+	/// `hash-trace` and `quiet`. Each request gets one response, written as soon as it completes (so possibly out of
+	/// order):
+	///     <id> <ok|error> <length>\n<event log, hash trace, summary or error message>
+	/// Workers keep their ScenarioRunner (parser and handlers) across requests.
+	class Server
+	{
+	private:
+		struct Connection;
+
+		struct Job
+		{
+			std::string id;
+			std::string payload;
+			bool fromFile{false};
+			ScenarioOptions options;
+			Connection* connection{};
+		};
+
+		std::mutex _mutex;
+		std::condition_variable _ready;
+		std::condition_variable _space;
+		std::deque<Job> _queue;
+		size_t _capacity;
+		bool _stopping{false};
+		std::vector<std::thread> _workers;
+
+		void work();
+		void submit(Job job);
+
+	public:
+		explicit Server(ServerOptions options = {});
+		~Server();
+
+		Server(const Server&) = delete;
+		Server& operator=(const Server&) = delete;
+
+		// Serves requests from `in` until it ends and returns once every response has been written to `out`.
+		// A malformed header cannot be skipped: it is answered with id `-` and ends the stream (returns false).
+		bool serve(std::istream& in, std::ostream& out);
+
+		// Listens on a Unix domain socket at `path` (replacing a stale socket file) and serves its connections
+		// concurrently: each is read on its own thread, and all share the workers. Returns only by throwing
+		// std::runtime_error, once the open connections are closed.
+		void serveSocket(const std::string& path);
+	};
+}
@@ -0,0 +1,153 @@
+#include "Simulation.hpp"
+
+#include "FastForward.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+namespace sw::app
+{
+	namespace
+	{
+		// Planning costs a few range queries per unit, so back off while battles keep the world contested
+		constexpr uint64_t MaxPlanBackoff = 64;
+
+		// Shared by the IGameEvents and NullEvents overloads; the latter keeps the sink type down to the behaviors
+		template <typename TEvents>
+		bool playTickWith(core::GameWorld& world, TEvents& events)
+		{
+			bool anyAction = false;
+
+			world.forEachUnit(
+				[&](core::Unit& unit)
+				{
+					if (unit.playTurn(world, events))
+					{
+						anyAction = true;
+					}
+				});
+
+			// Cleanup dead
+			for (const auto& id : world.removeDeadUnits())
+			{
+				events.onUnitDied(id);
+			}
+
+			// Check end conditions
+			return world.getUnitCount() > 1 && anyAction;
+		}
+
+		template <typename TEvents>
+		SimulationStats runSimulationWith(
+			core::GameWorld& world, TEvents& events, uint64_t& tick, const SimulationOptions& options)
+		{
+			SimulationStats stats;
+			uint64_t nextPlanTick = tick;
+			uint64_t planBackoff = 1;
+			const bool checkpoints = options.checkpointEvery > 0 && options.onCheckpoint;
+			uint64_t nextCheckpoint = tick + options.checkpointEvery;
+			bool reached = false;
+
+			while (true)
+			{
+				if (!reached && tick >= options.reachTick)
+				{
+					reached = true;
+					if (options.onReachTick)
+					{
+						options.onReachTick(tick);
+					}
+				}
+
+				if (checkpoints && tick >= nextCheckpoint)
+				{
+					options.onCheckpoint(world, tick);
+					nextCheckpoint = tick + options.checkpointEvery;
+				}
+
+				const uint64_t scheduled = options.beforeTick ? options.beforeTick(world, tick) : NoScheduledTick;
+
+				if (options.fastForward && tick >= nextPlanTick)
+				{
+					const uint64_t barrier = reached ? scheduled : std::min(scheduled, options.reachTick);
+					const uint64_t quiet = planQuietTicks(world, std::min(options.maxFastForwardTicks, barrier - tick));
+					if (quiet > 0)
+					{
+						// Every quiet tick moves someone and kills no one, so the loop would have gone on past them all
+						advanceQuietTicks(world, events, tick, quiet, !options.fastForwardSilent);
+						if (options.onTickEnd)
+						{
+							options.onTickEnd(world, tick - 1);
+						}
+						stats.ticks += quiet;
+						stats.fastForwardedTicks += quiet;
+						planBackoff = 1;
+						continue;
+					}
+
+					nextPlanTick = tick + planBackoff;
+					planBackoff = std::min(planBackoff * 2, MaxPlanBackoff);
+				}
+
+				const bool running = playTickWith(world, events);
+				++stats.ticks;
+
+				if (options.onTickEnd)
+				{
+					options.onTickEnd(world, tick);
+				}
+
+				if (!running)
+				{
+					if (scheduled == NoScheduledTick)
+					{
+						break;
+					}
+					// Scheduled commands may restart the battle; the ticks before them would pass idle
+					tick = scheduled;
+					continue;
+				}
+
+				tick++;
+			}
+
+			return stats;
+		}
+	}
+
+	bool playTick(core::GameWorld& world, core::IGameEvents& events)
+	{
+		return playTickWith(world, events);
+	}
+
+	bool playTick(core::GameWorld& world, core::NullEvents& events)
+	{
+		return playTickWith(world, events);
+	}
+
+	SimulationStats runSimulation(
+		core::GameWorld& world, core::IGameEvents& events, uint64_t& tick, const SimulationOptions& options)
+	{
+		return runSimulationWith(world, events, tick, options);
+	}
+
+	SimulationStats runSimulation(
+		core::GameWorld& world, core::NullEvents& events, uint64_t& tick, const SimulationOptions& options)
+	{
+		return runSimulationWith(world, events, tick, options);
+	}
+
+	void writeBattleSummary(std::ostream& out, const core::GameWorld& world, uint64_t tick)
+	{
+		out << "Battle ended at tick " << tick << ": ";
+		if (world.getUnitCount() == 1)
+		{
+			world.forEachUnit([&out](const core::Unit& unit) { out << "unit " << unit.getId() << " wins"; });
+		}
+		else
+		{
+			out << "no winner (" << world.getUnitCount() << " units left)";
+		}
+		out << '\n';
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../Core/GameWorld.hpp"
+#include "../Core/IGameEvents.hpp"
+#include "../Core/NullEvents.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <limits>
+
+namespace sw::app
+{
+	inline constexpr uint64_t NoScheduledTick = std::numeric_limits<uint64_t>::max();
+
+	struct SimulationOptions
+	{
+		bool fastForward{false};
+		// Fast-forwarded ticks emit no UNIT_MOVED / MARCH_ENDED events
+		bool fastForwardSilent{false};
+		// Upper bound on a single fast-forward window
+		uint64_t maxFastForwardTicks{1024};
+
+		// Called between ticks once at least `checkpointEvery` ticks were played since the start or the last call,
+		// with the next tick to play. 0 disables checkpoints.
+		uint64_t checkpointEvery{0};
+		std::function<void(const core::GameWorld&, uint64_t nextTick)> onCheckpoint;
+
+		// Called before each tick (and fast-forward window) to apply commands scheduled up to that tick; returns the
+		// next tick with scheduled commands, or NoScheduledTick. Fast-forward windows stop short of it, and a battle
+		// that is over resumes there instead of ending.
+		std::function<uint64_t(core::GameWorld&, uint64_t tick)> beforeTick;
+
+		// Called after every played tick once dead units are removed; a fast-forward window reports only its last tick
+		std::function<void(const core::GameWorld&, uint64_t tick)> onTickEnd;
+
+		// Called once before playing `reachTick` (or a later tick the battle skips to), e.g. to start logging there;
+		// fast-forward windows stop short of it. A battle over before then ends without the call.
+		uint64_t reachTick{NoScheduledTick};
+		std::function<void(uint64_t tick)> onReachTick;
+	};
+
+	struct SimulationStats
+	{
+		uint64_t ticks{};
+		uint64_t fastForwardedTicks{};
+	};
+
+	// Plays one tick: units act in creation order, then dead units are removed and reported.
+	// Returns false if the battle is over (at most one unit is left, or no unit acted).
+	bool playTick(core::GameWorld& world, core::IGameEvents& events);
+	// Same without events: behaviors get core::NullEvents itself, so headless ticks make no event calls at all
+	bool playTick(core::GameWorld& world, core::NullEvents& events);
+
+	// Plays turns from `tick` (advanced in place; it is the last played tick on return) until one unit is left or a
+	// tick passes without any action, and no commands are scheduled (see SimulationOptions::beforeTick).
+	// Units act in creation order; dead units are removed after each tick.
+	SimulationStats runSimulation(
+		core::GameWorld& world, core::IGameEvents& events, uint64_t& tick, const SimulationOptions& options = {});
+	SimulationStats runSimulation(
+		core::GameWorld& world, core::NullEvents& events, uint64_t& tick, const SimulationOptions& options = {});
+
+	// One line for headless runs: "Battle ended at tick T: unit N wins" or "...: no winner (K units left)"
+	void writeBattleSummary(std::ostream& out, const core::GameWorld& world, uint64_t tick);
+}
@@ -0,0 +1,251 @@
+#include "Timeline.hpp"
+
+#include "../Core/NullEvents.hpp"
+#include "../Features/Components.hpp"
+#include "Simulation.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sw::app
+{
+	// Forwards events while journaling the reverse delta of each mutation they report.
+	// Events are emitted while the unit still holds the pre-mutation march state (see MoveBehavior).
+	class Timeline::Recorder final : public core::IGameEvents
+	{
+	private:
+		Timeline& _timeline;
+		core::IGameEvents& _events;
+
+		bool marchDetoured(core::UnitId unit) const
+		{
+			const auto* march = _timeline._world->getUnitById(unit).getComponent<features::MarchComponent>();
+			return march && march->detoured;
+		}
+
+	public:
+		Recorder(Timeline& timeline, core::IGameEvents& events) :
+				_timeline(timeline),
+				_events(events)
+		{}
+
+		void onMapCreated(uint32_t width, uint32_t height) override
+		{
+			_events.onMapCreated(width, height);
+		}
+
+		void onUnitSpawned(core::UnitId unit, std::string_view unitType, core::Position pos) override
+		{
+			_events.onUnitSpawned(unit, unitType, pos);
+		}
+
+		void onMarchStarted(core::UnitId unit, core::Position from, core::Position target) override
+		{
+			_events.onMarchStarted(unit, from, target);
+		}
+
+		void onUnitAttacked(core::UnitId attacker, core::UnitId target, uint32_t damage, uint32_t targetHp) override
+		{
+			_timeline._deltas.push_back(Delta{Delta::Kind::Damage, false, target, damage, 0});
+			_events.onUnitAttacked(attacker, target, damage, targetHp);
+		}
+
+		void onUnitMoved(core::UnitId unit, core::Position from, core::Position to) override
+		{
+			_timeline._deltas.push_back(Delta{Delta::Kind::Move, marchDetoured(unit), unit, from.x, from.y});
+			if (_timeline._world->testCell(core::CellLayer::Occupied, from))
+			{
+				_timeline._ticks.back().replayOnly = true;
+			}
+			_events.onUnitMoved(unit, from, to);
+		}
+
+		void onUnitDied(core::UnitId unit) override
+		{
+			_timeline._ticks.back().replayOnly = true;
+			_events.onUnitDied(unit);
+		}
+
+		void onMarchEnded(core::UnitId unit, core::Position pos) override
+		{
+			_timeline._deltas.push_back(Delta{Delta::Kind::MarchEnded, marchDetoured(unit), unit, pos.x, pos.y});
+			_events.onMarchEnded(unit, pos);
+		}
+	};
+
+	Timeline::Timeline(
+		std::unique_ptr<core::GameWorld> world, core::IGameEvents& events, uint64_t& tick, Options options) :
+			_world(std::move(world)),
+			_events(events),
+			_tick(tick),
+			_options(options),
+			_firstTick(tick)
+	{
+		if (!_world)
+		{
+			throw std::invalid_argument("Timeline: world must not be null");
+		}
+		_options.keyframeInterval = std::max<uint64_t>(_options.keyframeInterval, 1);
+		_options.maxKeyframes = std::max<size_t>(_options.maxKeyframes, 1);
+		takeKeyframe();
+	}
+
+	Timeline::~Timeline() = default;
+
+	bool Timeline::step()
+	{
+		if (_running)
+		{
+			_running = playRecordedTick(_events);
+		}
+		return _running;
+	}
+
+	bool Timeline::playRecordedTick(core::IGameEvents& events)
+	{
+		_ticks.push_back(TickRecord{_deltas.size(), _world->getRandom().getState(), 0, false});
+		Recorder recorder(*this, events);
+		const bool running = playTick(*_world, recorder);
+		_ticks.back().hash = _world->getStateHash();
+		++_tick;
+
+		if (_tick - 1 >= _keyframes.back().tick + _options.keyframeInterval)
+		{
+			takeKeyframe();
+		}
+		return running;
+	}
+
+	void Timeline::takeKeyframe()
+	{
+		_keyframes.push_back(Keyframe{_tick - 1, _world->fork()});
+		if (_keyframes.size() <= _options.maxKeyframes)
+		{
+			return;
+		}
+
+		// Forget everything up to the new oldest keyframe
+		_keyframes.pop_front();
+		const auto dropped = static_cast<size_t>(_keyframes.front().tick + 1 - _firstTick);
+		const size_t firstKept = dropped < _ticks.size() ? _ticks[dropped].begin : _deltas.size();
+		_ticks.erase(_ticks.begin(), _ticks.begin() + static_cast<std::ptrdiff_t>(dropped));
+		_deltas.erase(_deltas.begin(), _deltas.begin() + static_cast<std::ptrdiff_t>(firstKept));
+		for (auto& record : _ticks)
+		{
+			record.begin -= firstKept;
+		}
+		_firstTick += dropped;
+	}
+
+	void Timeline::rewindTo(uint64_t tick)
+	{
+		const uint64_t last = _tick - 1;
+		if (tick > last || tick < getOldestTick())
+		{
+			throw std::out_of_range("Timeline: tick is outside the recorded history");
+		}
+
+		const auto undone = _ticks.begin() + static_cast<std::ptrdiff_t>(tick + 1 - _firstTick);
+		if (std::any_of(undone, _ticks.end(), [](const TickRecord& record) { return record.replayOnly; }))
+		{
+			const auto keyframe = std::find_if(
+				_keyframes.rbegin(), _keyframes.rend(), [tick](const Keyframe& frame) { return frame.tick <= tick; });
+			replayFrom(*keyframe, tick);
+		}
+		else
+		{
+			while (_tick - 1 > tick)
+			{
+				undoLastTick();
+			}
+			truncateAfter(tick);
+		}
+		_running = true;
+	}
+
+	void Timeline::undoLastTick()
+	{
+		const TickRecord record = _ticks.back();
+		for (size_t i = _deltas.size(); i-- > record.begin;)
+		{
+			const Delta& delta = _deltas[i];
+			auto& unit = _world->getUnitById(delta.unit);
+			switch (delta.kind)
+			{
+				case Delta::Kind::Move:
+				{
+					_world->moveUnit(delta.unit, core::Position{delta.a, delta.b});
+					auto* march = unit.getComponent<features::MarchComponent>();
+					if (march && march->detoured != delta.detoured)
+					{
+						march->detoured = delta.detoured;
+						_world->syncUnitState(delta.unit);
+					}
+					break;
+				}
+				case Delta::Kind::Damage:
+				{
+					auto* health = unit.getComponent<features::HealthComponent>();
+					health->restoreDamage(delta.a);
+					unit.setDead(health->isDead());
+					_world->syncUnitState(delta.unit);
+					break;
+				}
+				case Delta::Kind::MarchEnded:
+				{
+					unit.addComponent<features::MarchComponent>(core::Position{delta.a, delta.b}).detoured =
+						delta.detoured;
+					_world->syncUnitState(delta.unit);
+					break;
+				}
+			}
+		}
+
+		_world->getRandom().setState(record.random);
+		_deltas.resize(record.begin);
+		_ticks.pop_back();
+		--_tick;
+	}
+
+	void Timeline::truncateAfter(uint64_t tick)
+	{
+		while (_keyframes.back().tick > tick)
+		{
+			_keyframes.pop_back();
+		}
+
+		const auto kept = static_cast<size_t>(tick + 1 - _firstTick);
+		if (kept < _ticks.size())
+		{
+			_deltas.resize(_ticks[kept].begin);
+			_ticks.resize(kept);
+		}
+	}
+
+	void Timeline::replayFrom(const Keyframe& keyframe, uint64_t tick)
+	{
+		const uint64_t start = keyframe.tick;
+		truncateAfter(start);
+		_world = _keyframes.back().world->fork();
+		_tick = start + 1;
+
+		core::NullEvents silent;
+		while (_tick - 1 < tick)
+		{
+			playRecordedTick(silent);
+		}
+	}
+
+	uint64_t Timeline::getRecordedHash(uint64_t tick) const
+	{
+		if (tick == getOldestTick())
+		{
+			return _keyframes.front().world->getStateHash();
+		}
+		if (tick < _firstTick || tick - _firstTick >= _ticks.size())
+		{
+			throw std::out_of_range("Timeline: tick is outside the recorded history");
+		}
+		return _ticks[tick - _firstTick].hash;
+	}
+}
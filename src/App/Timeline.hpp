@@ -0,0 +1,123 @@
+#pragma once
+
+#include "../Core/GameWorld.hpp"
+#include "../Core/IGameEvents.hpp"
+#include "../Core/Random.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace sw::app
+{
+	/// @brief Plays a battle tick by tick while journaling enough to step back in time.
+	/// Every tick records compact reverse deltas (moves, damage, finished marches), captured from the events the
+	/// mutations already emit, plus the random generator state it started from. Rewinding undoes those deltas;
+	/// ticks that removed units or reordered a stacked cell cannot be undone in place and are instead replayed
+	/// from the nearest keyframe (a world fork taken every `keyframeInterval` ticks). Only the last `maxKeyframes`
+	/// keyframes and the ticks after the oldest one are kept, which bounds memory.
+	class Timeline
+	{
+	public:
+		struct Options
+		{
+			uint64_t keyframeInterval{64};
+			size_t maxKeyframes{8};
+		};
+
+	private:
+		struct Delta
+		{
+			enum class Kind : uint8_t
+			{
+				Move,
+				Damage,
+				MarchEnded,
+			};
+
+			Kind kind;
+			// Move: march state the step started from; MarchEnded: the finished march was a detour
+			bool detoured;
+			core::UnitId unit;
+			// Move: previous cell; Damage: (amount, 0); MarchEnded: march target
+			uint32_t a;
+			uint32_t b;
+		};
+
+		struct TickRecord
+		{
+			// First delta of the tick in _deltas
+			size_t begin;
+			core::Random::State random;
+			uint64_t hash;
+			// Units were removed or left a shared cell (whose order a reverse move cannot restore):
+			// the tick is undone by replay from a keyframe
+			bool replayOnly;
+		};
+
+		struct Keyframe
+		{
+			// Last tick played before the fork
+			uint64_t tick;
+			std::unique_ptr<core::GameWorld> world;
+		};
+
+		class Recorder;
+
+		std::unique_ptr<core::GameWorld> _world;
+		core::IGameEvents& _events;
+		uint64_t& _tick;
+		Options _options;
+		bool _running{true};
+
+		std::deque<Keyframe> _keyframes;
+		// Ticks (_firstTick + i) played since the oldest keyframe
+		uint64_t _firstTick;
+		std::vector<TickRecord> _ticks;
+		std::vector<Delta> _deltas;
+
+		void takeKeyframe();
+		void undoLastTick();
+		void truncateAfter(uint64_t tick);
+		void replayFrom(const Keyframe& keyframe, uint64_t tick);
+		bool playRecordedTick(core::IGameEvents& events);
+
+	public:
+		// `tick` is the next tick to play (as for runSimulation) and is kept current by step() and rewindTo()
+		Timeline(std::unique_ptr<core::GameWorld> world, core::IGameEvents& events, uint64_t& tick, Options options);
+		~Timeline();
+
+		// Plays the next tick, reporting its events; returns false once the battle is over
+		bool step();
+
+		// Restores the world as it was after `tick` was played (events are not reported again).
+		// Later history is discarded, so the world may be changed and played forward from there.
+		// Throws std::out_of_range if `tick` is in the future or older than the oldest keyframe.
+		void rewindTo(uint64_t tick);
+
+		// The live world; a different object after a rewind that replayed from a keyframe
+		[[nodiscard]]
+		core::GameWorld& getWorld() noexcept
+		{
+			return *_world;
+		}
+
+		[[nodiscard]]
+		bool isRunning() const noexcept
+		{
+			return _running;
+		}
+
+		// Oldest tick rewindTo() accepts
+		[[nodiscard]]
+		uint64_t getOldestTick() const noexcept
+		{
+			return _keyframes.front().tick;
+		}
+
+		// World hash recorded after `tick` was played (for checking rewinds)
+		[[nodiscard]]
+		uint64_t getRecordedHash(uint64_t tick) const;
+	};
+}
@@ -0,0 +1,174 @@
+#include "CellBitmap.hpp"
+
+#include <algorithm>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+	#include <immintrin.h>
+#endif
+
+namespace sw::core
+{
+	namespace
+	{
+		// OR-reduction over a run of full words. Blocks are reduced before testing so the inner loop stays branch-free.
+		bool anyWordSet(const uint64_t* words, size_t count) noexcept
+		{
+			size_t i = 0;
+#if defined(__AVX2__)
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+				const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i + 4));
+				const __m256i acc = _mm256_or_si256(lo, hi);
+				if (!_mm256_testz_si256(acc, acc))
+				{
+					return true;
+				}
+			}
+#elif defined(__SSE2__) || defined(_M_X64)
+			for (; i + 4 <= count; i += 4)
+			{
+				const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i));
+				const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i + 2));
+				const __m128i acc = _mm_or_si128(lo, hi);
+				if (_mm_movemask_epi8(_mm_cmpeq_epi8(acc, _mm_setzero_si128())) != 0xFFFF)
+				{
+					return true;
+				}
+			}
+#endif
+			uint64_t acc = 0;
+			for (; i < count; ++i)
+			{
+				acc |= words[i];
+			}
+			return acc != 0;
+		}
+	}
+
+	CellBitmap::CellBitmap(uint32_t width, uint32_t height) :
+			_width(width),
+			_height(height),
+			_rowWords((static_cast<size_t>(width) + 63) / 64)
+	{
+		_words.assign(_rowWords * height, 0);
+	}
+
+	void CellBitmap::fillRect(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1) noexcept
+	{
+		const size_t firstWord = x0 >> 6;
+		const size_t lastWord = x1 >> 6;
+		for (uint32_t y = y0; y <= y1; ++y)
+		{
+			uint64_t* row = rowData(y);
+			for (size_t word = firstWord; word <= lastWord; ++word)
+			{
+				uint64_t bits = ~uint64_t{0};
+				if (word == firstWord)
+				{
+					bits &= ~uint64_t{0} << (x0 & 63);
+				}
+				if (word == lastWord)
+				{
+					bits &= ~uint64_t{0} >> (63 - (x1 & 63));
+				}
+				row[word] |= bits;
+			}
+		}
+	}
+
+	void CellBitmap::clearPadding() noexcept
+	{
+		if ((_width & 63) == 0)
+		{
+			return;
+		}
+
+		const uint64_t lastMask = ~uint64_t{0} >> (64 - (_width & 63));
+		for (uint32_t y = 0; y < _height; ++y)
+		{
+			rowData(y)[_rowWords - 1] &= lastMask;
+		}
+	}
+
+	uint64_t CellBitmap::count() const noexcept
+	{
+		uint64_t total = 0;
+		for (const uint64_t word : _words)
+		{
+			total += static_cast<uint64_t>(std::popcount(word));
+		}
+		return total;
+	}
+
+	bool CellBitmap::anyInRow(uint32_t y, uint32_t xBegin, uint32_t xEnd) const noexcept
+	{
+		const uint64_t* row = rowData(y);
+		const size_t firstWord = xBegin >> 6;
+		const size_t lastWord = xEnd >> 6;
+		const uint64_t firstMask = ~uint64_t{0} << (xBegin & 63);
+		const uint64_t lastMask = ~uint64_t{0} >> (63 - (xEnd & 63));
+
+		if (firstWord == lastWord)
+		{
+			return (row[firstWord] & firstMask & lastMask) != 0;
+		}
+
+		if ((row[firstWord] & firstMask) != 0 || (row[lastWord] & lastMask) != 0)
+		{
+			return true;
+		}
+
+		return anyWordSet(row + firstWord + 1, lastWord - firstWord - 1);
+	}
+
+	bool CellBitmap::anyInRing(Position center, uint32_t minRange, uint32_t maxRange) const noexcept
+	{
+		if (minRange > maxRange || _width == 0 || _height == 0)
+		{
+			return false;
+		}
+
+		const int64_t cx = center.x;
+		const int64_t cy = center.y;
+		const int64_t range = maxRange;
+
+		const int64_t x0 = std::max<int64_t>(0, cx - range);
+		const int64_t x1 = std::min<int64_t>(static_cast<int64_t>(_width) - 1, cx + range);
+		const int64_t y0 = std::max<int64_t>(0, cy - range);
+		const int64_t y1 = std::min<int64_t>(static_cast<int64_t>(_height) - 1, cy + range);
+
+		// Rows closer than minRange have a hole of columns [cx - (minRange - 1), cx + (minRange - 1)].
+		const int64_t holeLeft = cx - (static_cast<int64_t>(minRange) - 1);
+		const int64_t holeRight = cx + (static_cast<int64_t>(minRange) - 1);
+
+		for (int64_t y = y0; y <= y1; ++y)
+		{
+			const auto row = static_cast<uint32_t>(y);
+			const int64_t dy = y > cy ? y - cy : cy - y;
+
+			if (dy >= static_cast<int64_t>(minRange))
+			{
+				if (anyInRow(row, static_cast<uint32_t>(x0), static_cast<uint32_t>(x1)))
+				{
+					return true;
+				}
+				continue;
+			}
+
+			if (x0 < holeLeft
+				&& anyInRow(row, static_cast<uint32_t>(x0), static_cast<uint32_t>(std::min(x1, holeLeft - 1))))
+			{
+				return true;
+			}
+
+			if (holeRight < x1
+				&& anyInRow(row, static_cast<uint32_t>(std::max(x0, holeRight + 1)), static_cast<uint32_t>(x1)))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
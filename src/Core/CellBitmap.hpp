@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace sw::core
+{
+	/// @brief Packed one-bit-per-cell map of the world grid.
+	/// Rows are stored row-major and padded to whole 64-bit words, so a horizontal span is tested
+	/// with two masked edge words plus a plain OR-reduction over the words in between.
+	class CellBitmap
+	{
+	private:
+		uint32_t _width{};
+		uint32_t _height{};
+		size_t _rowWords{};
+		std::vector<uint64_t> _words;
+
+		[[nodiscard]]
+		const uint64_t* rowData(uint32_t y) const noexcept
+		{
+			return _words.data() + static_cast<size_t>(y) * _rowWords;
+		}
+
+		[[nodiscard]]
+		uint64_t* rowData(uint32_t y) noexcept
+		{
+			return _words.data() + static_cast<size_t>(y) * _rowWords;
+		}
+
+	public:
+		CellBitmap() = default;
+		CellBitmap(uint32_t width, uint32_t height);
+
+		[[nodiscard]]
+		uint32_t getWidth() const noexcept
+		{
+			return _width;
+		}
+
+		[[nodiscard]]
+		uint32_t getHeight() const noexcept
+		{
+			return _height;
+		}
+
+		// 64-bit words per row, including padding past the map width
+		[[nodiscard]]
+		size_t getRowWords() const noexcept
+		{
+			return _rowWords;
+		}
+
+		// All rows back to back; used for bulk loading and saving. Padding bits must stay clear.
+		[[nodiscard]]
+		std::span<uint64_t> words() noexcept
+		{
+			return _words;
+		}
+
+		[[nodiscard]]
+		std::span<const uint64_t> words() const noexcept
+		{
+			return _words;
+		}
+
+		// Position must be inside the map.
+		[[nodiscard]]
+		bool test(Position pos) const noexcept
+		{
+			return (rowData(pos.y)[pos.x >> 6] >> (pos.x & 63)) & 1u;
+		}
+
+		void set(Position pos) noexcept
+		{
+			rowData(pos.y)[pos.x >> 6] |= uint64_t{1} << (pos.x & 63);
+		}
+
+		void reset(Position pos) noexcept
+		{
+			rowData(pos.y)[pos.x >> 6] &= ~(uint64_t{1} << (pos.x & 63));
+		}
+
+		void assign(Position pos, bool value) noexcept
+		{
+			if (value)
+			{
+				set(pos);
+			}
+			else
+			{
+				reset(pos);
+			}
+		}
+
+		// Sets every cell of the inclusive rectangle [x0, x1] x [y0, y1] (inside the map).
+		void fillRect(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1) noexcept;
+
+		// Clears bits past the map width in every row (after raw writes through words()).
+		void clearPadding() noexcept;
+
+		// Number of set cells
+		[[nodiscard]]
+		uint64_t count() const noexcept;
+
+		// True if any bit is set in row `y` within columns [xBegin, xEnd] (inclusive, inside the map).
+		[[nodiscard]]
+		bool anyInRow(uint32_t y, uint32_t xBegin, uint32_t xEnd) const noexcept;
+
+		// Calls visitor(x) for every set bit of row `y` within columns [xBegin, xEnd] (inclusive), in increasing x.
+		template <typename TVisitor>
+		void forEachSetInRow(uint32_t y, uint32_t xBegin, uint32_t xEnd, TVisitor&& visitor) const
+		{
+			const uint64_t* row = rowData(y);
+			const size_t firstWord = xBegin >> 6;
+			const size_t lastWord = xEnd >> 6;
+
+			for (size_t word = firstWord; word <= lastWord; ++word)
+			{
+				uint64_t bits = row[word];
+				if (word == firstWord)
+				{
+					bits &= ~uint64_t{0} << (xBegin & 63);
+				}
+				if (word == lastWord)
+				{
+					bits &= ~uint64_t{0} >> (63 - (xEnd & 63));
+				}
+
+				while (bits != 0)
+				{
+					visitor(static_cast<uint32_t>(word * 64 + static_cast<size_t>(std::countr_zero(bits))));
+					bits &= bits - 1;
+				}
+			}
+		}
+
+		// True if any bit is set at Chebyshev distance [minRange, maxRange] from `center`;
+		// the ring is clipped to the map.
+		[[nodiscard]]
+		bool anyInRing(Position center, uint32_t minRange, uint32_t maxRange) const noexcept;
+	};
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CowPtr.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sw::core
+{
+	/// @brief Units per cell, as handles into the owning world's unit table, stored in fixed-size chunks of cells.
+	/// Chunks are allocated on first use and shared copy-on-write with forks, so a fork only pays for the chunks
+	/// it changes. Cells are addressed by GridIndexer index.
+	class CellGrid
+	{
+	public:
+		using Handle = uint32_t;
+		using Cell = std::vector<Handle>;
+
+		static constexpr uint32_t ChunkShift = 12;
+		static constexpr size_t ChunkCells = size_t{1} << ChunkShift;
+
+	private:
+		struct Chunk
+		{
+			Cell cells[ChunkCells];
+		};
+
+		std::vector<CowPtr<Chunk>> _chunks;
+
+		static const Cell& emptyCell() noexcept
+		{
+			static const Cell empty;
+			return empty;
+		}
+
+	public:
+		explicit CellGrid(size_t cellCount = 0) :
+				_chunks((cellCount + ChunkCells - 1) >> ChunkShift)
+		{}
+
+		CellGrid(CellGrid&&) noexcept = default;
+		CellGrid& operator=(CellGrid&&) noexcept = default;
+
+		[[nodiscard]]
+		const Cell& cell(size_t index) const noexcept
+		{
+			const auto& chunk = _chunks[index >> ChunkShift];
+			return chunk ? chunk->cells[index & (ChunkCells - 1)] : emptyCell();
+		}
+
+		Cell& editCell(size_t index)
+		{
+			auto& chunk = _chunks[index >> ChunkShift];
+			if (!chunk)
+			{
+				chunk = CowPtr<Chunk>::make();
+			}
+			return chunk.edit().cells[index & (ChunkCells - 1)];
+		}
+
+		// Shares every chunk with the returned grid
+		CellGrid fork()
+		{
+			CellGrid copy;
+			copy._chunks.resize(_chunks.size());
+			for (size_t i = 0; i < _chunks.size(); ++i)
+			{
+				if (_chunks[i])
+				{
+					copy._chunks[i] = _chunks[i].share();
+				}
+			}
+			return copy;
+		}
+	};
+}
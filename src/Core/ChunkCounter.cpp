@@ -0,0 +1,58 @@
+#include "ChunkCounter.hpp"
+
+namespace sw::core
+{
+	ChunkCounter::ChunkCounter(uint32_t width, uint32_t height) :
+			_chunksX((width + ChunkSize - 1) >> ChunkShift),
+			_chunksY((height + ChunkSize - 1) >> ChunkShift)
+	{
+		_counts.assign(static_cast<size_t>(_chunksX) * _chunksY, 0);
+		_tree.assign(static_cast<size_t>(_chunksX + 1) * (_chunksY + 1), 0);
+	}
+
+	void ChunkCounter::add(Position pos, int32_t delta) noexcept
+	{
+		const uint32_t cx = pos.x >> ChunkShift;
+		const uint32_t cy = pos.y >> ChunkShift;
+		_counts[static_cast<size_t>(cy) * _chunksX + cx] += static_cast<uint32_t>(delta);
+		treeAdd(cx + 1, cy + 1, static_cast<uint32_t>(delta));
+		_total += static_cast<uint32_t>(delta);
+	}
+
+	uint32_t ChunkCounter::sumChunks(uint32_t cx0, uint32_t cy0, uint32_t cx1, uint32_t cy1) const noexcept
+	{
+		if (cx0 > cx1 || cy0 > cy1)
+		{
+			return 0;
+		}
+
+		return treePrefix(cx1 + 1, cy1 + 1) - treePrefix(cx0, cy1 + 1) - treePrefix(cx1 + 1, cy0)
+			+ treePrefix(cx0, cy0);
+	}
+
+	void ChunkCounter::treeAdd(uint32_t cx, uint32_t cy, uint32_t delta) noexcept
+	{
+		const size_t stride = static_cast<size_t>(_chunksX) + 1;
+		for (uint32_t y = cy; y <= _chunksY; y += y & (~y + 1))
+		{
+			for (uint32_t x = cx; x <= _chunksX; x += x & (~x + 1))
+			{
+				_tree[y * stride + x] += delta;
+			}
+		}
+	}
+
+	uint32_t ChunkCounter::treePrefix(uint32_t cx, uint32_t cy) const noexcept
+	{
+		const size_t stride = static_cast<size_t>(_chunksX) + 1;
+		uint32_t sum = 0;
+		for (uint32_t y = cy; y > 0; y -= y & (~y + 1))
+		{
+			for (uint32_t x = cx; x > 0; x -= x & (~x + 1))
+			{
+				sum += _tree[y * stride + x];
+			}
+		}
+		return sum;
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace sw::core
+{
+	/// @brief Unit counts per square chunk of cells, plus a 2D Fenwick tree over the chunk grid.
+	/// Point updates and rectangle sums over chunks are O(log^2(chunks)); single chunk reads are O(1),
+	/// which lets range scans skip empty chunks without touching their cells.
+	class ChunkCounter
+	{
+	private:
+		uint32_t _chunksX{};
+		uint32_t _chunksY{};
+		std::vector<uint32_t> _counts;
+		// 1-based Fenwick tree; unsigned wrap-around keeps deltas exact as long as real sums fit in 32 bits
+		std::vector<uint32_t> _tree;
+		uint32_t _total{};
+
+		void treeAdd(uint32_t cx, uint32_t cy, uint32_t delta) noexcept;
+		// Sum over chunks [0, cx) x [0, cy)
+		[[nodiscard]]
+		uint32_t treePrefix(uint32_t cx, uint32_t cy) const noexcept;
+
+	public:
+		static constexpr uint32_t ChunkShift = 4;
+		static constexpr uint32_t ChunkSize = 1u << ChunkShift;
+
+		ChunkCounter() = default;
+		ChunkCounter(uint32_t width, uint32_t height);
+
+		[[nodiscard]]
+		uint32_t getChunksX() const noexcept
+		{
+			return _chunksX;
+		}
+
+		[[nodiscard]]
+		uint32_t getChunksY() const noexcept
+		{
+			return _chunksY;
+		}
+
+		void add(Position pos, int32_t delta) noexcept;
+
+		[[nodiscard]]
+		uint32_t total() const noexcept
+		{
+			return _total;
+		}
+
+		[[nodiscard]]
+		uint32_t chunkCount(uint32_t cx, uint32_t cy) const noexcept
+		{
+			return _counts[static_cast<size_t>(cy) * _chunksX + cx];
+		}
+
+		// Sum over chunks [cx0, cx1] x [cy0, cy1] (inclusive); empty if the range is inverted
+		[[nodiscard]]
+		uint32_t sumChunks(uint32_t cx0, uint32_t cy0, uint32_t cx1, uint32_t cy1) const noexcept;
+	};
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+
+namespace sw::core
+{
+	/// @brief Copy-on-write handle to a heap value shared between forked worlds.
+	/// Ownership is tracked by a flag rather than by the reference count, so forks running on other threads never
+	/// race on it: after `share()` neither side owns the value and the first `edit()` on each side copies it.
+	template <typename T>
+	class CowPtr
+	{
+	private:
+		std::shared_ptr<T> _value;
+		bool _owned{false};
+
+		CowPtr(std::shared_ptr<T> value, bool owned) :
+				_value(std::move(value)),
+				_owned(owned)
+		{}
+
+	public:
+		CowPtr() = default;
+
+		// Copies would both claim ownership; use share()
+		CowPtr(const CowPtr&) = delete;
+		CowPtr& operator=(const CowPtr&) = delete;
+
+		CowPtr(CowPtr&&) noexcept = default;
+		CowPtr& operator=(CowPtr&&) noexcept = default;
+
+		template <typename... Args>
+		static CowPtr make(Args&&... args)
+		{
+			return CowPtr(std::make_shared<T>(std::forward<Args>(args)...), true);
+		}
+
+		[[nodiscard]]
+		explicit operator bool() const noexcept
+		{
+			return _value != nullptr;
+		}
+
+		[[nodiscard]]
+		const T& get() const noexcept
+		{
+			return *_value;
+		}
+
+		[[nodiscard]]
+		const T* operator->() const noexcept
+		{
+			return _value.get();
+		}
+
+		// Mutable access; copies the value first unless this handle owns it
+		T& edit()
+		{
+			if (!_owned)
+			{
+				_value = std::make_shared<T>(*_value);
+				_owned = true;
+			}
+			return *_value;
+		}
+
+		// Returns a second handle to the same value; both handles copy before their next edit
+		CowPtr share() noexcept
+		{
+			_owned = false;
+			return CowPtr(_value, false);
+		}
+	};
+}
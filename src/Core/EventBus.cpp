@@ -0,0 +1,123 @@
+#include "EventBus.hpp"
+
+namespace sw::core
+{
+	void EventBus::subscribe(IGameEvents& sink, EventMask kinds)
+	{
+		for (size_t kind = 0; kind < EventKindCount; ++kind)
+		{
+			if (kinds & eventBit(static_cast<EventKind>(kind)))
+			{
+				_sinks[kind].push_back(&sink);
+			}
+		}
+	}
+
+	void EventBus::subscribe(IEventBatchSink& sink, EventMask kinds)
+	{
+		_batchSinks.push_back(&sink);
+		_batchedKinds |= kinds;
+	}
+
+	void EventBus::flush()
+	{
+		if (_batch.empty())
+		{
+			return;
+		}
+		for (auto* sink : _batchSinks)
+		{
+			sink->onEvents(_batch);
+		}
+		_batch.clear();
+	}
+
+	void EventBus::onMapCreated(uint32_t width, uint32_t height)
+	{
+		for (auto* sink : sinks(EventKind::MapCreated))
+		{
+			sink->onMapCreated(width, height);
+		}
+		if (batched(EventKind::MapCreated))
+		{
+			_batch.push_back(GameEvent{.kind = EventKind::MapCreated, .pos = Position{width, height}});
+		}
+	}
+
+	void EventBus::onUnitSpawned(UnitId unit, std::string_view unitType, Position pos)
+	{
+		for (auto* sink : sinks(EventKind::UnitSpawned))
+		{
+			sink->onUnitSpawned(unit, unitType, pos);
+		}
+		if (batched(EventKind::UnitSpawned))
+		{
+			_batch.push_back(GameEvent{.kind = EventKind::UnitSpawned, .unit = unit, .pos = pos, .unitType = unitType});
+		}
+	}
+
+	void EventBus::onMarchStarted(UnitId unit, Position from, Position target)
+	{
+		for (auto* sink : sinks(EventKind::MarchStarted))
+		{
+			sink->onMarchStarted(unit, from, target);
+		}
+		if (batched(EventKind::MarchStarted))
+		{
+			_batch.push_back(GameEvent{.kind = EventKind::MarchStarted, .unit = unit, .pos = from, .to = target});
+		}
+	}
+
+	void EventBus::onUnitAttacked(UnitId attacker, UnitId target, uint32_t damage, uint32_t targetHp)
+	{
+		for (auto* sink : sinks(EventKind::UnitAttacked))
+		{
+			sink->onUnitAttacked(attacker, target, damage, targetHp);
+		}
+		if (batched(EventKind::UnitAttacked))
+		{
+			_batch.push_back(GameEvent{
+				.kind = EventKind::UnitAttacked,
+				.unit = attacker,
+				.target = target,
+				.damage = damage,
+				.targetHp = targetHp});
+		}
+	}
+
+	void EventBus::onUnitMoved(UnitId unit, Position from, Position to)
+	{
+		for (auto* sink : sinks(EventKind::UnitMoved))
+		{
+			sink->onUnitMoved(unit, from, to);
+		}
+		if (batched(EventKind::UnitMoved))
+		{
+			_batch.push_back(GameEvent{.kind = EventKind::UnitMoved, .unit = unit, .pos = from, .to = to});
+		}
+	}
+
+	void EventBus::onUnitDied(UnitId unit)
+	{
+		for (auto* sink : sinks(EventKind::UnitDied))
+		{
+			sink->onUnitDied(unit);
+		}
+		if (batched(EventKind::UnitDied))
+		{
+			_batch.push_back(GameEvent{.kind = EventKind::UnitDied, .unit = unit});
+		}
+	}
+
+	void EventBus::onMarchEnded(UnitId unit, Position pos)
+	{
+		for (auto* sink : sinks(EventKind::MarchEnded))
+		{
+			sink->onMarchEnded(unit, pos);
+		}
+		if (batched(EventKind::MarchEnded))
+		{
+			_batch.push_back(GameEvent{.kind = EventKind::MarchEnded, .unit = unit, .pos = pos});
+		}
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "IGameEvents.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace sw::core
+{
+	enum class EventKind : uint8_t
+	{
+		MapCreated,
+		UnitSpawned,
+		MarchStarted,
+		UnitAttacked,
+		UnitMoved,
+		UnitDied,
+		MarchEnded,
+	};
+
+	inline constexpr size_t EventKindCount = 7;
+
+	using EventMask = uint8_t;
+
+	[[nodiscard]]
+	constexpr EventMask eventBit(EventKind kind) noexcept
+	{
+		return static_cast<EventMask>(1u << static_cast<uint8_t>(kind));
+	}
+
+	inline constexpr EventMask AllEvents = static_cast<EventMask>((1u << EventKindCount) - 1);
+
+	// One event as delivered to batch sinks; fields not used by the kind are zero
+	struct GameEvent
+	{
+		EventKind kind{};
+		// Subject of the event (attacker for UnitAttacked)
+		UnitId unit{};
+		// UnitAttacked target
+		UnitId target{};
+		// Spawn / march start / move origin / march end position, or the map size (x = width, y = height)
+		Position pos{};
+		// MarchStarted target, UnitMoved destination
+		Position to{};
+		uint32_t damage{};
+		uint32_t targetHp{};
+		// UnitSpawned type; must outlive the batch (unit types are string literals)
+		std::string_view unitType{};
+	};
+
+	// Receives the events of a tick at once, when the bus is flushed
+	class IEventBatchSink
+	{
+	public:
+		virtual ~IEventBatchSink() = default;
+
+		// Holds every kind some batch sink subscribed to, in emission order; sinks skip kinds they did not ask for
+		virtual void onEvents(std::span<const GameEvent> events) = 0;
+	};
+
+	/// @brief Fans events out to several sinks, each subscribed to a set of event kinds.
+	/// Immediate sinks are listed per kind, so an event only reaches the sinks that asked for it. Batch sinks
+	/// share one buffer that flush() hands over (call it at tick end), so they cost a virtual call per tick
+	/// rather than per event. Sinks are not owned and must outlive the bus.
+	class EventBus final : public IGameEvents
+	{
+	private:
+		std::array<std::vector<IGameEvents*>, EventKindCount> _sinks;
+		std::vector<IEventBatchSink*> _batchSinks;
+		EventMask _batchedKinds{};
+		std::vector<GameEvent> _batch;
+
+		[[nodiscard]]
+		const std::vector<IGameEvents*>& sinks(EventKind kind) const noexcept
+		{
+			return _sinks[static_cast<size_t>(kind)];
+		}
+
+		[[nodiscard]]
+		bool batched(EventKind kind) const noexcept
+		{
+			return (_batchedKinds & eventBit(kind)) != 0;
+		}
+
+	public:
+		void subscribe(IGameEvents& sink, EventMask kinds = AllEvents);
+		void subscribe(IEventBatchSink& sink, EventMask kinds = AllEvents);
+
+		// Delivers buffered events to the batch sinks
+		void flush();
+
+		void onMapCreated(uint32_t width, uint32_t height) override;
+		void onUnitSpawned(UnitId unit, std::string_view unitType, Position pos) override;
+		void onMarchStarted(UnitId unit, Position from, Position target) override;
+		void onUnitAttacked(UnitId attacker, UnitId target, uint32_t damage, uint32_t targetHp) override;
+		void onUnitMoved(UnitId unit, Position from, Position to) override;
+		void onUnitDied(UnitId unit) override;
+		void onMarchEnded(UnitId unit, Position pos) override;
+	};
+}
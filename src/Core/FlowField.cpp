@@ -0,0 +1,361 @@
+#include "FlowField.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+namespace sw::core
+{
+	template <typename TVisitor>
+	void FlowField::forEachNeighbour(Position pos, TVisitor&& visitor) const
+	{
+		for (int32_t dy = -1; dy <= 1; ++dy)
+		{
+			for (int32_t dx = -1; dx <= 1; ++dx)
+			{
+				if (dx == 0 && dy == 0)
+				{
+					continue;
+				}
+
+				const int64_t x = static_cast<int64_t>(pos.x) + dx;
+				const int64_t y = static_cast<int64_t>(pos.y) + dy;
+				if (x < 0 || y < 0 || x >= _width || y >= _height)
+				{
+					continue;
+				}
+
+				visitor(Position{static_cast<uint32_t>(x), static_cast<uint32_t>(y)});
+			}
+		}
+	}
+
+	FlowField::FlowField(uint32_t width, uint32_t height, Position target) :
+			_width(width),
+			_height(height),
+			_target(target)
+	{}
+
+	void FlowField::rebuild(const CellBitmap& blockers)
+	{
+		_distances.assign(static_cast<size_t>(_width) * _height, Unreachable);
+		for (uint32_t y = 0; y < _height; ++y)
+		{
+			if (_width == 0 || !blockers.anyInRow(y, 0, _width - 1))
+			{
+				continue;
+			}
+			blockers.forEachSetInRow(
+				y, 0, _width - 1, [&](uint32_t x) { _distances[index(Position{x, y})] = Blocked; });
+		}
+
+		_targetBlocked = blockers.test(_target);
+		_distances[index(_target)] = 0;
+
+		// Plain BFS: every step costs 1, so the first visit is the shortest
+		std::vector<Position> frontier{_target};
+		for (size_t head = 0; head < frontier.size(); ++head)
+		{
+			const Position pos = frontier[head];
+			const uint32_t next = _distances[index(pos)] + 1;
+			forEachNeighbour(
+				pos,
+				[&](Position neighbour)
+				{
+					uint32_t& distance = _distances[index(neighbour)];
+					if (distance == Unreachable)
+					{
+						distance = next;
+						frontier.push_back(neighbour);
+					}
+				});
+		}
+	}
+
+	void FlowField::applyChange(Position cell, const CellBitmap& blockers)
+	{
+		const bool nowBlocked = blockers.test(cell);
+		if (cell == _target)
+		{
+			// The target stays the source either way; only stepping onto it depends on this
+			_targetBlocked = nowBlocked;
+			return;
+		}
+
+		const bool wasBlocked = _distances[index(cell)] == Blocked;
+		if (nowBlocked == wasBlocked)
+		{
+			return;
+		}
+
+		if (nowBlocked)
+		{
+			closeCell(cell);
+		}
+		else
+		{
+			openCell(cell);
+		}
+	}
+
+	uint32_t FlowField::bestNeighbourDistance(Position pos) const
+	{
+		// Starting at Unreachable keeps Blocked neighbours out of the minimum
+		uint32_t best = Unreachable;
+		forEachNeighbour(pos, [&](Position neighbour) { best = std::min(best, _distances[index(neighbour)]); });
+		return best;
+	}
+
+	void FlowField::openCell(Position cell)
+	{
+		// Opening a cell can only shorten paths: relax outwards from it
+		const uint32_t best = bestNeighbourDistance(cell);
+		uint32_t& distance = _distances[index(cell)];
+		distance = best == Unreachable ? Unreachable : best + 1;
+		if (distance == Unreachable)
+		{
+			return;
+		}
+
+		std::vector<Position> frontier{cell};
+		for (size_t head = 0; head < frontier.size(); ++head)
+		{
+			const Position pos = frontier[head];
+			const uint32_t next = _distances[index(pos)] + 1;
+			forEachNeighbour(
+				pos,
+				[&](Position neighbour)
+				{
+					uint32_t& current = _distances[index(neighbour)];
+					if (current != Blocked && next < current)
+					{
+						current = next;
+						frontier.push_back(neighbour);
+					}
+				});
+		}
+	}
+
+	void FlowField::closeCell(Position cell)
+	{
+		uint32_t& distance = _distances[index(cell)];
+		const uint32_t old = distance;
+		distance = Blocked;
+		if (old == Unreachable)
+		{
+			return;
+		}
+
+		// 1. Collect cells that lost every shortest-path parent. Old distances grow by one per step of the walk,
+		//    so by the time a cell is examined all affected cells one level closer are already marked.
+		std::vector<std::pair<Position, uint32_t>> affected{{cell, old}};
+		for (size_t head = 0; head < affected.size(); ++head)
+		{
+			const auto [pos, oldDistance] = affected[head];
+			forEachNeighbour(
+				pos,
+				[&](Position neighbour)
+				{
+					uint32_t& current = _distances[index(neighbour)];
+					if (current != oldDistance + 1 || bestNeighbourDistance(neighbour) + 1 == current)
+					{
+						return;
+					}
+					affected.emplace_back(neighbour, current);
+					current = Unreachable;
+				});
+		}
+
+		// 2. Re-seed affected cells from their intact neighbours and settle them in distance order
+		using QueueEntry = std::pair<uint32_t, size_t>;
+		std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<>> queue;
+		for (size_t i = 1; i < affected.size(); ++i)
+		{
+			const Position pos = affected[i].first;
+			const uint32_t best = bestNeighbourDistance(pos);
+			if (best != Unreachable)
+			{
+				_distances[index(pos)] = best + 1;
+				queue.emplace(best + 1, index(pos));
+			}
+		}
+
+		while (!queue.empty())
+		{
+			const auto [settled, flat] = queue.top();
+			queue.pop();
+			if (settled != _distances[flat])
+			{
+				continue;
+			}
+
+			const Position pos{static_cast<uint32_t>(flat % _width), static_cast<uint32_t>(flat / _width)};
+			forEachNeighbour(
+				pos,
+				[&](Position neighbour)
+				{
+					uint32_t& current = _distances[index(neighbour)];
+					if (current != Blocked && settled + 1 < current)
+					{
+						current = settled + 1;
+						queue.emplace(current, index(neighbour));
+					}
+				});
+		}
+	}
+
+	bool FlowField::findStep(Position from, Position& outNext) const
+	{
+		const uint32_t best = bestNeighbourDistance(from);
+		if (best == Unreachable)
+		{
+			return false;
+		}
+
+		auto isFree = [&](Position pos)
+		{
+			return pos == _target ? !_targetBlocked : _distances[index(pos)] != Blocked;
+		};
+
+		auto sign = [](uint32_t from, uint32_t to) { return to > from ? 1 : (to < from ? -1 : 0); };
+		const Position straight{
+			static_cast<uint32_t>(static_cast<int64_t>(from.x) + sign(from.x, _target.x)),
+			static_cast<uint32_t>(static_cast<int64_t>(from.y) + sign(from.y, _target.y))};
+		if (straight != from && _distances[index(straight)] == best && isFree(straight))
+		{
+			outNext = straight;
+			return true;
+		}
+
+		bool found = false;
+		forEachNeighbour(
+			from,
+			[&](Position neighbour)
+			{
+				if (!found && _distances[index(neighbour)] == best && isFree(neighbour))
+				{
+					outNext = neighbour;
+					found = true;
+				}
+			});
+		return found;
+	}
+
+	FlowFieldCache::FlowFieldCache(size_t capacity, size_t byteBudget) :
+			_capacity(std::max<size_t>(capacity, 1)),
+			_byteBudget(byteBudget)
+	{}
+
+	void FlowFieldCache::noteCellChanged(Position pos)
+	{
+		// Fields built later start from the current state, so nothing to record until one exists
+		if (_fields.empty())
+		{
+			return;
+		}
+
+		_changes.push_back(pos);
+		if (_changes.size() > JournalLimit)
+		{
+			trimJournal();
+		}
+	}
+
+	void FlowFieldCache::clear()
+	{
+		_fields.clear();
+		_changeBase = journalEnd();
+		_changes.clear();
+	}
+
+	void FlowFieldCache::trimJournal()
+	{
+		uint64_t keepFrom = journalEnd();
+		for (const auto& entry : _fields)
+		{
+			keepFrom = std::min(keepFrom, entry.syncedTo);
+		}
+
+		// A field lagging this far behind is cheaper to rebuild than to replay
+		if (journalEnd() - keepFrom >= JournalLimit)
+		{
+			keepFrom = journalEnd();
+		}
+
+		_changes.erase(_changes.begin(), _changes.begin() + static_cast<std::ptrdiff_t>(keepFrom - _changeBase));
+		_changeBase = keepFrom;
+	}
+
+	void FlowFieldCache::sync(Entry& entry, const CellBitmap& blockers)
+	{
+		const uint64_t end = journalEnd();
+		if (entry.syncedTo == end)
+		{
+			return;
+		}
+
+		const uint64_t pending = end - entry.syncedTo;
+		if (entry.syncedTo < _changeBase || pending * 8 > entry.field->_distances.size())
+		{
+			entry.field.edit().rebuild(blockers);
+			++_stats.builds;
+		}
+		else
+		{
+			auto& field = entry.field.edit();
+			for (uint64_t seq = entry.syncedTo; seq < end; ++seq)
+			{
+				field.applyChange(_changes[seq - _changeBase], blockers);
+			}
+			++_stats.incrementalUpdates;
+		}
+		entry.syncedTo = end;
+	}
+
+	FlowFieldCache FlowFieldCache::fork()
+	{
+		FlowFieldCache copy(_capacity, _byteBudget);
+		copy._changes = _changes;
+		copy._changeBase = _changeBase;
+		copy._useClock = _useClock;
+		copy._stats = _stats;
+		copy._fields.reserve(_fields.size());
+		for (auto& entry : _fields)
+		{
+			copy._fields.push_back(Entry{entry.field.share(), entry.syncedTo, entry.lastUse});
+		}
+		return copy;
+	}
+
+	const FlowField& FlowFieldCache::get(Position target, const CellBitmap& blockers)
+	{
+		++_useClock;
+		for (auto& entry : _fields)
+		{
+			if (entry.field->_target == target)
+			{
+				sync(entry, blockers);
+				entry.lastUse = _useClock;
+				return entry.field.get();
+			}
+		}
+
+		auto field = CowPtr<FlowField>::make(blockers.getWidth(), blockers.getHeight(), target);
+		field.edit().rebuild(blockers);
+		++_stats.builds;
+		Entry entry{std::move(field), journalEnd(), _useClock};
+
+		const size_t fieldBytes = std::max<size_t>(
+			size_t{blockers.getWidth()} * blockers.getHeight() * sizeof(uint32_t), 1);
+		if (_fields.size() < std::clamp<size_t>(_byteBudget / fieldBytes, 1, _capacity))
+		{
+			_fields.push_back(std::move(entry));
+			return _fields.back().field.get();
+		}
+
+		auto victim = std::min_element(
+			_fields.begin(), _fields.end(), [](const auto& a, const auto& b) { return a.lastUse < b.lastUse; });
+		*victim = std::move(entry);
+		return victim->field.get();
+	}
+}
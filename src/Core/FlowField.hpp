@@ -0,0 +1,143 @@
+#pragma once
+
+#include "CellBitmap.hpp"
+#include "CowPtr.hpp"
+#include "Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sw::core
+{
+	/// @brief Shortest 8-connected path lengths to one target cell, avoiding CellLayer::Blocker cells.
+	/// Diagonal steps are unrestricted, matching unit moves. The target itself is always the source (distance 0),
+	/// even while occupied.
+	class FlowField
+	{
+	public:
+		static constexpr uint32_t Blocked = UINT32_MAX;
+		static constexpr uint32_t Unreachable = UINT32_MAX - 1;
+
+	private:
+		friend class FlowFieldCache;
+
+		uint32_t _width;
+		uint32_t _height;
+		Position _target;
+		bool _targetBlocked{false};
+		std::vector<uint32_t> _distances;
+
+		[[nodiscard]]
+		size_t index(Position pos) const noexcept
+		{
+			return static_cast<size_t>(pos.y) * _width + pos.x;
+		}
+
+		template <typename TVisitor>
+		void forEachNeighbour(Position pos, TVisitor&& visitor) const;
+
+		void rebuild(const CellBitmap& blockers);
+		// Brings one cell in line with `blockers`, repairing only the distances that depend on it
+		void applyChange(Position cell, const CellBitmap& blockers);
+		void openCell(Position cell);
+		void closeCell(Position cell);
+		uint32_t bestNeighbourDistance(Position pos) const;
+
+	public:
+		FlowField(uint32_t width, uint32_t height, Position target);
+
+		[[nodiscard]]
+		Position getTarget() const noexcept
+		{
+			return _target;
+		}
+
+		// Path length from `pos` to the target, or Blocked / Unreachable
+		[[nodiscard]]
+		uint32_t getDistance(Position pos) const noexcept
+		{
+			return _distances[index(pos)];
+		}
+
+		// Picks a free neighbour of `from` on a shortest path; among equally short steps the straight (greedy) one
+		// wins.
+		// Returns false when no free neighbour is on a shortest path (the target is unreachable, or it is adjacent
+		// but occupied by a blocker).
+		bool findStep(Position from, Position& outNext) const;
+	};
+
+	// Field builds and journal replays performed by a cache; lets callers verify sharing and incremental updates.
+	struct FlowFieldStats
+	{
+		uint64_t builds{};
+		uint64_t incrementalUpdates{};
+	};
+
+	/// @brief LRU cache of flow fields keyed by target cell.
+	/// Holds at most `capacity` fields and, on large maps, only as many as fit `byteBudget` (but always one).
+	/// Blocker changes are journaled cheaply; each cached field replays the changes it missed on its next lookup,
+	/// or is rebuilt when it fell too far behind. Forked caches share fields until one side updates them.
+	class FlowFieldCache
+	{
+	private:
+		struct Entry
+		{
+			CowPtr<FlowField> field;
+			// Journal position the field reflects, and cache clock of its last lookup
+			uint64_t syncedTo{};
+			uint64_t lastUse{};
+		};
+
+		size_t _capacity;
+		size_t _byteBudget;
+		std::vector<Entry> _fields;
+
+		// Cells whose Blocker bit changed; _changes[i] has sequence number _changeBase + i
+		std::vector<Position> _changes;
+		uint64_t _changeBase{};
+		uint64_t _useClock{};
+		FlowFieldStats _stats;
+
+		[[nodiscard]]
+		uint64_t journalEnd() const noexcept
+		{
+			return _changeBase + _changes.size();
+		}
+
+		void trimJournal();
+		void sync(Entry& entry, const CellBitmap& blockers);
+
+	public:
+		static constexpr size_t DefaultCapacity = 8;
+		// Each field holds width * height distances; 64 MiB keeps all eight up to 1448x1448 maps
+		static constexpr size_t DefaultByteBudget = size_t{64} << 20;
+		static constexpr size_t JournalLimit = 4096;
+
+		explicit FlowFieldCache(size_t capacity = DefaultCapacity, size_t byteBudget = DefaultByteBudget);
+
+		FlowFieldCache(FlowFieldCache&&) noexcept = default;
+		FlowFieldCache& operator=(FlowFieldCache&&) noexcept = default;
+
+		// Copy sharing every field (and the journal) with this cache
+		FlowFieldCache fork();
+
+		// Records that the Blocker bit of `pos` may have changed
+		void noteCellChanged(Position pos);
+
+		// Drops every field; for bulk changes that are cheaper to rebuild from than to replay
+		void clear();
+
+		// Returns the up-to-date field for `target`, building it (and evicting the least recently used) if needed.
+		// The reference stays valid until the next call.
+		const FlowField& get(Position target, const CellBitmap& blockers);
+
+		[[nodiscard]]
+		const FlowFieldStats& getStats() const noexcept
+		{
+			return _stats;
+		}
+	};
+}
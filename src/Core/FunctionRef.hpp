@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace sw::core
+{
+	template <typename Signature>
+	class FunctionRef;
+
+	/// @brief Non-owning, non-allocating reference to a callable (in the spirit of `std::function_ref`).
+	/// Cheap to pass by value; the referenced callable must outlive the call, which holds for lambdas
+	/// passed directly as arguments.
+	template <typename R, typename... Args>
+	class FunctionRef<R(Args...)>
+	{
+	private:
+		void* _object;
+		R (*_invoke)(void*, Args...);
+
+	public:
+		template <typename F>
+			requires(!std::is_same_v<std::remove_cvref_t<F>, FunctionRef>
+					 && std::is_object_v<std::remove_reference_t<F>> && std::is_invocable_r_v<R, F&, Args...>)
+		FunctionRef(F&& callable) noexcept :
+				_object(const_cast<void*>(static_cast<const void*>(std::addressof(callable)))),
+				_invoke(
+					[](void* object, Args... args) -> R
+					{
+						auto& target = *static_cast<std::remove_reference_t<F>*>(object);
+						if constexpr (std::is_void_v<R>)
+						{
+							std::invoke(target, std::forward<Args>(args)...);
+						}
+						else
+						{
+							return std::invoke(target, std::forward<Args>(args)...);
+						}
+					})
+		{}
+
+		R operator()(Args... args) const
+		{
+			return _invoke(_object, std::forward<Args>(args)...);
+		}
+	};
+}
@@ -1,21 +1,167 @@
 #include "GameWorld.hpp"
 
+#include "PositionSweep.hpp"
+#include "StateHash.hpp"
 #include "Unit.hpp"
 
 #include <algorithm>
+#include <bit>
+#include <cstdlib>
 #include <stdexcept>
 
 namespace sw::core
 {
-	GameWorld::GameWorld(uint32_t width, uint32_t height) :
+	namespace
+	{
+		constexpr uint32_t ChunkShift = ChunkCounter::ChunkShift;
+
+		// Range walks go chunk band by chunk band; whole tiles per chunk keep each band's grid reads tile-local.
+		static_assert(ChunkCounter::ChunkSize % GridIndexer::TileSize == 0);
+
+		constexpr size_t layerIndex(CellLayer layer) noexcept
+		{
+			return static_cast<size_t>(layer);
+		}
+
+		constexpr bool sameChunk(Position a, Position b) noexcept
+		{
+			return (a.x >> ChunkShift) == (b.x >> ChunkShift) && (a.y >> ChunkShift) == (b.y >> ChunkShift);
+		}
+	}
+
+	template <typename TVisitor>
+	void GameWorld::forEachLayerCell(
+		CellLayer layer, const CellRect& outer, const CellRect& hole, TVisitor&& visitor) const
+	{
+		if (outer.empty())
+		{
+			return;
+		}
+
+		const auto& bitmap = _layers[layerIndex(layer)];
+		const auto& counter = _counts[layerIndex(layer)];
+		const uint32_t chunkX0 = static_cast<uint32_t>(outer.x0) >> ChunkShift;
+		const uint32_t chunkX1 = static_cast<uint32_t>(outer.x1) >> ChunkShift;
+
+		auto visitSpan = [&](uint32_t y, uint32_t chunkY, int64_t begin, int64_t end)
+		{
+			for (uint32_t chunkX = static_cast<uint32_t>(begin) >> ChunkShift;
+				 chunkX <= static_cast<uint32_t>(end) >> ChunkShift;
+				 ++chunkX)
+			{
+				if (counter.chunkCount(chunkX, chunkY) == 0)
+				{
+					continue;
+				}
+
+				const int64_t segBegin = std::max<int64_t>(begin, static_cast<int64_t>(chunkX) << ChunkShift);
+				const int64_t segEnd = std::min<int64_t>(end, (static_cast<int64_t>(chunkX + 1) << ChunkShift) - 1);
+				bitmap.forEachSetInRow(
+					y,
+					static_cast<uint32_t>(segBegin),
+					static_cast<uint32_t>(segEnd),
+					[&](uint32_t x) { visitor(Position{x, y}); });
+			}
+		};
+
+		const uint32_t chunkY0 = static_cast<uint32_t>(outer.y0) >> ChunkShift;
+		const uint32_t chunkY1 = static_cast<uint32_t>(outer.y1) >> ChunkShift;
+		for (uint32_t chunkY = chunkY0; chunkY <= chunkY1; ++chunkY)
+		{
+			if (counter.sumChunks(chunkX0, chunkY, chunkX1, chunkY) == 0)
+			{
+				continue;
+			}
+
+			const int64_t rowBegin = std::max<int64_t>(outer.y0, static_cast<int64_t>(chunkY) << ChunkShift);
+			const int64_t rowEnd = std::min<int64_t>(outer.y1, (static_cast<int64_t>(chunkY + 1) << ChunkShift) - 1);
+			for (int64_t y = rowBegin; y <= rowEnd; ++y)
+			{
+				const auto row = static_cast<uint32_t>(y);
+				if (hole.empty() || y < hole.y0 || y > hole.y1)
+				{
+					visitSpan(row, chunkY, outer.x0, outer.x1);
+					continue;
+				}
+
+				if (outer.x0 < hole.x0)
+				{
+					visitSpan(row, chunkY, outer.x0, std::min(outer.x1, hole.x0 - 1));
+				}
+				if (hole.x1 < outer.x1)
+				{
+					visitSpan(row, chunkY, std::max(outer.x0, hole.x1 + 1), outer.x1);
+				}
+			}
+		}
+	}
+
+	template <typename TVisitor>
+	void GameWorld::forEachRingCell(
+		CellLayer layer, Position center, uint32_t minRange, uint32_t maxRange, TVisitor&& visitor) const
+	{
+		if (minRange > maxRange)
+		{
+			return;
+		}
+
+		const CellRect hole = minRange > 0 ? clipSquare(center, minRange - 1) : CellRect{1, 1, 0, 0};
+		forEachLayerCell(layer, clipSquare(center, maxRange), hole, std::forward<TVisitor>(visitor));
+	}
+
+	GameWorld::GameWorld(uint32_t width, uint32_t height, GridLayout layout) :
 			_width(width),
-			_height(height)
+			_height(height),
+			_indexer(width, height, layout)
 	{
-		_grid.resize(width * height);
+		_grid = CellGrid(_indexer.getCellCount());
+		for (size_t i = 0; i < CellLayerCount; ++i)
+		{
+			_layers[i] = CellBitmap(width, height);
+			_counts[i] = ChunkCounter(width, height);
+		}
+		_terrain = CowPtr<CellBitmap>::make(width, height);
+	}
+
+	GameWorld::GameWorld(GameWorld& parent, ForkTag) :
+			_width(parent._width),
+			_height(parent._height),
+			_indexer(parent._indexer),
+			_units(parent._units.clone()),
+			_grid(parent._grid.fork()),
+			_handles(parent._handles.size(), nullptr),
+			_records(parent._records),
+			_layers(parent._layers),
+			_terrain(parent._terrain.share()),
+			_terrainCells(parent._terrainCells),
+			_counts(parent._counts),
+			_columns(parent._columns),
+			_rangeStats(parent._rangeStats),
+			_flowFields(parent._flowFields.fork()),
+			_random(parent._random),
+			_stateHash(parent._stateHash)
+	{
+		// A choice tape follows one battle; forks draw from the generator
+		_random.setChoiceTape(nullptr);
+
+		// Lookups still point at the parent's units; the clones keep creation order
+		_units.forEach(
+			[&](Unit& unit)
+			{
+				auto& record = _records.at(unit.getId());
+				record.unit = &unit;
+				_handles[record.handle] = &unit;
+				_columns.units[record.slot] = &unit;
+			});
 	}
 
 	GameWorld::~GameWorld() = default;
 
+	std::unique_ptr<GameWorld> GameWorld::fork()
+	{
+		return std::unique_ptr<GameWorld>(new GameWorld(*this, ForkTag{}));
+	}
+
 	uint32_t GameWorld::getWidth() const
 	{
 		return _width;
@@ -26,72 +172,76 @@ namespace sw::core
 		return _height;
 	}
 
-	void GameWorld::addUnit(std::unique_ptr<Unit> unit, Position pos)
+	Unit& GameWorld::addUnit(Unit unit, Position pos)
 	{
-		if (!unit)
-		{
-			throw std::invalid_argument("Cannot add null unit");
-		}
-
 		if (!isValid(pos))
 		{
 			throw std::out_of_range("Unit position out of bounds");
 		}
 
-		if (_unitById.find(unit->getId()) != _unitById.end())
+		if (_records.find(unit.getId()) != _records.end())
 		{
 			throw std::runtime_error("Unit ID already exists");
 		}
 
-		// Update lookups
-		size_t index = getGridIndex(pos);
-		_grid[index].push_back(unit.get());
-		_unitById[unit->getId()] = unit.get();
-		_unitPositions[unit->getId()] = pos;
+		// Store ownership first: lookups point at the unit's final address
+		Unit& stored = _units.emplace(std::move(unit));
 
-		// Store ownership
-		_units.push_back(std::move(unit));
+		// Update lookups
+		const LayerMask layers = layerBit(CellLayer::Occupied) | stored.getLayers();
+		const auto handle = static_cast<CellGrid::Handle>(_handles.size());
+		_handles.push_back(&stored);
+		_grid.editCell(getGridIndex(pos)).push_back(handle);
+		const auto slot = static_cast<uint32_t>(_columns.units.size());
+		auto& record =
+			_records.emplace(stored.getId(), UnitRecord{&stored, handle, pos, layers, slot, 0}).first->second;
+		refreshUnitHash(record);
+		_columns.x.push_back(static_cast<int32_t>(pos.x));
+		_columns.y.push_back(static_cast<int32_t>(pos.y));
+		_columns.layers.push_back(layers);
+		_columns.units.push_back(&stored);
+		adjustCounts(pos, layers, +1);
+		syncCellLayers(pos);
+
+		return stored;
 	}
 
-	void GameWorld::forEachUnitAt(Position pos, const std::function<void(const Unit&)>& visitor) const
+	void GameWorld::forEachUnitAt(Position pos, FunctionRef<void(const Unit&)> visitor) const
 	{
 		if (!isValid(pos))
 		{
 			return;
 		}
 
-		const auto& cell = _grid[getGridIndex(pos)];
-		for (const auto* unit : cell)
+		for (const auto handle : _grid.cell(getGridIndex(pos)))
 		{
-			visitor(*unit);
+			visitor(*_handles[handle]);
 		}
 	}
 
-	void GameWorld::forEachUnitAt(Position pos, const std::function<void(Unit&)>& visitor)
+	void GameWorld::forEachUnitAt(Position pos, FunctionRef<void(Unit&)> visitor)
 	{
 		if (!isValid(pos))
 		{
 			return;
 		}
 
-		auto& cell = _grid[getGridIndex(pos)];
-		for (auto* unit : cell)
+		for (const auto handle : _grid.cell(getGridIndex(pos)))
 		{
-			visitor(*unit);
+			visitor(*_handles[handle]);
 		}
 	}
 
-	bool GameWorld::anyUnitAt(Position pos, const std::function<bool(const Unit&)>& predicate) const
+	bool GameWorld::anyUnitAt(Position pos, FunctionRef<bool(const Unit&)> predicate) const
 	{
 		if (!isValid(pos))
 		{
 			return false;
 		}
 
-		const auto& cell = _grid[getGridIndex(pos)];
-		for (const auto* unit : cell)
+		for (const auto handle : _grid.cell(getGridIndex(pos)))
 		{
-			if (predicate(*unit))
+			if (predicate(*_handles[handle]))
 			{
 				return true;
 			}
@@ -99,19 +249,296 @@ namespace sw::core
 		return false;
 	}
 
+	void GameWorld::forEachUnitInRange(
+		CellLayer layer,
+		Position center,
+		uint32_t minRange,
+		uint32_t maxRange,
+		RangeStrategy strategy,
+		FunctionRef<void(const Unit&)> visitor) const
+	{
+		if (strategy == RangeStrategy::PositionSweep)
+		{
+			++_rangeStats.positionSweeps;
+			for (const uint32_t slot : sweepRange(layer, center, minRange, maxRange))
+			{
+				visitor(*_columns.units[slot]);
+			}
+			return;
+		}
+
+		++_rangeStats.cellScans;
+		const LayerMask bit = layerBit(layer);
+		forEachRingCell(
+			layer,
+			center,
+			minRange,
+			maxRange,
+			[&](Position pos)
+			{
+				for (const auto handle : _grid.cell(getGridIndex(pos)))
+				{
+					const Unit* unit = _handles[handle];
+					if (layer == CellLayer::Occupied || (unit->getLayers() & bit) != 0)
+					{
+						visitor(*unit);
+					}
+				}
+			});
+	}
+
+	void GameWorld::forEachUnitInRange(
+		CellLayer layer,
+		Position center,
+		uint32_t minRange,
+		uint32_t maxRange,
+		RangeStrategy strategy,
+		FunctionRef<void(Unit&)> visitor)
+	{
+		if (strategy == RangeStrategy::PositionSweep)
+		{
+			++_rangeStats.positionSweeps;
+			for (const uint32_t slot : sweepRange(layer, center, minRange, maxRange))
+			{
+				visitor(*_columns.units[slot]);
+			}
+			return;
+		}
+
+		++_rangeStats.cellScans;
+		const LayerMask bit = layerBit(layer);
+		forEachRingCell(
+			layer,
+			center,
+			minRange,
+			maxRange,
+			[&](Position pos)
+			{
+				for (const auto handle : _grid.cell(getGridIndex(pos)))
+				{
+					Unit* unit = _handles[handle];
+					if (layer == CellLayer::Occupied || (unit->getLayers() & bit) != 0)
+					{
+						visitor(*unit);
+					}
+				}
+			});
+	}
+
 	const Unit& GameWorld::getUnitById(UnitId id) const
 	{
-		return *_unitById.at(id);
+		return *_records.at(id).unit;
 	}
 
 	Unit& GameWorld::getUnitById(UnitId id)
 	{
-		return *_unitById.at(id);
+		return *_records.at(id).unit;
 	}
 
 	Position GameWorld::getUnitPosition(UnitId id) const
 	{
-		return _unitPositions.at(id);
+		return _records.at(id).pos;
+	}
+
+	bool GameWorld::testCell(CellLayer layer, Position pos) const
+	{
+		return isValid(pos) && _layers[layerIndex(layer)].test(pos);
+	}
+
+	bool GameWorld::anyCellInRange(CellLayer layer, Position center, uint32_t minRange, uint32_t maxRange) const
+	{
+		if (minRange > maxRange)
+		{
+			return false;
+		}
+
+		const auto& bitmap = _layers[layerIndex(layer)];
+
+		// Small neighbourhoods are a handful of words in the bitmap; chunk bookkeeping would only add overhead.
+		// Chunk counts only cover units, so terrain on the Blocker layer needs the bitmap too.
+		if (maxRange < ChunkCounter::ChunkSize || (layer == CellLayer::Blocker && _terrainCells > 0))
+		{
+			return bitmap.anyInRing(center, minRange, maxRange);
+		}
+
+		const auto& counter = _counts[layerIndex(layer)];
+		const CellRect outer = clipSquare(center, maxRange);
+		if (outer.empty())
+		{
+			return false;
+		}
+		const CellRect hole = minRange > 0 ? clipSquare(center, minRange - 1) : CellRect{1, 1, 0, 0};
+		const uint32_t holeCount = hole.empty() ? 0 : countRect(layer, hole);
+
+		// 1. Superset: chunks covering the outer square hold nothing besides what sits inside the hole.
+		const uint32_t cover = counter.sumChunks(
+			static_cast<uint32_t>(outer.x0) >> ChunkShift,
+			static_cast<uint32_t>(outer.y0) >> ChunkShift,
+			static_cast<uint32_t>(outer.x1) >> ChunkShift,
+			static_cast<uint32_t>(outer.y1) >> ChunkShift);
+		if (cover == holeCount)
+		{
+			return false;
+		}
+
+		// 2. Subset: chunks fully inside the outer square hold more than their overlap with the hole.
+		const int64_t fx0 = (outer.x0 + ChunkCounter::ChunkSize - 1) >> ChunkShift;
+		const int64_t fy0 = (outer.y0 + ChunkCounter::ChunkSize - 1) >> ChunkShift;
+		const int64_t fx1 = ((outer.x1 + 1) >> ChunkShift) - 1;
+		const int64_t fy1 = ((outer.y1 + 1) >> ChunkShift) - 1;
+		if (fx0 <= fx1 && fy0 <= fy1)
+		{
+			const uint32_t interior = counter.sumChunks(
+				static_cast<uint32_t>(fx0),
+				static_cast<uint32_t>(fy0),
+				static_cast<uint32_t>(fx1),
+				static_cast<uint32_t>(fy1));
+			const CellRect overlap{
+				std::max(hole.x0, fx0 << ChunkShift),
+				std::max(hole.y0, fy0 << ChunkShift),
+				std::min(hole.x1, ((fx1 + 1) << ChunkShift) - 1),
+				std::min(hole.y1, ((fy1 + 1) << ChunkShift) - 1)};
+			const uint32_t overlapCount = hole.empty() ? 0 : countRect(layer, overlap);
+			if (interior > overlapCount)
+			{
+				return true;
+			}
+		}
+
+		// 3. Exact word-level scan of the ring.
+		return bitmap.anyInRing(center, minRange, maxRange);
+	}
+
+	uint32_t GameWorld::countUnitsInRange(CellLayer layer, Position center, uint32_t minRange, uint32_t maxRange) const
+	{
+		if (minRange > maxRange)
+		{
+			return 0;
+		}
+
+		uint32_t total = countRect(layer, clipSquare(center, maxRange));
+		if (minRange > 0)
+		{
+			total -= countRect(layer, clipSquare(center, minRange - 1));
+		}
+		return total;
+	}
+
+	bool GameWorld::isTerrain(Position pos) const
+	{
+		return isValid(pos) && _terrain->test(pos);
+	}
+
+	bool GameWorld::hasTerrain() const
+	{
+		return _terrainCells > 0;
+	}
+
+	bool GameWorld::hasLineOfSight(Position from, Position to) const
+	{
+		if (_terrainCells == 0 || from == to)
+		{
+			return true;
+		}
+
+		// Integer Bresenham walk; both endpoints are excluded
+		int64_t x = from.x;
+		int64_t y = from.y;
+		const int64_t dx = std::abs(static_cast<int64_t>(to.x) - x);
+		const int64_t dy = -std::abs(static_cast<int64_t>(to.y) - y);
+		const int64_t stepX = x < to.x ? 1 : -1;
+		const int64_t stepY = y < to.y ? 1 : -1;
+		int64_t error = dx + dy;
+
+		while (true)
+		{
+			const int64_t doubled = 2 * error;
+			if (doubled >= dy)
+			{
+				error += dy;
+				x += stepX;
+			}
+			if (doubled <= dx)
+			{
+				error += dx;
+				y += stepY;
+			}
+
+			const Position cell{static_cast<uint32_t>(x), static_cast<uint32_t>(y)};
+			if (cell == to)
+			{
+				return true;
+			}
+			if (isTerrain(cell))
+			{
+				return false;
+			}
+		}
+	}
+
+	bool GameWorld::findFlowStep(Position from, Position target, Position& outNext) const
+	{
+		if (!isValid(from) || !isValid(target) || from == target)
+		{
+			return false;
+		}
+
+		return _flowFields.get(target, _layers[layerIndex(CellLayer::Blocker)]).findStep(from, outNext);
+	}
+
+	void GameWorld::syncUnitLayers(UnitId id)
+	{
+		auto& record = _records.at(id);
+		const LayerMask layers = layerBit(CellLayer::Occupied) | record.unit->getLayers();
+		if (layers != record.layers)
+		{
+			adjustCounts(record.pos, record.layers, -1);
+			adjustCounts(record.pos, layers, +1);
+			record.layers = layers;
+			_columns.layers[record.slot] = layers;
+		}
+		syncCellLayers(record.pos);
+		refreshUnitHash(record);
+	}
+
+	void GameWorld::syncUnitState(UnitId id)
+	{
+		refreshUnitHash(_records.at(id));
+	}
+
+	uint64_t GameWorld::getStateHash() const noexcept
+	{
+		return _stateHash;
+	}
+
+	uint64_t GameWorld::computeStateHash() const
+	{
+		uint64_t hash = 0;
+		for (const auto& [id, record] : _records)
+		{
+			hash ^= hashMix(hashMix(id, hashPosition(record.pos)), record.unit->getStateHash());
+		}
+		return hash;
+	}
+
+	void GameWorld::refreshUnitHash(UnitRecord& record)
+	{
+		const uint64_t hash =
+			hashMix(hashMix(record.unit->getId(), hashPosition(record.pos)), record.unit->getStateHash());
+		_stateHash ^= record.hash ^ hash;
+		record.hash = hash;
+	}
+
+	void GameWorld::reserveUnits(size_t count)
+	{
+		_units.reserve(count);
+		_handles.reserve(_handles.size() + count);
+		_records.reserve(_records.size() + count);
+		const size_t columns = _columns.units.size() + count;
+		_columns.x.reserve(columns);
+		_columns.y.reserve(columns);
+		_columns.layers.reserve(columns);
+		_columns.units.reserve(columns);
 	}
 
 	size_t GameWorld::getUnitCount() const noexcept
@@ -119,6 +546,66 @@ namespace sw::core
 		return _units.size();
 	}
 
+	bool GameWorld::hasUnit(UnitId id) const
+	{
+		return _records.contains(id);
+	}
+
+	const RangeQueryStats& GameWorld::getRangeQueryStats() const noexcept
+	{
+		return _rangeStats;
+	}
+
+	void GameWorld::setTerrain(CellBitmap terrain)
+	{
+		if (terrain.getWidth() != _width || terrain.getHeight() != _height)
+		{
+			throw std::invalid_argument("Terrain size does not match the map");
+		}
+
+		_terrain = CowPtr<CellBitmap>::make(std::move(terrain));
+		_terrainCells = _terrain->count();
+
+		// Blocker = terrain | blocker units
+		auto& blockers = _layers[layerIndex(CellLayer::Blocker)];
+		blockers = _terrain.get();
+		for (const auto& [id, record] : _records)
+		{
+			if ((record.layers & layerBit(CellLayer::Blocker)) != 0)
+			{
+				blockers.set(record.pos);
+			}
+		}
+		_flowFields.clear();
+	}
+
+	void GameWorld::addTerrainRect(Position from, Position to)
+	{
+		if (!isValid(from) || !isValid(to))
+		{
+			throw std::out_of_range("Terrain rectangle out of bounds");
+		}
+
+		const uint32_t x0 = std::min(from.x, to.x);
+		const uint32_t y0 = std::min(from.y, to.y);
+		const uint32_t x1 = std::max(from.x, to.x);
+		const uint32_t y1 = std::max(from.y, to.y);
+		_terrain.edit().fillRect(x0, y0, x1, y1);
+		_layers[layerIndex(CellLayer::Blocker)].fillRect(x0, y0, x1, y1);
+		_terrainCells = _terrain->count();
+		_flowFields.clear();
+	}
+
+	const CellBitmap& GameWorld::getTerrain() const noexcept
+	{
+		return _terrain.get();
+	}
+
+	const FlowFieldStats& GameWorld::getFlowFieldStats() const noexcept
+	{
+		return _flowFields.getStats();
+	}
+
 	void GameWorld::moveUnit(UnitId unitId, Position to)
 	{
 		if (!isValid(to))
@@ -126,15 +613,14 @@ namespace sw::core
 			throw std::out_of_range("Move target out of bounds");
 		}
 
-		auto& posRef = _unitPositions.at(unitId);
-		Unit* unitPtr = _unitById.at(unitId);
-		Position from = posRef;
+		auto& record = _records.at(unitId);
+		Position from = record.pos;
 
 		// Update grid
 		// 1. Remove from old
 		size_t fromIndex = getGridIndex(from);
-		auto& oldCell = _grid[fromIndex];
-		auto itGrid = std::find(oldCell.begin(), oldCell.end(), unitPtr);
+		auto& oldCell = _grid.editCell(fromIndex);
+		auto itGrid = std::find(oldCell.begin(), oldCell.end(), record.handle);
 		if (itGrid == oldCell.end())
 		{
 			throw std::runtime_error("GameWorld grid out of sync (unit not found in its current cell)");
@@ -143,10 +629,59 @@ namespace sw::core
 
 		// 2. Add to new
 		size_t toIndex = getGridIndex(to);
-		_grid[toIndex].push_back(unitPtr);
+		_grid.editCell(toIndex).push_back(record.handle);
 
 		// Update position
-		posRef = to;
+		record.pos = to;
+		refreshUnitHash(record);
+		_columns.x[record.slot] = static_cast<int32_t>(to.x);
+		_columns.y[record.slot] = static_cast<int32_t>(to.y);
+
+		if (!sameChunk(from, to))
+		{
+			adjustCounts(from, record.layers, -1);
+			adjustCounts(to, record.layers, +1);
+		}
+		syncCellLayers(from);
+		syncCellLayers(to);
+	}
+
+	Random& GameWorld::getRandom()
+	{
+		return _random;
+	}
+
+	const Random& GameWorld::getRandom() const noexcept
+	{
+		return _random;
+	}
+
+	void GameWorld::restoreCellOrder(Position pos, std::span<const UnitId> order)
+	{
+		if (!isValid(pos))
+		{
+			throw std::out_of_range("Cell out of bounds");
+		}
+
+		const size_t index = getGridIndex(pos);
+		if (order.size() != _grid.cell(index).size())
+		{
+			throw std::invalid_argument("Cell order does not match the units in the cell");
+		}
+
+		CellGrid::Cell reordered;
+		reordered.reserve(order.size());
+		for (const UnitId id : order)
+		{
+			auto it = _records.find(id);
+			if (it == _records.end() || it->second.pos != pos
+				|| std::find(reordered.begin(), reordered.end(), it->second.handle) != reordered.end())
+			{
+				throw std::invalid_argument("Cell order does not match the units in the cell");
+			}
+			reordered.push_back(it->second.handle);
+		}
+		_grid.editCell(index) = std::move(reordered);
 	}
 
 	std::vector<UnitId> GameWorld::removeDeadUnits()
@@ -154,48 +689,278 @@ namespace sw::core
 		std::vector<UnitId> removedIds;
 
 		// First pass: identify dead and cleanup lookups
-		for (const auto& unit : _units)
-		{
-			if (unit->isDead())
+		_units.forEach(
+			[&](Unit& unit)
 			{
-				UnitId unitId = unit->getId();
+				if (!unit.isDead())
+				{
+					return;
+				}
+
+				UnitId unitId = unit.getId();
 				removedIds.push_back(unitId);
 
-				auto pos = _unitPositions.at(unitId);
+				const auto record = _records.at(unitId);
+				const auto pos = record.pos;
 
 				if (isValid(pos))
 				{
 					size_t index = getGridIndex(pos);
-					auto& cell = _grid[index];
-					auto it = std::find(cell.begin(), cell.end(), unit.get());
+					auto& cell = _grid.editCell(index);
+					auto it = std::find(cell.begin(), cell.end(), record.handle);
 					if (it == cell.end())
 					{
 						throw std::runtime_error("GameWorld grid out of sync (dead unit not found in its cell)");
 					}
 					cell.erase(it);
+					_handles[record.handle] = nullptr;
+					adjustCounts(pos, record.layers, -1);
+					syncCellLayers(pos);
 				}
 
-				_unitById.erase(unitId);
-				_unitPositions.erase(unitId);
-			}
-		}
-
-		// Second pass: remove from ownership vector
-		auto it
-			= std::remove_if(_units.begin(), _units.end(), [](const std::unique_ptr<Unit>& u) { return u->isDead(); });
+				_stateHash ^= record.hash;
+				_records.erase(unitId);
+			});
 
-		_units.erase(it, _units.end());
+		// Columns hold raw pointers, so compact them while dead units are still alive.
+		if (!removedIds.empty())
+		{
+			compactColumns();
+			// Second pass: release storage
+			_units.eraseIf([](const Unit& u) { return u.isDead(); });
+		}
 
 		return removedIds;
 	}
 
+	GridLayout GameWorld::getGridLayout() const noexcept
+	{
+		return _indexer.getLayout();
+	}
+
 	size_t GameWorld::getGridIndex(Position pos) const
 	{
-		return static_cast<size_t>(pos.y) * _width + static_cast<size_t>(pos.x);
+		return _indexer.index(pos);
 	}
 
 	bool GameWorld::isValid(Position pos) const
 	{
 		return pos.x < _width && pos.y < _height;
 	}
+
+	void GameWorld::syncCellLayers(Position pos)
+	{
+		const auto& cell = _grid.cell(getGridIndex(pos));
+
+		LayerMask mask = 0;
+		if (!cell.empty())
+		{
+			mask = layerBit(CellLayer::Occupied);
+			for (const auto handle : cell)
+			{
+				mask |= _handles[handle]->getLayers();
+			}
+		}
+
+		if (_terrain->test(pos))
+		{
+			mask |= layerBit(CellLayer::Blocker);
+		}
+
+		auto& blockers = _layers[layerIndex(CellLayer::Blocker)];
+		const bool wasBlocked = blockers.test(pos);
+		for (size_t i = 0; i < CellLayerCount; ++i)
+		{
+			_layers[i].assign(pos, (mask & (1u << i)) != 0);
+		}
+
+		if (blockers.test(pos) != wasBlocked)
+		{
+			_flowFields.noteCellChanged(pos);
+		}
+	}
+
+	void GameWorld::adjustCounts(Position pos, LayerMask layers, int32_t delta)
+	{
+		for (size_t i = 0; i < CellLayerCount; ++i)
+		{
+			if ((layers & (1u << i)) != 0)
+			{
+				_counts[i].add(pos, delta);
+			}
+		}
+	}
+
+	void GameWorld::compactColumns()
+	{
+		// Keeps creation order; slots of survivors shift down past removed entries.
+		size_t write = 0;
+		for (size_t read = 0; read < _columns.units.size(); ++read)
+		{
+			Unit* unit = _columns.units[read];
+			if (unit->isDead())
+			{
+				continue;
+			}
+
+			if (write != read)
+			{
+				_columns.x[write] = _columns.x[read];
+				_columns.y[write] = _columns.y[read];
+				_columns.layers[write] = _columns.layers[read];
+				_columns.units[write] = unit;
+				_records.at(unit->getId()).slot = static_cast<uint32_t>(write);
+			}
+			++write;
+		}
+
+		_columns.x.resize(write);
+		_columns.y.resize(write);
+		_columns.layers.resize(write);
+		_columns.units.resize(write);
+	}
+
+	std::vector<uint32_t> GameWorld::sweepRange(
+		CellLayer layer, Position center, uint32_t minRange, uint32_t maxRange) const
+	{
+		std::vector<uint32_t> slots;
+		if (minRange > maxRange)
+		{
+			return slots;
+		}
+
+		const LayerMask bit = layerBit(layer);
+		const auto cx = static_cast<int32_t>(center.x);
+		const auto cy = static_cast<int32_t>(center.y);
+		const size_t count = _columns.units.size();
+
+		for (size_t base = 0; base < count; base += 64)
+		{
+			uint64_t mask = matchChebyshevBlock(
+				_columns.x.data() + base,
+				_columns.y.data() + base,
+				std::min<size_t>(64, count - base),
+				cx,
+				cy,
+				minRange,
+				maxRange);
+
+			while (mask != 0)
+			{
+				const size_t slot = base + static_cast<size_t>(std::countr_zero(mask));
+				if ((_columns.layers[slot] & bit) != 0)
+				{
+					slots.push_back(static_cast<uint32_t>(slot));
+				}
+				mask &= mask - 1;
+			}
+		}
+
+		// Match the cell scan's row-major order so both strategies hand out candidates identically.
+		std::sort(
+			slots.begin(),
+			slots.end(),
+			[this](uint32_t a, uint32_t b)
+			{
+				if (_columns.y[a] != _columns.y[b])
+				{
+					return _columns.y[a] < _columns.y[b];
+				}
+				return _columns.x[a] < _columns.x[b];
+			});
+
+		// Units sharing a cell follow the cell's list, as in the scan (moves append, so it is not creation order)
+		for (size_t first = 0; first < slots.size();)
+		{
+			size_t last = first + 1;
+			while (last < slots.size() && _columns.x[slots[last]] == _columns.x[slots[first]]
+				   && _columns.y[slots[last]] == _columns.y[slots[first]])
+			{
+				++last;
+			}
+			if (last - first > 1)
+			{
+				const Position pos{
+					static_cast<uint32_t>(_columns.x[slots[first]]), static_cast<uint32_t>(_columns.y[slots[first]])};
+				size_t next = first;
+				for (const auto handle : _grid.cell(getGridIndex(pos)))
+				{
+					const uint32_t slot = _records.at(_handles[handle]->getId()).slot;
+					if ((_columns.layers[slot] & bit) != 0)
+					{
+						slots[next++] = slot;
+					}
+				}
+			}
+			first = last;
+		}
+		return slots;
+	}
+
+	GameWorld::CellRect GameWorld::clipSquare(Position center, uint32_t radius) const
+	{
+		const int64_t r = radius;
+		return CellRect{
+			std::max<int64_t>(0, static_cast<int64_t>(center.x) - r),
+			std::max<int64_t>(0, static_cast<int64_t>(center.y) - r),
+			std::min<int64_t>(static_cast<int64_t>(_width) - 1, static_cast<int64_t>(center.x) + r),
+			std::min<int64_t>(static_cast<int64_t>(_height) - 1, static_cast<int64_t>(center.y) + r)};
+	}
+
+	uint32_t GameWorld::countCellUnits(CellLayer layer, Position pos) const
+	{
+		const auto& cell = _grid.cell(getGridIndex(pos));
+		if (layer == CellLayer::Occupied)
+		{
+			return static_cast<uint32_t>(cell.size());
+		}
+
+		const LayerMask bit = layerBit(layer);
+		return static_cast<uint32_t>(std::count_if(
+			cell.begin(),
+			cell.end(),
+			[&](CellGrid::Handle handle) { return (_handles[handle]->getLayers() & bit) != 0; }));
+	}
+
+	uint32_t GameWorld::countRect(CellLayer layer, const CellRect& rect) const
+	{
+		if (rect.empty())
+		{
+			return 0;
+		}
+
+		uint32_t total = 0;
+		constexpr CellRect noHole{1, 1, 0, 0};
+		auto countCells = [&](const CellRect& part)
+		{
+			forEachLayerCell(layer, part, noHole, [&](Position pos) { total += countCellUnits(layer, pos); });
+		};
+
+		// Whole chunks come from the Fenwick tree; only the ragged border is counted cell by cell.
+		const int64_t fx0 = (rect.x0 + ChunkCounter::ChunkSize - 1) >> ChunkShift;
+		const int64_t fy0 = (rect.y0 + ChunkCounter::ChunkSize - 1) >> ChunkShift;
+		const int64_t fx1 = ((rect.x1 + 1) >> ChunkShift) - 1;
+		const int64_t fy1 = ((rect.y1 + 1) >> ChunkShift) - 1;
+		if (fx0 > fx1 || fy0 > fy1)
+		{
+			countCells(rect);
+			return total;
+		}
+
+		total += _counts[layerIndex(layer)].sumChunks(
+			static_cast<uint32_t>(fx0),
+			static_cast<uint32_t>(fy0),
+			static_cast<uint32_t>(fx1),
+			static_cast<uint32_t>(fy1));
+
+		const int64_t ix0 = fx0 << ChunkShift;
+		const int64_t iy0 = fy0 << ChunkShift;
+		const int64_t ix1 = ((fx1 + 1) << ChunkShift) - 1;
+		const int64_t iy1 = ((fy1 + 1) << ChunkShift) - 1;
+		countCells({rect.x0, rect.y0, rect.x1, iy0 - 1});
+		countCells({rect.x0, iy1 + 1, rect.x1, rect.y1});
+		countCells({rect.x0, iy0, ix0 - 1, iy1});
+		countCells({ix1 + 1, iy0, rect.x1, iy1});
+		return total;
+	}
 }
@@ -1,55 +1,223 @@
 #pragma once
 
+#include "CellBitmap.hpp"
+#include "CellGrid.hpp"
+#include "ChunkCounter.hpp"
+#include "CowPtr.hpp"
+#include "FlowField.hpp"
+#include "GridLayout.hpp"
 #include "IGameWorld.hpp"
+#include "UnitStore.hpp"
 
-#include <functional>
+#include <array>
 #include <memory>
+#include <span>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace sw::core
 {
+	// Number of range queries answered by each strategy; lets callers verify adaptive choices.
+	struct RangeQueryStats
+	{
+		uint64_t cellScans{};
+		uint64_t positionSweeps{};
+	};
+
 	class GameWorld : public IGameWorld
 	{
 	private:
+		struct UnitRecord
+		{
+			Unit* unit;
+			CellGrid::Handle handle;
+			Position pos;
+			// Layers the unit is counted in (always includes CellLayer::Occupied)
+			LayerMask layers;
+			// Index into _columns
+			uint32_t slot;
+			// Contribution to _stateHash
+			uint64_t hash;
+		};
+
+		// Structure-of-arrays mirror of units in creation order, for vectorized position sweeps
+		struct PositionColumns
+		{
+			std::vector<int32_t> x;
+			std::vector<int32_t> y;
+			std::vector<LayerMask> layers;
+			std::vector<Unit*> units;
+		};
+
+		// Inclusive cell rectangle in signed coordinates (already clipped to the map unless stated otherwise)
+		struct CellRect
+		{
+			int64_t x0;
+			int64_t y0;
+			int64_t x1;
+			int64_t y1;
+
+			[[nodiscard]]
+			bool empty() const noexcept
+			{
+				return x0 > x1 || y0 > y1;
+			}
+		};
+
 		uint32_t _width;
 		uint32_t _height;
+		GridIndexer _indexer;
+
+		// Ownership; addresses are stable, so the lookups below hold raw pointers
+		UnitStore _units;
+		// Lookup; grid cells hold handles so forks can share grid chunks
+		CellGrid _grid;
+		// Unit for each grid handle (null once removed); handles are never reused
+		std::vector<Unit*> _handles;
+		std::unordered_map<UnitId, UnitRecord> _records;
+		// Packed per-layer occupancy, kept in sync with _grid on add/move/remove
+		// The Blocker bitmap also carries terrain, so movement checks stay a single bit test
+		std::array<CellBitmap, CellLayerCount> _layers;
+		CowPtr<CellBitmap> _terrain;
+		uint64_t _terrainCells{};
+		// Per-layer unit counts by chunk; answers "how many / any in area" without touching cells
+		std::array<ChunkCounter, CellLayerCount> _counts;
+		PositionColumns _columns;
+		mutable RangeQueryStats _rangeStats;
+		// Built lazily by findFlowStep; fed every Blocker change
+		mutable FlowFieldCache _flowFields;
+		Random _random;
+		// XOR of every unit's record hash, kept current by each mutation
+		uint64_t _stateHash{};
+
+		struct ForkTag
+		{
+		};
 
-		// Ownership
-		std::vector<std::unique_ptr<Unit>> _units;
-		// Lookup
-		std::vector<std::vector<Unit*>> _grid;
-		std::unordered_map<UnitId, Unit*> _unitById;
-		std::unordered_map<UnitId, Position> _unitPositions;
+		GameWorld(GameWorld& parent, ForkTag);
 
 		size_t getGridIndex(Position pos) const;
 		bool isValid(Position pos) const;
+		void syncCellLayers(Position pos);
+		void adjustCounts(Position pos, LayerMask layers, int32_t delta);
+		void compactColumns();
+		void refreshUnitHash(UnitRecord& record);
+
+		CellRect clipSquare(Position center, uint32_t radius) const;
+		uint32_t countCellUnits(CellLayer layer, Position pos) const;
+		uint32_t countRect(CellLayer layer, const CellRect& rect) const;
+
+		// Column slots of units matching the ring, ordered row-major like a cell scan
+		std::vector<uint32_t> sweepRange(CellLayer layer, Position center, uint32_t minRange, uint32_t maxRange) const;
+
+		// Visits set cells of `layer` inside `outer` but outside `hole`, row-major, skipping empty chunks
+		template <typename TVisitor>
+		void forEachLayerCell(CellLayer layer, const CellRect& outer, const CellRect& hole, TVisitor&& visitor) const;
+
+		// Visits set cells of `layer` at Chebyshev distance [minRange, maxRange] from center
+		template <typename TVisitor>
+		void forEachRingCell(
+			CellLayer layer, Position center, uint32_t minRange, uint32_t maxRange, TVisitor&& visitor) const;
 
 	public:
-		GameWorld(uint32_t width, uint32_t height);
+		GameWorld(uint32_t width, uint32_t height, GridLayout layout = GridLayout::RowMajor);
 		~GameWorld() override;
 
 		// --- IGameWorld ---
 		uint32_t getWidth() const override;
 		uint32_t getHeight() const override;
 
-		void forEachUnitAt(Position pos, const std::function<void(const Unit&)>& visitor) const override;
-		void forEachUnitAt(Position pos, const std::function<void(Unit&)>& visitor) override;
-		bool anyUnitAt(Position pos, const std::function<bool(const Unit&)>& predicate) const override;
+		void forEachUnitAt(Position pos, FunctionRef<void(const Unit&)> visitor) const override;
+		void forEachUnitAt(Position pos, FunctionRef<void(Unit&)> visitor) override;
+		bool anyUnitAt(Position pos, FunctionRef<bool(const Unit&)> predicate) const override;
+
+		void forEachUnitInRange(
+			CellLayer layer,
+			Position center,
+			uint32_t minRange,
+			uint32_t maxRange,
+			RangeStrategy strategy,
+			FunctionRef<void(const Unit&)> visitor) const override;
+		void forEachUnitInRange(
+			CellLayer layer,
+			Position center,
+			uint32_t minRange,
+			uint32_t maxRange,
+			RangeStrategy strategy,
+			FunctionRef<void(Unit&)> visitor) override;
 
 		const Unit& getUnitById(UnitId id) const override;
 		Unit& getUnitById(UnitId id) override;
 
 		Position getUnitPosition(UnitId id) const override;
 
+		bool testCell(CellLayer layer, Position pos) const override;
+		bool anyCellInRange(CellLayer layer, Position center, uint32_t minRange, uint32_t maxRange) const override;
+		uint32_t countUnitsInRange(CellLayer layer, Position center, uint32_t minRange, uint32_t maxRange)
+			const override;
+		bool isTerrain(Position pos) const override;
+		bool hasTerrain() const override;
+		bool hasLineOfSight(Position from, Position to) const override;
+		bool findFlowStep(Position from, Position target, Position& outNext) const override;
+		void syncUnitLayers(UnitId id) override;
+		void syncUnitState(UnitId id) override;
+
 		void moveUnit(UnitId unitId, Position to) override;
+		Random& getRandom() override;
 
 		// --- GameWorld API (simulation/orchestration helpers) ---
-		void addUnit(std::unique_ptr<Unit> unit, Position pos);
+		// Takes ownership of the unit and returns it at its final (stable) address
+		Unit& addUnit(Unit unit, Position pos);
+
+		// Presizes the unit tables for `count` more addUnit calls (bulk spawns), so they do not rehash or regrow
+		void reserveUnits(size_t count);
+
+		[[nodiscard]]
+		size_t getUnitCount() const noexcept override;
 
 		[[nodiscard]]
-		size_t getUnitCount() const noexcept;
+		bool hasUnit(UnitId id) const;
+
+		// Reorders the units sharing a cell (the order forEachUnitAt reports them in); for restoring saved worlds.
+		// `order` must list exactly the units currently in the cell.
+		void restoreCellOrder(Position pos, std::span<const UnitId> order);
+
+		[[nodiscard]]
+		const Random& getRandom() const noexcept;
+
+		// Zobrist-style hash of (unit, position, Unit::getStateHash()) over all units, updated incrementally.
+		// Equal worlds hash equally regardless of history; used to find where two runs diverge.
+		[[nodiscard]]
+		uint64_t getStateHash() const noexcept;
+
+		// Recomputes the hash from scratch; matches getStateHash() unless a state change was not synced
+		[[nodiscard]]
+		uint64_t computeStateHash() const;
+
+		// Replaces the terrain layer; the bitmap must match the map size. Intended for setup (drops flow fields).
+		void setTerrain(CellBitmap terrain);
+		// Marks the inclusive rectangle between two corners as terrain
+		void addTerrainRect(Position from, Position to);
+
+		[[nodiscard]]
+		const CellBitmap& getTerrain() const noexcept;
+
+		[[nodiscard]]
+		GridLayout getGridLayout() const noexcept;
+
+		[[nodiscard]]
+		const RangeQueryStats& getRangeQueryStats() const noexcept;
+
+		[[nodiscard]]
+		const FlowFieldStats& getFlowFieldStats() const noexcept;
+
+		// Independent copy of the world for what-if rollouts. Units are copied; the grid (by chunk), terrain and
+		// cached flow fields are shared with this world copy-on-write, so a fork costs memory for what it changes.
+		// The random generator continues the same stream (without a choice tape); reseed the fork for varied rollouts.
+		// Forking writes ownership flags on this world: do not fork while this world is being used concurrently.
+		// Afterwards the parent and all forks may run on different threads.
+		std::unique_ptr<GameWorld> fork();
 
 		// Returns IDs of units removed
 		std::vector<UnitId> removeDeadUnits();
@@ -57,19 +225,13 @@ namespace sw::core
 		template <typename TVisitor>
 		void forEachUnit(TVisitor&& visitor)
 		{
-			for (auto& unit : _units)
-			{
-				visitor(*unit);
-			}
+			_units.forEach(std::forward<TVisitor>(visitor));
 		}
 
 		template <typename TVisitor>
 		void forEachUnit(TVisitor&& visitor) const
 		{
-			for (const auto& unit : _units)
-			{
-				visitor(*unit);
-			}
+			std::as_const(_units).forEach(std::forward<TVisitor>(visitor));
 		}
 	};
 }
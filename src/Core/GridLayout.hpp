@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sw::core
+{
+	// Storage order of the world's cell array.
+	enum class GridLayout : uint8_t
+	{
+		// y * width + x: vertical neighbours are a full row apart
+		RowMajor,
+		// 8x8 tiles stored row-major, cells inside a tile in Z-order (Morton):
+		// a 3x3 neighbourhood spans at most four tiles instead of three map-wide rows
+		Tiled,
+	};
+
+	/// @brief Maps cell positions to storage indices for a GridLayout.
+	class GridIndexer
+	{
+	private:
+		GridLayout _layout{GridLayout::RowMajor};
+		uint32_t _width{};
+		uint32_t _height{};
+		uint32_t _tilesX{};
+		uint32_t _tilesY{};
+
+		// Spreads the low 3 bits of v to bit positions 0, 2, 4
+		static constexpr uint32_t spreadBits3(uint32_t v) noexcept
+		{
+			return (v & 1u) | ((v & 2u) << 1) | ((v & 4u) << 2);
+		}
+
+	public:
+		static constexpr uint32_t TileShift = 3;
+		static constexpr uint32_t TileSize = 1u << TileShift;
+		static constexpr uint32_t TileCells = TileSize * TileSize;
+
+		GridIndexer() = default;
+
+		GridIndexer(uint32_t width, uint32_t height, GridLayout layout) :
+				_layout(layout),
+				_width(width),
+				_height(height),
+				_tilesX((width + TileSize - 1) >> TileShift),
+				_tilesY((height + TileSize - 1) >> TileShift)
+		{}
+
+		[[nodiscard]]
+		GridLayout getLayout() const noexcept
+		{
+			return _layout;
+		}
+
+		// Storage size; tiled layouts pad partial edge tiles.
+		[[nodiscard]]
+		size_t getCellCount() const noexcept
+		{
+			if (_layout == GridLayout::RowMajor)
+			{
+				return static_cast<size_t>(_width) * _height;
+			}
+			return static_cast<size_t>(_tilesX) * _tilesY * TileCells;
+		}
+
+		[[nodiscard]]
+		size_t index(Position pos) const noexcept
+		{
+			if (_layout == GridLayout::RowMajor)
+			{
+				return static_cast<size_t>(pos.y) * _width + pos.x;
+			}
+
+			const size_t tile = static_cast<size_t>(pos.y >> TileShift) * _tilesX + (pos.x >> TileShift);
+			const uint32_t inTile = spreadBits3(pos.x & (TileSize - 1)) | (spreadBits3(pos.y & (TileSize - 1)) << 1);
+			return tile * TileCells + inTile;
+		}
+	};
+}
@@ -5,6 +5,7 @@ namespace sw::core
 	class Unit;
 	class IGameWorld;
 	class IGameEvents;
+	class NullEvents;
 
 	class IBehavior
 	{
@@ -16,5 +17,26 @@ namespace sw::core
 
 		// Executes the behavior
 		virtual void execute(Unit& unit, IGameWorld& world, IGameEvents& events) = 0;
+
+		// Same for runs that discard events: the behavior calls NullEvents' empty handlers directly, so they compile
+		// away instead of costing a virtual call per event
+		virtual void execute(Unit& unit, IGameWorld& world, NullEvents& events) = 0;
+	};
+
+	/// @brief Implements both IBehavior::execute overloads with the derived behavior's
+	/// `template <typename TEvents> void act(Unit&, IGameWorld&, TEvents&)`.
+	template <typename TDerived>
+	class Behavior : public IBehavior
+	{
+	public:
+		void execute(Unit& unit, IGameWorld& world, IGameEvents& events) final
+		{
+			static_cast<TDerived&>(*this).act(unit, world, events);
+		}
+
+		void execute(Unit& unit, IGameWorld& world, NullEvents& events) final
+		{
+			static_cast<TDerived&>(*this).act(unit, world, events);
+		}
 	};
 }
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "FunctionRef.hpp"
+#include "Random.hpp"
 #include "Types.hpp"
 
-#include <functional>
+#include <cstddef>
+
 namespace sw::core
 {
 	class Unit;	 // Forward declaration
@@ -17,18 +20,68 @@ namespace sw::core
 		virtual uint32_t getHeight() const = 0;
 
 		// Unit queries
-		virtual void forEachUnitAt(Position pos, const std::function<void(const Unit&)>& visitor) const = 0;
-		virtual void forEachUnitAt(Position pos, const std::function<void(Unit&)>& visitor) = 0;
+		virtual void forEachUnitAt(Position pos, FunctionRef<void(const Unit&)> visitor) const = 0;
+		virtual void forEachUnitAt(Position pos, FunctionRef<void(Unit&)> visitor) = 0;
 
 		// Returns true if any unit in the cell satisfies predicate
-		virtual bool anyUnitAt(Position pos, const std::function<bool(const Unit&)>& predicate) const = 0;
+		virtual bool anyUnitAt(Position pos, FunctionRef<bool(const Unit&)> predicate) const = 0;
+
+		// Visits units contributing to `layer` at Chebyshev distance [minRange, maxRange] from center.
+		// Every strategy visits the same units in the same order: row-major by cell, then in each cell's list order.
+		virtual void forEachUnitInRange(
+			CellLayer layer,
+			Position center,
+			uint32_t minRange,
+			uint32_t maxRange,
+			RangeStrategy strategy,
+			FunctionRef<void(const Unit&)> visitor) const = 0;
+		virtual void forEachUnitInRange(
+			CellLayer layer,
+			Position center,
+			uint32_t minRange,
+			uint32_t maxRange,
+			RangeStrategy strategy,
+			FunctionRef<void(Unit&)> visitor) = 0;
+
+		// Number of units on the map (a position sweep visits all of them, whatever the layer)
+		virtual size_t getUnitCount() const = 0;
 
 		virtual const Unit& getUnitById(UnitId id) const = 0;
 		virtual Unit& getUnitById(UnitId id) = 0;
 
 		virtual Position getUnitPosition(UnitId id) const = 0;
 
+		// Cell layer queries (see CellLayer). Out-of-bounds cells are reported as empty.
+		virtual bool testCell(CellLayer layer, Position pos) const = 0;
+
+		// Returns true if any cell of `layer` lies at Chebyshev distance [minRange, maxRange] from center
+		virtual bool anyCellInRange(CellLayer layer, Position center, uint32_t minRange, uint32_t maxRange) const = 0;
+
+		// Exact number of units contributing to `layer` at Chebyshev distance [minRange, maxRange] from center
+		virtual uint32_t countUnitsInRange(CellLayer layer, Position center, uint32_t minRange, uint32_t maxRange)
+			const = 0;
+
+		// Static terrain: impassable cells that are not units. Terrain is also reported on CellLayer::Blocker.
+		virtual bool isTerrain(Position pos) const = 0;
+		virtual bool hasTerrain() const = 0;
+
+		// True if the straight (Bresenham) line between the two cells crosses no terrain; endpoints are not tested
+		virtual bool hasLineOfSight(Position from, Position to) const = 0;
+
+		// Next step from `from` toward `target` on a shortest 8-connected path around Blocker cells.
+		// Fields are shared per target and kept current as blockers move; false if no step gets closer.
+		virtual bool findFlowStep(Position from, Position target, Position& outNext) const = 0;
+
+		// Re-reads the unit's layer mask after layer-bearing components were added/removed on a placed unit
+		virtual void syncUnitLayers(UnitId id) = 0;
+
+		// Re-reads the unit's hashed component state (HP, march target, ...) after it changed
+		virtual void syncUnitState(UnitId id) = 0;
+
 		// Actions
 		virtual void moveUnit(UnitId unitId, Position to) = 0;
+
+		// The battle's random source; part of the world state so a saved world replays identically
+		virtual Random& getRandom() = 0;
 	};
 }
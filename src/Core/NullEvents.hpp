@@ -0,0 +1,19 @@
+#pragma once
+
+#include "IGameEvents.hpp"
+
+namespace sw::core
+{
+	// Discards every event; for runs that only need the final world state
+	class NullEvents final : public IGameEvents
+	{
+	public:
+		void onMapCreated(uint32_t, uint32_t) override {}
+		void onUnitSpawned(UnitId, std::string_view, Position) override {}
+		void onMarchStarted(UnitId, Position, Position) override {}
+		void onUnitAttacked(UnitId, UnitId, uint32_t, uint32_t) override {}
+		void onUnitMoved(UnitId, Position, Position) override {}
+		void onUnitDied(UnitId) override {}
+		void onMarchEnded(UnitId, Position) override {}
+	};
+}
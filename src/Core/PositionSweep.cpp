@@ -0,0 +1,80 @@
+#include "PositionSweep.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+	#include <immintrin.h>
+#endif
+
+namespace sw::core
+{
+	uint64_t matchChebyshevBlock(
+		const int32_t* xs,
+		const int32_t* ys,
+		size_t count,
+		int32_t cx,
+		int32_t cy,
+		uint32_t minRange,
+		uint32_t maxRange) noexcept
+	{
+		constexpr uint32_t Limit = static_cast<uint32_t>(std::numeric_limits<int32_t>::max()) - 1;
+		// Strict comparisons against (min - 1) and (max + 1) keep the vector paths to plain cmpgt.
+		const int32_t lowExclusive = static_cast<int32_t>(std::min(minRange, Limit)) - 1;
+		const int32_t highExclusive = static_cast<int32_t>(std::min(maxRange, Limit)) + 1;
+
+		uint64_t mask = 0;
+		size_t i = 0;
+
+#if defined(__AVX2__)
+		const __m256i vcx = _mm256_set1_epi32(cx);
+		const __m256i vcy = _mm256_set1_epi32(cy);
+		const __m256i vlow = _mm256_set1_epi32(lowExclusive);
+		const __m256i vhigh = _mm256_set1_epi32(highExclusive);
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i dx = _mm256_abs_epi32(
+				_mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(xs + i)), vcx));
+			const __m256i dy = _mm256_abs_epi32(
+				_mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ys + i)), vcy));
+			const __m256i dist = _mm256_max_epi32(dx, dy);
+			const __m256i inside = _mm256_and_si256(_mm256_cmpgt_epi32(dist, vlow), _mm256_cmpgt_epi32(vhigh, dist));
+			const auto bits = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(inside)));
+			mask |= static_cast<uint64_t>(bits) << i;
+		}
+#elif defined(__SSE2__) || defined(_M_X64)
+		// SSE2 has no abs/max for 32-bit lanes; emulate both with shifts and compare-select.
+		const __m128i vcx = _mm_set1_epi32(cx);
+		const __m128i vcy = _mm_set1_epi32(cy);
+		const __m128i vlow = _mm_set1_epi32(lowExclusive);
+		const __m128i vhigh = _mm_set1_epi32(highExclusive);
+		auto absDiff = [](__m128i value, __m128i center)
+		{
+			const __m128i diff = _mm_sub_epi32(value, center);
+			const __m128i sign = _mm_srai_epi32(diff, 31);
+			return _mm_sub_epi32(_mm_xor_si128(diff, sign), sign);
+		};
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i dx = absDiff(_mm_loadu_si128(reinterpret_cast<const __m128i*>(xs + i)), vcx);
+			const __m128i dy = absDiff(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ys + i)), vcy);
+			const __m128i xGreater = _mm_cmpgt_epi32(dx, dy);
+			const __m128i dist = _mm_or_si128(_mm_and_si128(xGreater, dx), _mm_andnot_si128(xGreater, dy));
+			const __m128i inside = _mm_and_si128(_mm_cmpgt_epi32(dist, vlow), _mm_cmpgt_epi32(vhigh, dist));
+			const auto bits = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(inside)));
+			mask |= static_cast<uint64_t>(bits) << i;
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			const int32_t dx = xs[i] > cx ? xs[i] - cx : cx - xs[i];
+			const int32_t dy = ys[i] > cy ? ys[i] - cy : cy - ys[i];
+			const int32_t dist = std::max(dx, dy);
+			const bool inside = dist > lowExclusive && dist < highExclusive;
+			mask |= static_cast<uint64_t>(inside) << i;
+		}
+
+		return mask;
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sw::core
+{
+	// Chebyshev-ring test over a structure-of-arrays block of positions.
+	// Returns a bitmask where bit i is set iff max(|xs[i] - cx|, |ys[i] - cy|) lies in [minRange, maxRange].
+	// `count` must not exceed 64; ranges above INT32_MAX - 1 are clamped.
+	[[nodiscard]]
+	uint64_t matchChebyshevBlock(
+		const int32_t* xs,
+		const int32_t* ys,
+		size_t count,
+		int32_t cx,
+		int32_t cy,
+		uint32_t minRange,
+		uint32_t maxRange) noexcept;
+}
@@ -1,31 +1,138 @@
 #pragma once
 
-#include <random>
+#include <array>
+#include <bit>
+#include <cstdint>
 #include <stdexcept>
 #include <vector>
 
 namespace sw::core
 {
+	class Random;
+
+	/// @brief Takes over the choices of Random::getItem, e.g. to record a battle's decisions or replay them.
+	class IChoiceTape
+	{
+	public:
+		virtual ~IChoiceTape() = default;
+
+		// Index in [0, count) for one getItem call, which does not check it again; `random` can draw it as usual
+		virtual uint64_t choose(uint64_t count, Random& random) = 0;
+	};
+
+	/// @brief Seedable xoshiro256** generator owned by the world.
+	/// The whole state is four words, so it can be saved and restored to replay a battle exactly.
 	class Random
 	{
 	public:
+		using State = std::array<uint64_t, 4>;
+
+		static constexpr uint64_t DefaultSeed = 0x5eed'ba77'1e00'0001ull;
+
+	private:
+		State _state{};
+		// Not part of the state: a restored generator keeps its tape
+		IChoiceTape* _tape{};
+
+		// Low word of a * b, high word in `high`; portable where unsigned __int128 is not (MSVC)
+		static uint64_t multiplyWide(uint64_t a, uint64_t b, uint64_t& high) noexcept
+		{
+			constexpr uint64_t LowMask = 0xffff'ffffu;
+			const uint64_t lowLow = (a & LowMask) * (b & LowMask);
+			const uint64_t highLow = (a >> 32) * (b & LowMask);
+			const uint64_t lowHigh = (a & LowMask) * (b >> 32);
+			// Cannot overflow: lowHigh <= (2^32 - 1)^2 and the other two terms are below 2^32
+			const uint64_t cross = (lowLow >> 32) + (highLow & LowMask) + lowHigh;
+			high = (a >> 32) * (b >> 32) + (highLow >> 32) + (cross >> 32);
+			return (cross << 32) | (lowLow & LowMask);
+		}
+
+	public:
+		explicit Random(uint64_t seed = DefaultSeed)
+		{
+			reseed(seed);
+		}
+
+		// Expands the seed with splitmix64, as recommended for xoshiro
+		void reseed(uint64_t seed) noexcept
+		{
+			for (auto& word : _state)
+			{
+				seed += 0x9e37'79b9'7f4a'7c15ull;
+				uint64_t z = seed;
+				z = (z ^ (z >> 30)) * 0xbf58'476d'1ce4'e5b9ull;
+				z = (z ^ (z >> 27)) * 0x94d0'49bb'1331'11ebull;
+				word = z ^ (z >> 31);
+			}
+		}
+
+		[[nodiscard]]
+		const State& getState() const noexcept
+		{
+			return _state;
+		}
+
+		void setState(const State& state)
+		{
+			if (state == State{})
+			{
+				throw std::invalid_argument("Random: all-zero state");
+			}
+			_state = state;
+		}
+
+		// Routes getItem choices through `tape` (nullptr draws them directly); the tape must outlive its use
+		void setChoiceTape(IChoiceTape* tape) noexcept
+		{
+			_tape = tape;
+		}
+
+		uint64_t next() noexcept
+		{
+			const uint64_t result = std::rotl(_state[1] * 5, 7) * 9;
+			const uint64_t t = _state[1] << 17;
+			_state[2] ^= _state[0];
+			_state[3] ^= _state[1];
+			_state[1] ^= _state[2];
+			_state[0] ^= _state[3];
+			_state[2] ^= t;
+			_state[3] = std::rotl(_state[3], 45);
+			return result;
+		}
+
+		// Uniform value in [0, bound) (Lemire's multiply-and-reject); bound must be positive
+		uint64_t nextBelow(uint64_t bound) noexcept
+		{
+			uint64_t high{};
+			uint64_t low = multiplyWide(next(), bound, high);
+			if (low < bound)
+			{
+				const uint64_t threshold = -bound % bound;
+				while (low < threshold)
+				{
+					low = multiplyWide(next(), bound, high);
+				}
+			}
+			return high;
+		}
+
 		template <typename T>
-		static const T& getItem(const std::vector<T>& items)
+		const T& getItem(const std::vector<T>& items)
 		{
 			if (items.empty())
 			{
 				throw std::runtime_error("Cannot get random item from empty collection");
 			}
 
-			static std::random_device rd;
-			static std::mt19937 gen(rd());
-			std::uniform_int_distribution<size_t> dis(0, items.size() - 1);
-
-			return items[dis(gen)];
+			if (_tape)
+			{
+				return items[_tape->choose(items.size(), *this)];
+			}
+			return items[nextBelow(items.size())];
 		}
 
 		// Prevent returning a reference to an element of a temporary vector.
 		template <typename T>
-		static const T& getItem(std::vector<T>&&) = delete;
+		const T& getItem(std::vector<T>&&) = delete;
 	};
 }
@@ -0,0 +1,275 @@
+#include "Snapshot.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+
+namespace sw::core
+{
+	namespace
+	{
+		constexpr char Magic[8] = {'S', 'W', 'S', 'N', 'A', 'P', '0', '1'};
+		constexpr uint32_t Version = 1;
+
+		// Per-unit flags
+		constexpr uint8_t UnitDead = 1;
+
+		void writeTag(SnapshotWriter& writer, const std::string& tag)
+		{
+			writer.write(static_cast<uint16_t>(tag.size()));
+			writer.writeBytes(std::as_bytes(std::span(tag.data(), tag.size())));
+		}
+
+		std::string readTag(SnapshotReader& reader)
+		{
+			const auto length = reader.read<uint16_t>();
+			const auto bytes = reader.readBytes(length);
+			return std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+		}
+
+		// Maps the tag table stored in a snapshot onto the registry, so registration order may change between builds
+		template <typename TType>
+		std::vector<const TType*> readTypeTable(SnapshotReader& reader, const std::vector<TType>& known)
+		{
+			std::vector<const TType*> table(reader.read<uint16_t>());
+			for (auto& entry : table)
+			{
+				const std::string tag = readTag(reader);
+				for (const auto& type : known)
+				{
+					if (type.tag == tag)
+					{
+						entry = &type;
+						break;
+					}
+				}
+
+				if (!entry)
+				{
+					throw std::runtime_error("Snapshot uses an unknown type: " + tag);
+				}
+			}
+			return table;
+		}
+	}
+
+	std::vector<std::byte> saveSnapshot(const GameWorld& world, uint64_t tick, const SnapshotTypes& types)
+	{
+		const auto& componentTypes = types.getComponentTypes();
+		const auto& behaviorTypes = types.getBehaviorTypes();
+		const auto terrain = world.getTerrain().words();
+
+		std::vector<std::byte> bytes;
+		bytes.reserve(64 + terrain.size_bytes() + world.getUnitCount() * 64);
+		SnapshotWriter writer(bytes);
+
+		writer.writeBytes(std::as_bytes(std::span(Magic)));
+		writer.write(Version);
+		writer.write(tick);
+		writer.write(world.getWidth());
+		writer.write(world.getHeight());
+		writer.write(static_cast<uint8_t>(world.getGridLayout()));
+		writer.write(world.getRandom().getState());
+		writer.writeBytes(std::as_bytes(terrain));
+
+		writer.write(static_cast<uint16_t>(componentTypes.size()));
+		for (const auto& type : componentTypes)
+		{
+			writeTag(writer, type.tag);
+		}
+		writer.write(static_cast<uint16_t>(behaviorTypes.size()));
+		for (const auto& type : behaviorTypes)
+		{
+			writeTag(writer, type.tag);
+		}
+
+		std::unordered_map<std::type_index, uint16_t> behaviorIndex;
+		for (size_t i = 0; i < behaviorTypes.size(); ++i)
+		{
+			behaviorIndex.emplace(behaviorTypes[i].type, static_cast<uint16_t>(i));
+		}
+
+		// Cells holding several units, keyed by their first unit; restored after all units are placed
+		std::vector<std::pair<Position, std::vector<UnitId>>> stacks;
+
+		writer.write(static_cast<uint32_t>(world.getUnitCount()));
+		world.forEachUnit(
+			[&](const Unit& unit)
+			{
+				const Position pos = world.getUnitPosition(unit.getId());
+				writer.write(unit.getId());
+				writer.write(pos.x);
+				writer.write(pos.y);
+				writer.write(static_cast<uint8_t>(unit.isDead() ? UnitDead : 0));
+
+				uint16_t componentCount = 0;
+				for (const auto& type : componentTypes)
+				{
+					componentCount += type.has(unit) ? 1 : 0;
+				}
+				if (componentCount != unit.getComponentCount())
+				{
+					throw std::runtime_error(
+						"Unit " + std::to_string(unit.getId()) + " has a component not registered for snapshots");
+				}
+
+				writer.write(componentCount);
+				for (size_t i = 0; i < componentTypes.size(); ++i)
+				{
+					if (componentTypes[i].has(unit))
+					{
+						writer.write(static_cast<uint16_t>(i));
+						componentTypes[i].save(unit, writer);
+					}
+				}
+
+				std::vector<uint16_t> behaviors;
+				unit.forEachBehavior(
+					[&](const IBehavior& behavior)
+					{
+						auto it = behaviorIndex.find(std::type_index(typeid(behavior)));
+						if (it == behaviorIndex.end())
+						{
+							throw std::runtime_error(
+								"Unit " + std::to_string(unit.getId())
+								+ " has a behavior not registered for snapshots");
+						}
+						behaviors.push_back(it->second);
+					});
+				writer.write(static_cast<uint16_t>(behaviors.size()));
+				for (const auto behavior : behaviors)
+				{
+					writer.write(behavior);
+				}
+
+				std::vector<UnitId> cell;
+				world.forEachUnitAt(pos, [&](const Unit& other) { cell.push_back(other.getId()); });
+				if (cell.size() > 1 && cell.front() == unit.getId())
+				{
+					stacks.emplace_back(pos, std::move(cell));
+				}
+			});
+
+		writer.write(static_cast<uint32_t>(stacks.size()));
+		for (const auto& [pos, ids] : stacks)
+		{
+			writer.write(pos.x);
+			writer.write(pos.y);
+			writer.write(static_cast<uint32_t>(ids.size()));
+			writer.writeBytes(std::as_bytes(std::span(ids)));
+		}
+
+		return bytes;
+	}
+
+	WorldSnapshot loadSnapshot(std::span<const std::byte> bytes, const SnapshotTypes& types)
+	{
+		SnapshotReader reader(bytes);
+		if (std::memcmp(reader.readBytes(sizeof(Magic)).data(), Magic, sizeof(Magic)) != 0)
+		{
+			throw std::runtime_error("Not a snapshot");
+		}
+		if (const auto version = reader.read<uint32_t>(); version != Version)
+		{
+			throw std::runtime_error("Unsupported snapshot version " + std::to_string(version));
+		}
+
+		WorldSnapshot snapshot;
+		snapshot.tick = reader.read<uint64_t>();
+		const auto width = reader.read<uint32_t>();
+		const auto height = reader.read<uint32_t>();
+		const auto layout = reader.read<uint8_t>();
+		if (layout > static_cast<uint8_t>(GridLayout::Tiled))
+		{
+			throw std::runtime_error("Snapshot has an unknown grid layout");
+		}
+		const auto randomState = reader.read<Random::State>();
+
+		// The terrain bitmap follows; a header the payload cannot back is rejected before the world is allocated
+		const uint64_t rowWords = (uint64_t{width} + 63) / 64;
+		const uint64_t payloadWords = reader.remaining() / sizeof(uint64_t);
+		if (height != 0 && rowWords > payloadWords / height)
+		{
+			throw std::runtime_error("Snapshot map size does not fit its payload");
+		}
+
+		auto world = std::make_unique<GameWorld>(width, height, static_cast<GridLayout>(layout));
+		world->getRandom().setState(randomState);
+
+		CellBitmap terrain(width, height);
+		const auto words = terrain.words();
+		std::memcpy(words.data(), reader.readBytes(words.size_bytes()).data(), words.size_bytes());
+		terrain.clearPadding();
+		if (terrain.count() != 0)
+		{
+			world->setTerrain(std::move(terrain));
+		}
+
+		const auto componentTable = readTypeTable(reader, types.getComponentTypes());
+		const auto behaviorTable = readTypeTable(reader, types.getBehaviorTypes());
+
+		const auto unitCount = reader.read<uint32_t>();
+		for (uint32_t i = 0; i < unitCount; ++i)
+		{
+			Unit unit(reader.read<UnitId>());
+			Position pos;
+			pos.x = reader.read<Coordinate>();
+			pos.y = reader.read<Coordinate>();
+			unit.setDead((reader.read<uint8_t>() & UnitDead) != 0);
+
+			const auto componentCount = reader.read<uint16_t>();
+			for (uint16_t c = 0; c < componentCount; ++c)
+			{
+				const auto type = reader.read<uint16_t>();
+				if (type >= componentTable.size())
+				{
+					throw std::runtime_error("Snapshot has an invalid component type");
+				}
+				componentTable[type]->load(unit, reader);
+			}
+
+			const auto behaviorCount = reader.read<uint16_t>();
+			for (uint16_t b = 0; b < behaviorCount; ++b)
+			{
+				const auto type = reader.read<uint16_t>();
+				if (type >= behaviorTable.size())
+				{
+					throw std::runtime_error("Snapshot has an invalid behavior type");
+				}
+				unit.addBehavior(behaviorTable[type]->create());
+			}
+
+			world->addUnit(std::move(unit), pos);
+		}
+
+		const auto stackCount = reader.read<uint32_t>();
+		std::vector<UnitId> ids;
+		for (uint32_t i = 0; i < stackCount; ++i)
+		{
+			Position pos;
+			pos.x = reader.read<Coordinate>();
+			pos.y = reader.read<Coordinate>();
+			const auto count = reader.read<uint32_t>();
+			if (count > reader.remaining() / sizeof(UnitId))
+			{
+				throw std::runtime_error("Snapshot is truncated");
+			}
+			ids.resize(count);
+			for (auto& id : ids)
+			{
+				id = reader.read<UnitId>();
+			}
+			world->restoreCellOrder(pos, ids);
+		}
+
+		if (reader.remaining() != 0)
+		{
+			throw std::runtime_error("Snapshot has trailing data");
+		}
+
+		snapshot.world = std::move(world);
+		return snapshot;
+	}
+}
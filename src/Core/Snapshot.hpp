@@ -0,0 +1,29 @@
+#pragma once
+
+#include "GameWorld.hpp"
+#include "SnapshotTypes.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace sw::core
+{
+	struct WorldSnapshot
+	{
+		std::unique_ptr<GameWorld> world;
+		// Next tick to play
+		uint64_t tick{};
+	};
+
+	// Versioned binary image of a world between ticks: map and terrain, units in creation order with every
+	// component's state, behaviors, the order of units sharing a cell, and the random generator state.
+	// Flow fields and query statistics are derived data and are not stored.
+	// Throws std::runtime_error if a unit holds a component or behavior that `types` does not list.
+	std::vector<std::byte> saveSnapshot(const GameWorld& world, uint64_t tick, const SnapshotTypes& types);
+
+	// Rebuilds the world saved by saveSnapshot; throws std::runtime_error on malformed or unknown data.
+	WorldSnapshot loadSnapshot(std::span<const std::byte> bytes, const SnapshotTypes& types);
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "IBehavior.hpp"
+#include "Unit.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
+namespace sw::core
+{
+	static_assert(std::endian::native == std::endian::little, "Snapshots store fields by direct copy");
+
+	// Appends fixed-size little-endian fields; components serialize through the same `visit` protocol as IO DTOs.
+	class SnapshotWriter
+	{
+	private:
+		std::vector<std::byte>& _bytes;
+
+	public:
+		explicit SnapshotWriter(std::vector<std::byte>& bytes) :
+				_bytes(bytes)
+		{}
+
+		template <typename T>
+			requires std::is_trivially_copyable_v<T>
+		void write(const T& value)
+		{
+			const auto* raw = reinterpret_cast<const std::byte*>(&value);
+			_bytes.insert(_bytes.end(), raw, raw + sizeof(T));
+		}
+
+		void writeBytes(std::span<const std::byte> bytes)
+		{
+			_bytes.insert(_bytes.end(), bytes.begin(), bytes.end());
+		}
+
+		template <typename T>
+		void visit(const char* /*name*/, const T& value)
+		{
+			write(value);
+		}
+
+		void visit(const char* /*name*/, const std::string& value)
+		{
+			write(static_cast<uint32_t>(value.size()));
+			writeBytes(std::as_bytes(std::span(value.data(), value.size())));
+		}
+	};
+
+	// Reads what SnapshotWriter wrote; throws std::runtime_error instead of reading past the end.
+	class SnapshotReader
+	{
+	private:
+		std::span<const std::byte> _bytes;
+		size_t _offset{};
+
+	public:
+		explicit SnapshotReader(std::span<const std::byte> bytes) :
+				_bytes(bytes)
+		{}
+
+		[[nodiscard]]
+		size_t remaining() const noexcept
+		{
+			return _bytes.size() - _offset;
+		}
+
+		std::span<const std::byte> readBytes(size_t count)
+		{
+			if (count > remaining())
+			{
+				throw std::runtime_error("Snapshot is truncated");
+			}
+			auto bytes = _bytes.subspan(_offset, count);
+			_offset += count;
+			return bytes;
+		}
+
+		template <typename T>
+			requires std::is_trivially_copyable_v<T>
+		T read()
+		{
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				// Any byte other than 0 or 1 is not a valid bool, so check it before converting
+				const auto byte = read<uint8_t>();
+				if (byte > 1)
+				{
+					throw std::runtime_error("Snapshot has an invalid bool");
+				}
+				return byte == 1;
+			}
+			else
+			{
+				T value;
+				std::memcpy(&value, readBytes(sizeof(T)).data(), sizeof(T));
+				return value;
+			}
+		}
+
+		template <typename T>
+		void visit(const char* /*name*/, T& value)
+		{
+			value = read<T>();
+		}
+
+		void visit(const char* /*name*/, std::string& value)
+		{
+			const auto bytes = readBytes(read<uint32_t>());
+			value.assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+		}
+	};
+
+	/// @brief Component and behavior types a snapshot can contain, each under a stable tag.
+	/// Components must be default constructible and expose their state through `visit(visitor)` (marker components
+	/// may omit it); behaviors must be stateless and default constructible.
+	class SnapshotTypes
+	{
+	public:
+		struct ComponentType
+		{
+			std::string tag;
+			bool (*has)(const Unit&);
+			void (*save)(const Unit&, SnapshotWriter&);
+			void (*load)(Unit&, SnapshotReader&);
+		};
+
+		struct BehaviorType
+		{
+			std::string tag;
+			std::type_index type;
+			std::unique_ptr<IBehavior> (*create)();
+		};
+
+	private:
+		std::vector<ComponentType> _components;
+		std::vector<BehaviorType> _behaviors;
+
+		template <typename T, typename TVisitor>
+		static void visitFields(T& component, TVisitor& visitor)
+		{
+			if constexpr (requires { component.visit(visitor); })
+			{
+				component.visit(visitor);
+			}
+		}
+
+	public:
+		template <typename T>
+		SnapshotTypes& addComponent(std::string tag)
+		{
+			_components.push_back(ComponentType{
+				std::move(tag),
+				[](const Unit& unit) { return unit.getComponent<T>() != nullptr; },
+				[](const Unit& unit, SnapshotWriter& writer)
+				{
+					// `visit` is shared with loading and therefore non-const; fields are read from a copy
+					T component = *unit.getComponent<T>();
+					visitFields(component, writer);
+				},
+				[](Unit& unit, SnapshotReader& reader)
+				{
+					T component;
+					visitFields(component, reader);
+					unit.addComponent<T>(std::move(component));
+				}});
+			return *this;
+		}
+
+		template <typename T>
+		SnapshotTypes& addBehavior(std::string tag)
+		{
+			_behaviors.push_back(BehaviorType{
+				std::move(tag),
+				std::type_index(typeid(T)),
+				[]() -> std::unique_ptr<IBehavior> { return std::make_unique<T>(); }});
+			return *this;
+		}
+
+		[[nodiscard]]
+		const std::vector<ComponentType>& getComponentTypes() const noexcept
+		{
+			return _components;
+		}
+
+		[[nodiscard]]
+		const std::vector<BehaviorType>& getBehaviorTypes() const noexcept
+		{
+			return _behaviors;
+		}
+	};
+}
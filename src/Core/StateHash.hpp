@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <cstdint>
+
+namespace sw::core
+{
+	// Order-sensitive mix of two words (splitmix64 finalizer); building block of the world state hash.
+	// The values are part of hash traces compared across builds: do not change them.
+	constexpr uint64_t hashMix(uint64_t seed, uint64_t value) noexcept
+	{
+		uint64_t z = seed ^ (value + 0x9e37'79b9'7f4a'7c15ull + (seed << 6) + (seed >> 2));
+		z = (z ^ (z >> 30)) * 0xbf58'476d'1ce4'e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d0'49bb'1331'11ebull;
+		return z ^ (z >> 31);
+	}
+
+	constexpr uint64_t hashPosition(Position pos) noexcept
+	{
+		return (static_cast<uint64_t>(pos.x) << 32) | pos.y;
+	}
+}
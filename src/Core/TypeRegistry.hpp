@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <concepts>
 #include <memory>
 #include <stdexcept>
@@ -17,10 +18,15 @@ namespace sw::core
 	class TypeRegistry
 	{
 	private:
+		using CopyFn = std::shared_ptr<void> (*)(const std::shared_ptr<void>&);
+
 		struct Entry
 		{
 			std::shared_ptr<void> instance;
 			std::type_index owner;
+			// Concrete entries: deep copy of the instance (null if T is not copyable).
+			// Alias entries: the interface view of the owner's copy.
+			CopyFn copy{};
 		};
 
 		std::unordered_map<std::type_index, Entry> _instances;
@@ -70,7 +76,13 @@ namespace sw::core
 			// CRITICAL: Store shared_ptr<Interface> erased to void.
 			// This ensures the void* points to the Interface subobject, not the Concrete object start.
 			std::shared_ptr<Interface> interfacePtr = instance;
-			_instances.insert_or_assign(aliasType, Entry{interfacePtr, owner});
+			_instances.insert_or_assign(
+				aliasType,
+				Entry{
+					interfacePtr,
+					owner,
+					[](const std::shared_ptr<void>& ownerCopy) -> std::shared_ptr<void>
+					{ return std::shared_ptr<Interface>(std::static_pointer_cast<T>(ownerCopy)); }});
 		}
 
 	public:
@@ -110,7 +122,13 @@ namespace sw::core
 			removeAliases(ownerType);
 
 			// 3. Register concrete type
-			_instances.insert_or_assign(ownerType, Entry{instance, ownerType});
+			CopyFn copy = nullptr;
+			if constexpr (std::is_copy_constructible_v<T>)
+			{
+				copy = [](const std::shared_ptr<void>& source) -> std::shared_ptr<void>
+				{ return std::make_shared<T>(*std::static_pointer_cast<const T>(source)); };
+			}
+			_instances.insert_or_assign(ownerType, Entry{instance, ownerType, copy});
 
 			// 4. Register interfaces
 			if constexpr (sizeof...(Interfaces) > 0)
@@ -167,6 +185,49 @@ namespace sw::core
 			return _instances.contains(typeIndex<T>());
 		}
 
+		// Deep copy: every instance is copied, and interface aliases point into the copies.
+		// Throws std::logic_error if a registered type is not copy constructible.
+		[[nodiscard]]
+		TypeRegistry clone() const
+		{
+			TypeRegistry copy;
+			copy._aliases = _aliases;
+			for (const auto& [type, entry] : _instances)
+			{
+				if (type != entry.owner)
+				{
+					continue;
+				}
+
+				if (!entry.copy)
+				{
+					throw std::logic_error(
+						std::string("TypeRegistry::clone: '") + type.name() + "' is not copy constructible");
+				}
+				copy._instances.insert_or_assign(type, Entry{entry.copy(entry.instance), type, entry.copy});
+			}
+
+			for (const auto& [type, entry] : _instances)
+			{
+				if (type != entry.owner)
+				{
+					const auto& owner = copy._instances.at(entry.owner);
+					copy._instances.insert_or_assign(type, Entry{entry.copy(owner.instance), entry.owner, entry.copy});
+				}
+			}
+			return copy;
+		}
+
+		// Number of registered concrete types (interface aliases are not counted)
+		[[nodiscard]]
+		size_t size() const noexcept
+		{
+			return static_cast<size_t>(std::count_if(
+				_instances.begin(),
+				_instances.end(),
+				[](const auto& item) { return item.first == item.second.owner; }));
+		}
+
 		template <typename T>
 		void remove()
 		{
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace sw::core
@@ -22,4 +23,29 @@ namespace sw::core
 			return !(*this == other);
 		}
 	};
+
+	// Per-cell layers tracked by the world as packed bitmaps.
+	// `Occupied` is maintained for every unit; the other layers are contributed by components (see Unit::getLayers).
+	enum class CellLayer : uint8_t
+	{
+		Occupied,
+		Blocker,
+		Targetable,
+	};
+
+	inline constexpr size_t CellLayerCount = 3;
+
+	using LayerMask = uint8_t;
+
+	constexpr LayerMask layerBit(CellLayer layer) noexcept
+	{
+		return static_cast<LayerMask>(1u << static_cast<uint8_t>(layer));
+	}
+
+	// How a range query walks the world: cell bitmaps around the center, or a linear sweep over unit positions.
+	enum class RangeStrategy : uint8_t
+	{
+		CellScan,
+		PositionSweep,
+	};
 }
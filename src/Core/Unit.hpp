@@ -5,6 +5,7 @@
 #include "TypeRegistry.hpp"
 #include "Types.hpp"
 
+#include <array>
 #include <memory>
 #include <stdexcept>
 #include <type_traits>
@@ -13,6 +14,7 @@
 
 namespace sw::core
 {
+	// Plain value type: unit kinds are built by factories that attach components and behaviors.
 	class Unit
 	{
 	private:
@@ -20,14 +22,64 @@ namespace sw::core
 		bool _isDead{false};
 
 		TypeRegistry _components;
-		std::vector<std::unique_ptr<IBehavior>> _behaviors;
+		// Behaviors are stateless and shared by clones
+		std::vector<std::shared_ptr<IBehavior>> _behaviors;
+
+		// Number of attached components contributing to each CellLayer.
+		std::array<uint8_t, CellLayerCount> _layerRefs{};
+
+		// State hashes of attached components that define `uint64_t hashState() const`
+		using StateHasher = uint64_t (*)(const Unit&);
+		std::vector<StateHasher> _stateHashers;
+
+		// Components opt into world cell layers via `static constexpr core::LayerMask Layers`.
+		template <typename T>
+		static constexpr LayerMask componentLayers() noexcept
+		{
+			if constexpr (requires { T::Layers; })
+			{
+				return T::Layers;
+			}
+			else
+			{
+				return 0;
+			}
+		}
+
+		template <typename T>
+		static uint64_t hashComponentState(const Unit& unit)
+		{
+			return unit.getComponent<T>()->hashState();
+		}
+
+		void adjustLayerRefs(LayerMask layers, int delta) noexcept
+		{
+			for (size_t i = 0; i < CellLayerCount; ++i)
+			{
+				if (layers & (1u << i))
+				{
+					_layerRefs[i] = static_cast<uint8_t>(_layerRefs[i] + delta);
+				}
+			}
+		}
 
 	public:
 		explicit Unit(UnitId id) :
 				_id(id)
 		{}
 
-		virtual ~Unit() = default;
+		// Independent copy of the unit's components; behaviors are shared, as they must not hold state.
+		[[nodiscard]]
+		Unit clone() const
+		{
+			Unit copy(_id);
+			copy._isDead = _isDead;
+			copy._components = _components.clone();
+			copy._behaviors = _behaviors;
+			copy._layerRefs = _layerRefs;
+			copy._stateHashers = _stateHashers;
+			return copy;
+		}
 
 		[[nodiscard]]
 		UnitId getId() const noexcept
@@ -41,7 +93,16 @@ namespace sw::core
 		T& addComponent(Args&&... args)
 		{
 			static_assert(std::is_base_of_v<IComponent, T>, "Component must inherit from IComponent");
+			const bool replacing = _components.contains<T>();
 			auto ptr = _components.emplace<T>(std::forward<Args>(args)...);
+			if (!replacing)
+			{
+				adjustLayerRefs(componentLayers<T>(), +1);
+				if constexpr (requires(const T& component) { component.hashState(); })
+				{
+					_stateHashers.push_back(&hashComponentState<T>);
+				}
+			}
 			return *ptr;
 		}
 
@@ -57,10 +118,53 @@ namespace sw::core
 			return _components.getPtr<T>();
 		}
 
+		// Note: once the unit is placed, changing layer-bearing components requires IGameWorld::syncUnitLayers.
 		template <typename T>
 		void removeComponent()
 		{
-			_components.remove<T>();
+			if (_components.contains<T>())
+			{
+				_components.remove<T>();
+				adjustLayerRefs(componentLayers<T>(), -1);
+				if constexpr (requires(const T& component) { component.hashState(); })
+				{
+					std::erase(_stateHashers, &hashComponentState<T>);
+				}
+			}
+		}
+
+		[[nodiscard]]
+		size_t getComponentCount() const noexcept
+		{
+			return _components.size();
+		}
+
+		// Combined hashState() of the attached components (0 without any); independent of attachment order.
+		// Once the unit is placed, changes to hashed state must be followed by IGameWorld::syncUnitState.
+		[[nodiscard]]
+		uint64_t getStateHash() const
+		{
+			uint64_t hash = 0;
+			for (const auto hasher : _stateHashers)
+			{
+				hash ^= hasher(*this);
+			}
+			return hash;
+		}
+
+		// Cell layers this unit contributes to (excluding CellLayer::Occupied, which the world sets for every unit).
+		[[nodiscard]]
+		LayerMask getLayers() const noexcept
+		{
+			LayerMask mask = 0;
+			for (size_t i = 0; i < CellLayerCount; ++i)
+			{
+				if (_layerRefs[i] != 0)
+				{
+					mask |= static_cast<LayerMask>(1u << i);
+				}
+			}
+			return mask;
 		}
 
 		// === Behaviors ===
@@ -74,7 +178,19 @@ namespace sw::core
 			_behaviors.push_back(std::move(behavior));
 		}
 
-		bool playTurn(IGameWorld& world, IGameEvents& events)
+		// Visits behaviors in priority order
+		template <typename TVisitor>
+		void forEachBehavior(TVisitor&& visitor) const
+		{
+			for (const auto& behavior : _behaviors)
+			{
+				visitor(*behavior);
+			}
+		}
+
+		// `events` is any IGameEvents sink, or NullEvents to reach behaviors without virtual event calls
+		template <typename TEvents>
+		bool playTurn(IGameWorld& world, TEvents& events)
 		{
 			for (auto& behavior : _behaviors)
 			{
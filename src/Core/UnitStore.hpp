@@ -0,0 +1,165 @@
+#pragma once
+
+#include "Unit.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace sw::core
+{
+	/// @brief Append-only chunked storage for units.
+	/// Units are laid out contiguously in creation order inside fixed-size chunks and are never relocated,
+	/// so `Unit*` handles held by the world stay valid until the unit itself is erased.
+	/// Chunks whose units have all been erased are released.
+	class UnitStore
+	{
+	private:
+		static constexpr uint32_t ChunkCapacity = 64;
+
+		struct Chunk
+		{
+			alignas(Unit) std::byte storage[sizeof(Unit) * ChunkCapacity];
+			// Bit i is set while slot i holds a unit
+			uint64_t live{};
+			// Slots handed out so far; slots are never reused, which keeps creation order
+			uint32_t used{};
+
+			Unit* slot(uint32_t index) noexcept
+			{
+				return std::launder(reinterpret_cast<Unit*>(storage) + index);
+			}
+
+			const Unit* slot(uint32_t index) const noexcept
+			{
+				return std::launder(reinterpret_cast<const Unit*>(storage) + index);
+			}
+
+			Chunk() = default;
+			Chunk(const Chunk&) = delete;
+			Chunk& operator=(const Chunk&) = delete;
+
+			~Chunk()
+			{
+				for (uint64_t bits = live; bits != 0; bits &= bits - 1)
+				{
+					slot(static_cast<uint32_t>(std::countr_zero(bits)))->~Unit();
+				}
+			}
+		};
+
+		std::vector<std::unique_ptr<Chunk>> _chunks;
+		size_t _size{};
+
+	public:
+		UnitStore() = default;
+
+		UnitStore(const UnitStore&) = delete;
+		UnitStore& operator=(const UnitStore&) = delete;
+
+		UnitStore(UnitStore&&) noexcept = default;
+		UnitStore& operator=(UnitStore&&) noexcept = default;
+
+		// Clones every live unit, in creation order, into fresh chunks
+		[[nodiscard]]
+		UnitStore clone() const
+		{
+			UnitStore copy;
+			forEach([&](const Unit& unit) { copy.emplace(unit.clone()); });
+			return copy;
+		}
+
+		[[nodiscard]]
+		size_t size() const noexcept
+		{
+			return _size;
+		}
+
+		// Makes room for `count` more units without growing the chunk table
+		void reserve(size_t count)
+		{
+			const size_t free = _chunks.empty() ? 0 : ChunkCapacity - _chunks.back()->used;
+			if (count > free)
+			{
+				_chunks.reserve(_chunks.size() + (count - free + ChunkCapacity - 1) / ChunkCapacity);
+			}
+		}
+
+		// Moves the unit into the next free slot and returns its final address.
+		Unit& emplace(Unit&& unit)
+		{
+			if (_chunks.empty() || _chunks.back()->used == ChunkCapacity)
+			{
+				_chunks.push_back(std::make_unique<Chunk>());
+			}
+
+			Chunk& chunk = *_chunks.back();
+			const uint32_t index = chunk.used;
+			Unit* placed = ::new (static_cast<void*>(chunk.storage + sizeof(Unit) * index)) Unit(std::move(unit));
+			chunk.live |= uint64_t{1} << index;
+			++chunk.used;
+			++_size;
+			return *placed;
+		}
+
+		// Destroys every unit matching the predicate; surviving units keep their addresses and order.
+		template <typename TPredicate>
+		size_t eraseIf(TPredicate&& predicate)
+		{
+			size_t erased = 0;
+			for (auto& chunk : _chunks)
+			{
+				for (uint64_t bits = chunk->live; bits != 0; bits &= bits - 1)
+				{
+					const auto index = static_cast<uint32_t>(std::countr_zero(bits));
+					Unit* unit = chunk->slot(index);
+					if (predicate(*unit))
+					{
+						unit->~Unit();
+						chunk->live &= ~(uint64_t{1} << index);
+						++erased;
+					}
+				}
+
+				// A full chunk with no live units can never be refilled
+				if (chunk->live == 0 && chunk->used == ChunkCapacity)
+				{
+					chunk.reset();
+				}
+			}
+
+			std::erase(_chunks, nullptr);
+			_size -= erased;
+			return erased;
+		}
+
+		// Visits units in creation order. Units must not be added while iterating.
+		template <typename TVisitor>
+		void forEach(TVisitor&& visitor)
+		{
+			for (auto& chunk : _chunks)
+			{
+				for (uint64_t bits = chunk->live; bits != 0; bits &= bits - 1)
+				{
+					visitor(*chunk->slot(static_cast<uint32_t>(std::countr_zero(bits))));
+				}
+			}
+		}
+
+		template <typename TVisitor>
+		void forEach(TVisitor&& visitor) const
+		{
+			for (const auto& chunk : _chunks)
+			{
+				for (uint64_t bits = chunk->live; bits != 0; bits &= bits - 1)
+				{
+					visitor(*chunk->slot(static_cast<uint32_t>(std::countr_zero(bits))));
+				}
+			}
+		}
+	};
+}
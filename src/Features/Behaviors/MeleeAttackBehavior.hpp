@@ -3,14 +3,14 @@
 #include "../../Core/IBehavior.hpp"
 #include "../../Core/IGameEvents.hpp"
 #include "../../Core/IGameWorld.hpp"
-#include "../../Core/Random.hpp"
+#include "../../Core/NullEvents.hpp"
 #include "../../Core/Unit.hpp"
 #include "../Components.hpp"
 #include "Utils.hpp"
 
 namespace sw::features
 {
-	class MeleeAttackBehavior : public core::IBehavior
+	class MeleeAttackBehavior : public core::Behavior<MeleeAttackBehavior>
 	{
 	public:
 		bool canExecute(const core::Unit& unit, const core::IGameWorld& world) const override
@@ -20,11 +20,11 @@ namespace sw::features
 				return false;
 			}
 
-			auto targets = utils::getTargetsInRange(unit, world, 1, 1);
-			return !targets.empty();
+			return utils::hasTargetsInRange(unit, world, 1, 1);
 		}
 
-		void execute(core::Unit& unit, core::IGameWorld& world, core::IGameEvents& events) override
+		template <typename TEvents>
+		void act(core::Unit& unit, core::IGameWorld& world, TEvents& events)
 		{
 			const auto* strength = unit.getComponent<StrengthComponent>();
 			if (!strength)
@@ -38,9 +38,9 @@ namespace sw::features
 				throw std::runtime_error("MeleeAttackBehavior: No targets found but canExecute returned true");
 			}
 
-			auto target = core::Random::getItem(targets);
+			auto target = world.getRandom().getItem(targets);
 
-			utils::dealDamage(unit, *target, strength->value, events);
+			utils::dealDamage(unit, *target, strength->value, world, events);
 		}
 	};
 }
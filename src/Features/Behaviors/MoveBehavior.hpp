@@ -3,17 +3,19 @@
 #include "../../Core/IBehavior.hpp"
 #include "../../Core/IGameEvents.hpp"
 #include "../../Core/IGameWorld.hpp"
+#include "../../Core/NullEvents.hpp"
 #include "../../Core/Unit.hpp"
 #include "../Components.hpp"
 #include "Utils.hpp"
 
 namespace sw::features
 {
-	class MoveBehavior : public core::IBehavior
+	class MoveBehavior : public core::Behavior<MoveBehavior>
 	{
 	private:
+		// Straight step toward the target (8-connected), if the cell is free
 		[[nodiscard]]
-		static bool tryGetNextPos(
+		static bool tryGetGreedyPos(
 			core::Position pos,
 			const core::IGameWorld& world,
 			const MarchComponent& march,
@@ -60,6 +62,25 @@ namespace sw::features
 			return true;
 		}
 
+		// Returns true if the step comes from the flow field (a detour around blockers)
+		[[nodiscard]]
+		static bool tryGetNextPos(
+			core::Position pos,
+			const core::IGameWorld& world,
+			const MarchComponent& march,
+			core::Position& outNextPos,
+			bool& outDetour)
+		{
+			if (!march.detoured && tryGetGreedyPos(pos, world, march, outNextPos))
+			{
+				outDetour = false;
+				return true;
+			}
+
+			outDetour = true;
+			return world.findFlowStep(pos, march.target, outNextPos);
+		}
+
 	public:
 		bool canExecute(const core::Unit& unit, const core::IGameWorld& world) const override
 		{
@@ -78,10 +99,12 @@ namespace sw::features
 			}
 
 			core::Position nextPos{};
-			return tryGetNextPos(pos, world, *march, nextPos);
+			bool detour = false;
+			return tryGetNextPos(pos, world, *march, nextPos, detour);
 		}
 
-		void execute(core::Unit& unit, core::IGameWorld& world, core::IGameEvents& events) override
+		template <typename TEvents>
+		void act(core::Unit& unit, core::IGameWorld& world, TEvents& events)
 		{
 			auto* march = unit.getComponent<MarchComponent>();
 			if (!march)
@@ -97,23 +120,31 @@ namespace sw::features
 			{
 				events.onMarchEnded(unit.getId(), target);
 				unit.removeComponent<MarchComponent>();
+				world.syncUnitState(unit.getId());
 				return;
 			}
 
 			core::Position nextPos{};
-			if (!tryGetNextPos(pos, world, *march, nextPos))
+			bool detour = false;
+			if (!tryGetNextPos(pos, world, *march, nextPos, detour))
 			{
 				throw std::runtime_error("MoveBehavior: Path blocked or invalid but canExecute returned true");
 			}
-
 			const auto from = pos;
 			world.moveUnit(unit.getId(), nextPos);
 			events.onUnitMoved(unit.getId(), from, nextPos);
+			// Updated after the move is reported, so observers (e.g. app::Timeline) see the march the step came from
+			if (detour && !march->detoured)
+			{
+				march->detoured = true;
+				world.syncUnitState(unit.getId());
+			}
 
 			if (nextPos == target)
 			{
 				events.onMarchEnded(unit.getId(), target);
 				unit.removeComponent<MarchComponent>();
+				world.syncUnitState(unit.getId());
 			}
 		}
 	};
@@ -3,14 +3,14 @@
 #include "../../Core/IBehavior.hpp"
 #include "../../Core/IGameEvents.hpp"
 #include "../../Core/IGameWorld.hpp"
-#include "../../Core/Random.hpp"
+#include "../../Core/NullEvents.hpp"
 #include "../../Core/Unit.hpp"
 #include "../Components.hpp"
 #include "Utils.hpp"
 
 namespace sw::features
 {
-	class RangeAttackBehavior : public core::IBehavior
+	class RangeAttackBehavior : public core::Behavior<RangeAttackBehavior>
 	{
 	public:
 		bool canExecute(const core::Unit& unit, const core::IGameWorld& world) const override
@@ -25,17 +25,28 @@ namespace sw::features
 
 			// Rule: hunter can shoot only if there are no OTHER units in adjacent cells
 			// (not just "attackable" ones). So we check all units.
-			auto neighbors = utils::getUnitsInRange(unit, world, 1, 1);
-			if (!neighbors.empty())
+			if (utils::hasUnitsInRange(unit, world, 1, 1))
 			{
 				return false;
 			}
 
+			if (!utils::hasTargetsInRange(unit, world, 2, range->value))
+			{
+				return false;
+			}
+
+			if (!world.hasTerrain() || !unit.getComponent<LineOfSightComponent>())
+			{
+				return true;
+			}
+
 			auto targets = utils::getTargetsInRange(unit, world, 2, range->value);
+			utils::removeHiddenTargets(unit, world, targets);
 			return !targets.empty();
 		}
 
-		void execute(core::Unit& unit, core::IGameWorld& world, core::IGameEvents& events) override
+		template <typename TEvents>
+		void act(core::Unit& unit, core::IGameWorld& world, TEvents& events)
 		{
 			const auto* agility = unit.getComponent<AgilityComponent>();
 			const auto* range = unit.getComponent<RangeComponent>();
@@ -45,14 +56,15 @@ namespace sw::features
 			}
 
 			auto targets = utils::getTargetsInRange(unit, world, 2, range->value);
+			utils::removeHiddenTargets(unit, world, targets);
 			if (targets.empty())
 			{
 				throw std::runtime_error("RangeAttackBehavior: No targets found but canExecute returned true");
 			}
 
-			auto target = core::Random::getItem(targets);
+			auto target = world.getRandom().getItem(targets);
 
-			utils::dealDamage(unit, *target, agility->value, events);
+			utils::dealDamage(unit, *target, agility->value, world, events);
 		}
 	};
 }
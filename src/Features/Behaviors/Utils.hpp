@@ -6,62 +6,48 @@
 #include "../Components.hpp"
 
 #include <algorithm>
-#include <cmath>
 #include <memory>
 #include <type_traits>
 #include <vector>
 
 namespace sw::features::utils
 {
+	// Cost model for a range query: a cell scan touches roughly one bitmap word per 64 cells of the clipped square
+	// (plus per-row overhead), a position sweep costs one SIMD lane per unit on the map
+	// (it scans every unit's position column, then filters by layer).
+	// Both strategies return the same candidates, so the choice only affects speed.
+	inline core::RangeStrategy chooseRangeStrategy(const core::IGameWorld& world, uint32_t maxRange)
+	{
+		constexpr uint64_t CellsPerWord = 64;
+		constexpr uint64_t SweepLanes = 4;
+
+		const uint64_t side = 2 * static_cast<uint64_t>(maxRange) + 1;
+		const uint64_t width = std::min<uint64_t>(side, world.getWidth());
+		const uint64_t height = std::min<uint64_t>(side, world.getHeight());
+		const uint64_t scanCost = width * height / CellsPerWord + height;
+		const uint64_t sweepCost = world.getUnitCount() / SweepLanes;
+
+		return sweepCost < scanCost ? core::RangeStrategy::PositionSweep : core::RangeStrategy::CellScan;
+	}
+
 	namespace details
 	{
-		template <typename WorldT, typename UnitPtrT, typename TFilter>
+		template <typename WorldT, typename UnitPtrT>
 		std::vector<UnitPtrT> getTargetsInRangeImpl(
-			const core::Unit& unit, WorldT& world, uint32_t minRange, uint32_t maxRange, TFilter filter)
+			const core::Unit& unit, WorldT& world, uint32_t minRange, uint32_t maxRange, core::CellLayer layer)
 		{
 			std::vector<UnitPtrT> targets;
 			using UnitT = std::remove_pointer_t<UnitPtrT>;
 
-			core::Position pos = world.getUnitPosition(unit.getId());
-
-			int32_t minX = static_cast<int32_t>(pos.x) - static_cast<int32_t>(maxRange);
-			int32_t maxX = static_cast<int32_t>(pos.x) + static_cast<int32_t>(maxRange);
-			int32_t minY = static_cast<int32_t>(pos.y) - static_cast<int32_t>(maxRange);
-			int32_t maxY = static_cast<int32_t>(pos.y) + static_cast<int32_t>(maxRange);
-
-			minX = std::max(0, minX);
-			minY = std::max(0, minY);
-			maxX = std::min(static_cast<int32_t>(world.getWidth()) - 1, maxX);
-			maxY = std::min(static_cast<int32_t>(world.getHeight()) - 1, maxY);
-
-			for (int32_t x = minX; x <= maxX; ++x)
-			{
-				for (int32_t y = minY; y <= maxY; ++y)
-				{
-					core::Position p{static_cast<uint32_t>(x), static_cast<uint32_t>(y)};
-
-					if (p == pos)
-					{
-						continue;
-					}
-
-					uint32_t dist = std::max(
-						std::abs(x - static_cast<int32_t>(pos.x)), std::abs(y - static_cast<int32_t>(pos.y)));
-
-					if (dist >= minRange && dist <= maxRange)
-					{
-						world.forEachUnitAt(
-							p,
-							[&](UnitT& otherRef)
-							{
-								if (filter(otherRef))
-								{
-									targets.push_back(&otherRef);
-								}
-							});
-					}
-				}
-			}
+			const core::Position pos = world.getUnitPosition(unit.getId());
+
+			world.forEachUnitInRange(
+				layer,
+				pos,
+				std::max<uint32_t>(minRange, 1),
+				maxRange,
+				chooseRangeStrategy(world, maxRange),
+				[&](UnitT& otherRef) { targets.push_back(&otherRef); });
 			return targets;
 		}
 	}
@@ -71,12 +57,15 @@ namespace sw::features::utils
 		return unit.getComponent<HealthComponent>() != nullptr;
 	}
 
+	// Targets are units on the Targetable layer, i.e. those with a HealthComponent (see hasHealth).
+	// The unit's own cell is never part of the range.
+
 	// Const version for canExecute (returns const Unit*)
 	inline std::vector<const core::Unit*> getTargetsInRange(
 		const core::Unit& unit, const core::IGameWorld& world, uint32_t minRange, uint32_t maxRange)
 	{
 		return details::getTargetsInRangeImpl<const core::IGameWorld, const core::Unit*>(
-			unit, world, minRange, maxRange, [](const core::Unit& u) { return hasHealth(u); });
+			unit, world, minRange, maxRange, core::CellLayer::Targetable);
 	}
 
 	// Non-const version for execute (returns Unit*)
@@ -84,7 +73,7 @@ namespace sw::features::utils
 		const core::Unit& unit, core::IGameWorld& world, uint32_t minRange, uint32_t maxRange)
 	{
 		return details::getTargetsInRangeImpl<core::IGameWorld, core::Unit*>(
-			unit, world, minRange, maxRange, [](const core::Unit& u) { return hasHealth(u); });
+			unit, world, minRange, maxRange, core::CellLayer::Targetable);
 	}
 
 	// Returns all units in range (no filtering).
@@ -92,18 +81,18 @@ namespace sw::features::utils
 		const core::Unit& unit, const core::IGameWorld& world, uint32_t minRange, uint32_t maxRange)
 	{
 		return details::getTargetsInRangeImpl<const core::IGameWorld, const core::Unit*>(
-			unit, world, minRange, maxRange, [](const core::Unit&) { return true; });
+			unit, world, minRange, maxRange, core::CellLayer::Occupied);
 	}
 
 	inline std::vector<core::Unit*> getUnitsInRange(
 		const core::Unit& unit, core::IGameWorld& world, uint32_t minRange, uint32_t maxRange)
 	{
 		return details::getTargetsInRangeImpl<core::IGameWorld, core::Unit*>(
-			unit, world, minRange, maxRange, [](const core::Unit&) { return true; });
+			unit, world, minRange, maxRange, core::CellLayer::Occupied);
 	}
 
-	inline void dealDamage(
-		core::Unit& attacker, core::Unit& target, uint32_t damage, core::IGameEvents& events)
+	template <typename EventsT>
+	void dealDamage(core::Unit& attacker, core::Unit& target, uint32_t damage, core::IGameWorld& world, EventsT& events)
 	{
 		auto* hp = target.getComponent<HealthComponent>();
 		if (!hp)
@@ -115,13 +104,46 @@ namespace sw::features::utils
 		{
 			target.setDead(true);
 		}
+		world.syncUnitState(target.getId());
 
 		events.onUnitAttacked(attacker.getId(), target.getId(), damage, hp->getHp());
 	}
 
 	inline bool isCellBlocked(const core::IGameWorld& world, core::Position pos)
 	{
-		return world.anyUnitAt(
-			pos, [](const core::Unit& unit) { return unit.getComponent<BlockerComponent>() != nullptr; });
+		return world.testCell(core::CellLayer::Blocker, pos);
+	}
+
+	// Shots from units with a LineOfSightComponent are stopped by terrain between the two cells
+	inline bool canSee(const core::Unit& unit, const core::Unit& target, const core::IGameWorld& world)
+	{
+		return !unit.getComponent<LineOfSightComponent>()
+			|| world.hasLineOfSight(world.getUnitPosition(unit.getId()), world.getUnitPosition(target.getId()));
+	}
+
+	// Removes targets the unit cannot see (see canSee); a no-op without terrain
+	template <typename UnitPtrT>
+	void removeHiddenTargets(const core::Unit& unit, const core::IGameWorld& world, std::vector<UnitPtrT>& targets)
+	{
+		if (!world.hasTerrain() || !unit.getComponent<LineOfSightComponent>())
+		{
+			return;
+		}
+		std::erase_if(targets, [&](UnitPtrT target) { return !canSee(unit, *target, world); });
+	}
+
+	// Cheap existence checks backed by the world's cell layers; prefer these over building target lists in canExecute.
+	inline bool hasTargetsInRange(
+		const core::Unit& unit, const core::IGameWorld& world, uint32_t minRange, uint32_t maxRange)
+	{
+		return world.anyCellInRange(
+			core::CellLayer::Targetable, world.getUnitPosition(unit.getId()), minRange, maxRange);
+	}
+
+	inline bool hasUnitsInRange(
+		const core::Unit& unit, const core::IGameWorld& world, uint32_t minRange, uint32_t maxRange)
+	{
+		return world.anyCellInRange(
+			core::CellLayer::Occupied, world.getUnitPosition(unit.getId()), minRange, maxRange);
 	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Core/IComponent.hpp"
+#include "../Core/StateHash.hpp"
 #include "../Core/Types.hpp"
 
 #include <cstdint>
@@ -10,16 +11,33 @@ namespace sw::features
 	class HealthComponent : public core::IComponent
 	{
 	public:
+		// Anything with health is a valid attack target (see utils::hasHealth).
+		static constexpr core::LayerMask Layers = core::layerBit(core::CellLayer::Targetable);
+
+		HealthComponent() = default;
+
 		explicit HealthComponent(uint32_t hp) :
 				_currentHp(static_cast<int32_t>(hp))
 		{}
 
+		template <typename Visitor>
+		void visit(Visitor& visitor)
+		{
+			visitor.visit("hp", _currentHp);
+		}
+
 		bool takeDamage(uint32_t damage)
 		{
 			_currentHp -= static_cast<int32_t>(damage);
 			return _currentHp <= 0;
 		}
 
+		// Undoes takeDamage(amount)
+		void restoreDamage(uint32_t amount)
+		{
+			_currentHp += static_cast<int32_t>(amount);
+		}
+
 		[[nodiscard]] uint32_t getHp() const
 		{
 			return _currentHp < 0 ? 0 : static_cast<uint32_t>(_currentHp);
@@ -30,49 +48,105 @@ namespace sw::features
 			return _currentHp <= 0;
 		}
 
+		[[nodiscard]] uint64_t hashState() const
+		{
+			return core::hashMix(0x4845'414c'5448ull, static_cast<uint32_t>(_currentHp));
+		}
+
 	private:
-		int32_t _currentHp;
+		int32_t _currentHp{};
 	};
 
 	struct StrengthComponent : public core::IComponent
 	{
-		uint32_t value;
+		uint32_t value{};
+
+		StrengthComponent() = default;
 
 		explicit StrengthComponent(uint32_t v) :
 				value(v)
 		{}
+
+		template <typename Visitor>
+		void visit(Visitor& visitor)
+		{
+			visitor.visit("value", value);
+		}
 	};
 
 	struct AgilityComponent : public core::IComponent
 	{
-		uint32_t value;
+		uint32_t value{};
+
+		AgilityComponent() = default;
 
 		explicit AgilityComponent(uint32_t v) :
 				value(v)
 		{}
+
+		template <typename Visitor>
+		void visit(Visitor& visitor)
+		{
+			visitor.visit("value", value);
+		}
 	};
 
 	struct RangeComponent : public core::IComponent
 	{
-		uint32_t value;
+		uint32_t value{};
+
+		RangeComponent() = default;
 
 		explicit RangeComponent(uint32_t v) :
 				value(v)
 		{}
+
+		template <typename Visitor>
+		void visit(Visitor& visitor)
+		{
+			visitor.visit("value", value);
+		}
 	};
 
 	struct MarchComponent : public core::IComponent
 	{
-		core::Position target;
+		core::Position target{};
+		// Set once the straight step was blocked: the rest of the march follows the world's flow field,
+		// so the unit cannot walk back into the dead end it just left.
+		bool detoured{false};
+
+		MarchComponent() = default;
 
 		explicit MarchComponent(core::Position t) :
 				target(t)
 		{}
+
+		[[nodiscard]] uint64_t hashState() const
+		{
+			// The detour flag changes how the unit moves next, so two marches differing only in it must hash apart
+			return core::hashMix(core::hashMix(0x4d41'5243'48ull, core::hashPosition(target)), detoured ? 1 : 0);
+		}
+
+		template <typename Visitor>
+		void visit(Visitor& visitor)
+		{
+			visitor.visit("targetX", target.x);
+			visitor.visit("targetY", target.y);
+			visitor.visit("detoured", detoured);
+		}
+	};
+
+	struct LineOfSightComponent : public core::IComponent
+	{
+		// Marker component: ranged attacks need a terrain-free line to the target.
+		LineOfSightComponent() = default;
 	};
 
 	struct BlockerComponent : public core::IComponent
 	{
 		// Marker component: indicates this unit blocks movement.
+		static constexpr core::LayerMask Layers = core::layerBit(core::CellLayer::Blocker);
+
 		BlockerComponent() = default;
 	};
 }
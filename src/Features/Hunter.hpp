@@ -8,21 +8,19 @@
 
 namespace sw::features
 {
-	class Hunter : public core::Unit
+	inline core::Unit makeHunter(core::UnitId id, uint32_t hp, uint32_t agility, uint32_t strength, uint32_t range)
 	{
-	public:
-		Hunter(core::UnitId id, uint32_t hp, uint32_t agility, uint32_t strength, uint32_t range) :
-				Unit(id)
-		{
-			addComponent<HealthComponent>(hp);
-			addComponent<StrengthComponent>(strength);
-			addComponent<AgilityComponent>(agility);
-			addComponent<RangeComponent>(range);
-			addComponent<BlockerComponent>();
+		core::Unit unit(id);
+		unit.addComponent<HealthComponent>(hp);
+		unit.addComponent<StrengthComponent>(strength);
+		unit.addComponent<AgilityComponent>(agility);
+		unit.addComponent<RangeComponent>(range);
+		unit.addComponent<LineOfSightComponent>();
+		unit.addComponent<BlockerComponent>();
 
-			addBehavior(std::make_unique<RangeAttackBehavior>());
-			addBehavior(std::make_unique<MeleeAttackBehavior>());
-			addBehavior(std::make_unique<MoveBehavior>());
-		}
-	};
+		unit.addBehavior(std::make_unique<RangeAttackBehavior>());
+		unit.addBehavior(std::make_unique<MeleeAttackBehavior>());
+		unit.addBehavior(std::make_unique<MoveBehavior>());
+		return unit;
+	}
 }
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../Core/SnapshotTypes.hpp"
+#include "Behaviors.hpp"
+#include "Components.hpp"
+
+namespace sw::features
+{
+	// Every component and behavior of the built-in unit kinds. Tags are stored in snapshots: never rename one,
+	// and register new types under new tags.
+	inline const core::SnapshotTypes& snapshotTypes()
+	{
+		static const core::SnapshotTypes types = []
+		{
+			core::SnapshotTypes registry;
+			registry.addComponent<HealthComponent>("health")
+				.addComponent<StrengthComponent>("strength")
+				.addComponent<AgilityComponent>("agility")
+				.addComponent<RangeComponent>("range")
+				.addComponent<MarchComponent>("march")
+				.addComponent<LineOfSightComponent>("line_of_sight")
+				.addComponent<BlockerComponent>("blocker")
+				.addBehavior<RangeAttackBehavior>("range_attack")
+				.addBehavior<MeleeAttackBehavior>("melee_attack")
+				.addBehavior<MoveBehavior>("move");
+			return registry;
+		}();
+		return types;
+	}
+}
@@ -8,18 +8,15 @@
 
 namespace sw::features
 {
-	class Swordsman : public core::Unit
+	inline core::Unit makeSwordsman(core::UnitId id, uint32_t hp, uint32_t strength)
 	{
-	public:
-		Swordsman(core::UnitId id, uint32_t hp, uint32_t strength) :
-				Unit(id)
-		{
-			addComponent<HealthComponent>(hp);
-			addComponent<StrengthComponent>(strength);
-			addComponent<BlockerComponent>();
+		core::Unit unit(id);
+		unit.addComponent<HealthComponent>(hp);
+		unit.addComponent<StrengthComponent>(strength);
+		unit.addComponent<BlockerComponent>();
 
-			addBehavior(std::make_unique<MeleeAttackBehavior>());
-			addBehavior(std::make_unique<MoveBehavior>());
-		}
-	};
+		unit.addBehavior(std::make_unique<MeleeAttackBehavior>());
+		unit.addBehavior(std::make_unique<MoveBehavior>());
+		return unit;
+	}
 }
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+namespace sw::io
+{
+	// Replaces the terrain layer with a binary side file (see TerrainFile.hpp); relative paths are resolved
+	// against the scenario file's directory
+	struct LoadTerrain
+	{
+		constexpr static const char* Name = "LOAD_TERRAIN";
+
+		std::string path;
+
+		template <typename Visitor>
+		void visit(Visitor& visitor)
+		{
+			visitor.visit("path", path);
+		}
+	};
+}
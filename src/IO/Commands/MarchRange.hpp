@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+
+namespace sw::io
+{
+	// MARCH for every unit with an ID in [firstId, lastId]
+	struct MarchRange
+	{
+		constexpr static const char* Name = "MARCH_RANGE";
+
+		uint32_t firstId{};
+		uint32_t lastId{};
+		uint32_t targetX{};
+		uint32_t targetY{};
+
+		template <typename Visitor>
+		void visit(Visitor& visitor)
+		{
+			visitor.visit("firstId", firstId);
+			visitor.visit("lastId", lastId);
+			visitor.visit("targetX", targetX);
+			visitor.visit("targetY", targetY);
+		}
+	};
+}
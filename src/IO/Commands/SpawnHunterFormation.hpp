@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+
+namespace sw::io
+{
+	// Hunter counterpart of SpawnSwordsmanFormation
+	struct SpawnHunterFormation
+	{
+		constexpr static const char* Name = "SPAWN_HUNTER_FORMATION";
+
+		uint32_t firstId{};
+		uint32_t x{};
+		uint32_t y{};
+		uint32_t columns{};
+		uint32_t rows{};
+		uint32_t stride{};
+		uint32_t hp{};
+		uint32_t agility{};
+		uint32_t strength{};
+		uint32_t range{};
+
+		template <typename Visitor>
+		void visit(Visitor& visitor)
+		{
+			visitor.visit("firstId", firstId);
+			visitor.visit("x", x);
+			visitor.visit("y", y);
+			visitor.visit("columns", columns);
+			visitor.visit("rows", rows);
+			visitor.visit("stride", stride);
+			visitor.visit("hp", hp);
+			visitor.visit("agility", agility);
+			visitor.visit("strength", strength);
+			visitor.visit("range", range);
+		}
+	};
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+
+namespace sw::io
+{
+	// `columns` x `rows` swordsmen with IDs firstId, firstId + 1, ... row by row, `stride` cells apart from (x, y)
+	struct SpawnSwordsmanFormation
+	{
+		constexpr static const char* Name = "SPAWN_SWORDSMAN_FORMATION";
+
+		uint32_t firstId{};
+		uint32_t x{};
+		uint32_t y{};
+		uint32_t columns{};
+		uint32_t rows{};
+		uint32_t stride{};
+		uint32_t hp{};
+		uint32_t strength{};
+
+		template <typename Visitor>
+		void visit(Visitor& visitor)
+		{
+			visitor.visit("firstId", firstId);
+			visitor.visit("x", x);
+			visitor.visit("y", y);
+			visitor.visit("columns", columns);
+			visitor.visit("rows", rows);
+			visitor.visit("stride", stride);
+			visitor.visit("hp", hp);
+			visitor.visit("strength", strength);
+		}
+	};
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+
+namespace sw::io
+{
+	// Marks an inclusive rectangle of cells as impassable terrain
+	struct Terrain
+	{
+		constexpr static const char* Name = "TERRAIN";
+
+		uint32_t x1{};
+		uint32_t y1{};
+		uint32_t x2{};
+		uint32_t y2{};
+
+		template <typename Visitor>
+		void visit(Visitor& visitor)
+		{
+			visitor.visit("x1", x1);
+			visitor.visit("y1", y1);
+			visitor.visit("x2", x2);
+			visitor.visit("y2", y2);
+		}
+	};
+}
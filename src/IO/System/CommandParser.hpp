@@ -2,39 +2,374 @@
 
 #include "details/CommandParserVisitor.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
-#include <sstream>
+#include <future>
+#include <istream>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
 
 namespace sw::io
 {
+	namespace details
+	{
+		constexpr uint64_t hashCommandName(std::string_view name, uint64_t seed) noexcept
+		{
+			uint64_t hash = 0xcbf2'9ce4'8422'2325ull ^ seed;
+			for (const char c : name)
+			{
+				hash = (hash ^ static_cast<unsigned char>(c)) * 0x0000'0100'0000'01b3ull;
+			}
+			return hash;
+		}
+
+		// Open-addressing table without collisions: every name owns the slot its seeded hash points to
+		template <size_t N>
+		struct CommandNameTable
+		{
+			static constexpr size_t Size = std::bit_ceil(N * 2);
+
+			uint64_t seed{};
+			// Command index + 1; 0 marks an empty slot
+			std::array<uint8_t, Size> slots{};
+
+			[[nodiscard]]
+			constexpr size_t slotOf(std::string_view name) const noexcept
+			{
+				return hashCommandName(name, seed) & (Size - 1);
+			}
+		};
+
+		template <size_t N>
+		consteval bool hasDuplicateNames(const std::array<std::string_view, N>& names)
+		{
+			for (size_t i = 0; i < N; ++i)
+			{
+				for (size_t j = i + 1; j < N; ++j)
+				{
+					if (names[i] == names[j])
+					{
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		template <size_t N>
+		consteval CommandNameTable<N> buildCommandNameTable(const std::array<std::string_view, N>& names)
+		{
+			for (uint64_t seed = 0; seed < 4096; ++seed)
+			{
+				CommandNameTable<N> table{seed, {}};
+				bool perfect = true;
+				for (size_t i = 0; i < N && perfect; ++i)
+				{
+					auto& slot = table.slots[table.slotOf(names[i])];
+					perfect = slot == 0;
+					slot = static_cast<uint8_t>(i + 1);
+				}
+				if (perfect)
+				{
+					return table;
+				}
+			}
+			throw "No perfect hash seed found for the command names";
+		}
+	}
+
+	/// @brief Parses scenario lines into the command structs `TCommands` and passes them to their handlers.
+	/// The command set is fixed at compile time: names are dispatched through a perfect hash built from
+	/// `TCommand::Name`, and fields are decoded in place from the line, so a parsed line costs no allocation
+	/// (beyond string fields and what the handler does).
+	template <class... TCommands>
 	class CommandParser
 	{
+	public:
+		using Command = std::variant<TCommands...>;
+
+		struct ParallelResult
+		{
+			// Byte offset of the line parsing stopped at (the text size if it reached the end)
+			size_t offset{};
+			// Lines before that offset
+			uint64_t lines{};
+		};
+
+		// Text handed to one decoding task
+		static constexpr size_t ParallelChunkSize = size_t{4} << 20;
+
 	private:
-		std::unordered_map<std::string, std::function<void(std::istream&)>> _commands;
+		static constexpr size_t CommandCount = sizeof...(TCommands);
+		static_assert(CommandCount > 0 && CommandCount < 255, "Command table holds 1..254 commands");
+
+		static constexpr std::array<std::string_view, CommandCount> Names{std::string_view(TCommands::Name)...};
+		static_assert(!details::hasDuplicateNames(Names), "Command names must be unique");
+		static constexpr auto Table = details::buildCommandNameTable(Names);
+
+		std::tuple<std::function<void(TCommands)>...> _handlers;
+
+		template <class TCommandData, class TReader>
+		static Command readAs(TReader& reader)
+		{
+			TCommandData data;
+			data.visit(reader);
+			return Command(std::in_place_type<TCommandData>, std::move(data));
+		}
+
+		template <class TCommandData>
+		static Command decodeAs(std::string_view args)
+		{
+			TCommandData data;
+			CommandParserVisitor visitor(TCommandData::Name, args);
+			data.visit(visitor);
+			return Command(std::in_place_type<TCommandData>, std::move(data));
+		}
+
+		using Decoder = Command (*)(std::string_view);
+		static constexpr std::array<Decoder, CommandCount> Decoders{&CommandParser::decodeAs<TCommands>...};
+
+		// Commands of one chunk of text, decoded off the applying thread
+		struct DecodedChunk
+		{
+			std::vector<Command> commands;
+			// Chunk-relative line index of each command
+			std::vector<uint32_t> lines;
+			uint64_t lineCount{};
+			// Chunk-relative offset of the stop line, if the chunk holds one
+			std::optional<size_t> stop;
+			std::optional<std::pair<uint64_t, std::string>> error;
+		};
+
+		template <class TStop>
+		static DecodedChunk decodeChunk(std::string_view text, const TStop& isStop)
+		{
+			DecodedChunk chunk;
+			// Scenario lines are rarely shorter than this
+			chunk.commands.reserve(text.size() / 24);
+			chunk.lines.reserve(text.size() / 24);
+
+			size_t offset = 0;
+			for (; offset < text.size(); ++chunk.lineCount)
+			{
+				const size_t end = std::min(text.find('\n', offset), text.size());
+				const auto line = text.substr(offset, end - offset);
+				if (isStop(line))
+				{
+					chunk.stop = offset;
+					break;
+				}
+				try
+				{
+					if (auto command = decode(line))
+					{
+						chunk.commands.push_back(std::move(*command));
+						chunk.lines.push_back(static_cast<uint32_t>(chunk.lineCount));
+					}
+				}
+				catch (const std::exception& e)
+				{
+					chunk.error.emplace(chunk.lineCount, e.what());
+					break;
+				}
+				offset = end + 1;
+			}
+			return chunk;
+		}
+
+		static std::runtime_error lineError(uint64_t line, std::string_view message)
+		{
+			return std::runtime_error("line " + std::to_string(line) + ": " + std::string(message));
+		}
 
 	public:
 		template <class TCommandData>
 		CommandParser& add(std::function<void(TCommandData)> handler)
 		{
-			std::string commandName = TCommandData::Name;
-			auto [it, inserted] = _commands.emplace(
-				commandName,
-				[handler = std::move(handler)](std::istream& stream)
-				{
-					TCommandData data;
-					CommandParserVisitor visitor(stream);
-					data.visit(visitor);
-					handler(std::move(data));
-				});
-			if (!inserted)
+			static_assert(
+				(std::is_same_v<TCommandData, TCommands> || ...), "Command is not in the parser's command list");
+
+			auto& slot = std::get<std::function<void(TCommandData)>>(_handlers);
+			if (slot)
 			{
-				throw std::runtime_error("Command already exists: " + commandName);
+				throw std::runtime_error("Command already exists: " + std::string(TCommandData::Name));
 			}
+			slot = std::move(handler);
 
 			return *this;
 		}
 
-		void parse(std::istream& stream);
+		void parse(std::istream& stream)
+		{
+			std::string line;
+			while (std::getline(stream, line))
+			{
+				parseLine(line);
+			}
+		}
+
+		// Command names in `Command` alternative order
+		static constexpr std::span<const std::string_view> getCommandNames() noexcept
+		{
+			return Names;
+		}
+
+		// Passes the command's fields to `writer.visit(name, value)` in declaration order
+		template <class TWriter>
+		static void writeFields(const Command& command, TWriter& writer)
+		{
+			std::visit(
+				[&writer](const auto& data)
+				{
+					// `visit` is shared with reading and therefore non-const
+					auto fields = data;
+					fields.visit(writer);
+				},
+				command);
+		}
+
+		// Reads the fields writeFields() wrote for the command at `index` in getCommandNames()
+		template <class TReader>
+		static Command readFields(size_t index, TReader& reader)
+		{
+			static constexpr std::array<Command (*)(TReader&), CommandCount> Readers{&readAs<TCommands, TReader>...};
+			if (index >= CommandCount)
+			{
+				throw std::out_of_range("Command index out of range");
+			}
+			return Readers[index](reader);
+		}
+
+		// Decodes one line without running it (safe on any thread); std::nullopt for blank and comment lines
+		static std::optional<Command> decode(std::string_view line)
+		{
+			if (line.starts_with("//"))
+			{
+				return std::nullopt;
+			}
+
+			const auto begin = line.find_first_not_of(" \t\r");
+			if (begin == std::string_view::npos)
+			{
+				return std::nullopt;
+			}
+			line.remove_prefix(begin);
+			const auto name = line.substr(0, line.find_first_of(" \t\r"));
+
+			const uint8_t slot = Table.slots[Table.slotOf(name)];
+			if (slot == 0 || Names[slot - 1] != name)
+			{
+				throw std::runtime_error("Unknown command: " + std::string(name));
+			}
+			return Decoders[slot - 1](line.substr(name.size()));
+		}
+
+		// Passes a decoded command to its handler
+		void apply(Command command)
+		{
+			std::visit(
+				[this](auto& data)
+				{
+					using TCommandData = std::decay_t<decltype(data)>;
+					auto& handler = std::get<std::function<void(TCommandData)>>(_handlers);
+					if (!handler)
+					{
+						throw std::runtime_error("No handler for command: " + std::string(TCommandData::Name));
+					}
+					handler(std::move(data));
+				},
+				command);
+		}
+
+		// Runs the command on one line; returns false for blank and comment lines
+		bool parseLine(std::string_view line)
+		{
+			auto command = decode(line);
+			if (!command)
+			{
+				return false;
+			}
+			apply(std::move(*command));
+			return true;
+		}
+
+		// Parses `text` like consecutive parseLine() calls, up to the first line for which `isStop(line)` holds.
+		// Chunks of about `chunkSize` bytes, split at line ends, are decoded on up to `threads` threads while
+		// this thread applies the decoded commands in text order; at most `threads` chunks are in flight.
+		// Errors name the 1-based line ("line N: ..."); the commands before it have been applied.
+		template <class TStop>
+		ParallelResult parseParallel(
+			std::string_view text, size_t threads, const TStop& isStop, size_t chunkSize = ParallelChunkSize)
+		{
+			struct Pending
+			{
+				size_t begin;
+				std::future<DecodedChunk> chunk;
+			};
+
+			std::deque<Pending> pending;
+			size_t next = 0;
+			auto launch = [&]
+			{
+				if (next >= text.size())
+				{
+					return;
+				}
+				size_t end = std::min(next + std::max<size_t>(chunkSize, 1), text.size());
+				end = end < text.size() ? std::min(text.find('\n', end), text.size() - 1) + 1 : end;
+				const auto slice = text.substr(next, end - next);
+				pending.push_back(Pending{
+					next, std::async(std::launch::async, [slice, &isStop] { return decodeChunk(slice, isStop); })});
+				next = end;
+			};
+			for (size_t i = 0; i < std::max<size_t>(threads, 1); ++i)
+			{
+				launch();
+			}
+
+			uint64_t lineBase = 0;
+			while (!pending.empty())
+			{
+				const size_t begin = pending.front().begin;
+				DecodedChunk chunk = pending.front().chunk.get();
+				pending.pop_front();
+				launch();
+
+				for (size_t i = 0; i < chunk.commands.size(); ++i)
+				{
+					try
+					{
+						apply(std::move(chunk.commands[i]));
+					}
+					catch (const std::exception& e)
+					{
+						throw lineError(lineBase + chunk.lines[i] + 1, e.what());
+					}
+				}
+				if (chunk.error)
+				{
+					throw lineError(lineBase + chunk.error->first + 1, chunk.error->second);
+				}
+				if (chunk.stop)
+				{
+					return ParallelResult{begin + *chunk.stop, lineBase + chunk.lineCount};
+				}
+				lineBase += chunk.lineCount;
+			}
+			return ParallelResult{text.size(), lineBase};
+		}
 	};
 }
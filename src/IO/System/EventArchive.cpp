@@ -0,0 +1,408 @@
+#include "EventArchive.hpp"
+
+#include "../../Core/SnapshotTypes.hpp"
+#include "Varint.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+
+namespace sw::io
+{
+	namespace
+	{
+		using core::EventKind;
+		using core::GameEvent;
+
+		constexpr char Magic[8] = {'S', 'W', 'A', 'R', 'C', '0', '0', '1'};
+		constexpr size_t TrailerSize = sizeof(uint64_t) + sizeof(Magic);
+
+		enum class Field : uint8_t
+		{
+			Unit,
+			Target,
+			UnitType,
+			PosX,
+			PosY,
+			ToX,
+			ToY,
+			Damage,
+			TargetHp,
+		};
+
+		// Columns stored for each event kind, in file order
+		std::span<const Field> columnsOf(EventKind kind)
+		{
+			static constexpr Field MapCreated[] = {Field::PosX, Field::PosY};
+			static constexpr Field UnitSpawned[] = {Field::Unit, Field::UnitType, Field::PosX, Field::PosY};
+			static constexpr Field Move[] = {Field::Unit, Field::PosX, Field::PosY, Field::ToX, Field::ToY};
+			static constexpr Field UnitAttacked[] = {Field::Unit, Field::Target, Field::Damage, Field::TargetHp};
+			static constexpr Field UnitDied[] = {Field::Unit};
+			static constexpr Field MarchEnded[] = {Field::Unit, Field::PosX, Field::PosY};
+			switch (kind)
+			{
+				case EventKind::MapCreated:
+					return MapCreated;
+				case EventKind::UnitSpawned:
+					return UnitSpawned;
+				case EventKind::MarchStarted:
+				case EventKind::UnitMoved:
+					return Move;
+				case EventKind::UnitAttacked:
+					return UnitAttacked;
+				case EventKind::UnitDied:
+					return UnitDied;
+				case EventKind::MarchEnded:
+					return MarchEnded;
+			}
+			throw std::runtime_error("Unknown event kind");
+		}
+
+		uint32_t& fieldOf(ArchivedEvent& row, Field field)
+		{
+			switch (field)
+			{
+				case Field::Unit:
+					return row.event.unit;
+				case Field::Target:
+					return row.event.target;
+				case Field::UnitType:
+					return row.unitTypeIndex;
+				case Field::PosX:
+					return row.event.pos.x;
+				case Field::PosY:
+					return row.event.pos.y;
+				case Field::ToX:
+					return row.event.to.x;
+				case Field::ToY:
+					return row.event.to.y;
+				case Field::Damage:
+					return row.event.damage;
+				case Field::TargetHp:
+					return row.event.targetHp;
+			}
+			throw std::runtime_error("Unknown event field");
+		}
+
+		bool isUnitField(Field field)
+		{
+			return field == Field::Unit || field == Field::Target;
+		}
+
+		bool namesUnit(const GameEvent& event, core::UnitId unit)
+		{
+			return event.kind != EventKind::MapCreated
+				   && (event.unit == unit || (event.kind == EventKind::UnitAttacked && event.target == unit));
+		}
+	}
+
+	EventArchiveWriter::EventArchiveWriter(const std::string& path, const uint64_t& tick) :
+			_stream(path, std::ios::binary | std::ios::trunc),
+			_path(path),
+			_tick(tick)
+	{
+		if (!_stream.is_open())
+		{
+			throw std::runtime_error("Failed to open file: " + path);
+		}
+		_stream.write(Magic, sizeof(Magic));
+		_offset = sizeof(Magic);
+	}
+
+	EventArchiveWriter::~EventArchiveWriter()
+	{
+		if (!_finished)
+		{
+			try
+			{
+				finish();
+			}
+			catch (const std::exception&)
+			{
+				// Destructors must not throw; call finish() to see write errors
+			}
+		}
+	}
+
+	void EventArchiveWriter::record(const GameEvent& event, uint32_t unitTypeIndex)
+	{
+		auto& rows = _pending[static_cast<size_t>(event.kind)];
+		rows.push_back(ArchivedEvent{_tick, event, unitTypeIndex});
+		if (rows.size() == BlockEvents)
+		{
+			writeBlock(event.kind);
+		}
+	}
+
+	uint32_t EventArchiveWriter::internUnitType(std::string_view unitType)
+	{
+		const auto known = std::find(_unitTypes.begin(), _unitTypes.end(), unitType);
+		if (known != _unitTypes.end())
+		{
+			return static_cast<uint32_t>(known - _unitTypes.begin());
+		}
+		_unitTypes.emplace_back(unitType);
+		return static_cast<uint32_t>(_unitTypes.size() - 1);
+	}
+
+	void EventArchiveWriter::writeBlock(EventKind kind)
+	{
+		auto& rows = _pending[static_cast<size_t>(kind)];
+		if (rows.empty())
+		{
+			return;
+		}
+
+		ArchiveBlockInfo block{
+			kind, static_cast<uint32_t>(rows.size()), rows.front().tick, rows.back().tick, 0, 0, _offset, 0};
+		const auto columns = columnsOf(kind);
+		bool anyUnit = false;
+		for (auto& row : rows)
+		{
+			for (const auto field : columns)
+			{
+				if (isUnitField(field))
+				{
+					const auto unit = fieldOf(row, field);
+					block.minUnit = anyUnit ? std::min(block.minUnit, unit) : unit;
+					block.maxUnit = anyUnit ? std::max(block.maxUnit, unit) : unit;
+					anyUnit = true;
+				}
+			}
+		}
+
+		std::vector<std::byte> bytes;
+		bytes.reserve(rows.size() * (columns.size() + 1) * 2);
+		uint64_t previousTick = block.minTick;
+		for (const auto& row : rows)
+		{
+			appendVarint(bytes, row.tick - previousTick);
+			previousTick = row.tick;
+		}
+		for (const auto field : columns)
+		{
+			int64_t previous = 0;
+			for (auto& row : rows)
+			{
+				const uint32_t value = fieldOf(row, field);
+				if (isUnitField(field))
+				{
+					appendVarint(bytes, zigzagEncode(int64_t{value} - previous));
+					previous = value;
+				}
+				else
+				{
+					appendVarint(bytes, value);
+				}
+			}
+		}
+
+		_stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		block.size = bytes.size();
+		_offset += bytes.size();
+		_blocks.push_back(block);
+		rows.clear();
+	}
+
+	void EventArchiveWriter::finish()
+	{
+		_finished = true;
+		for (size_t kind = 0; kind < core::EventKindCount; ++kind)
+		{
+			writeBlock(static_cast<EventKind>(kind));
+		}
+
+		std::vector<std::byte> footer;
+		core::SnapshotWriter writer(footer);
+		writer.write(static_cast<uint32_t>(_unitTypes.size()));
+		for (const auto& name : _unitTypes)
+		{
+			writer.visit("unitType", name);
+		}
+		writer.write(static_cast<uint64_t>(_blocks.size()));
+		for (const auto& block : _blocks)
+		{
+			writer.write(static_cast<uint8_t>(block.kind));
+			writer.write(block.count);
+			writer.write(block.minTick);
+			writer.write(block.maxTick);
+			writer.write(block.minUnit);
+			writer.write(block.maxUnit);
+			writer.write(block.offset);
+			writer.write(block.size);
+		}
+		writer.write(_offset);
+		writer.writeBytes(std::as_bytes(std::span(Magic)));
+
+		_stream.write(reinterpret_cast<const char*>(footer.data()), static_cast<std::streamsize>(footer.size()));
+		_stream.close();
+		if (!_stream)
+		{
+			throw std::runtime_error("Failed to write event archive: " + _path);
+		}
+	}
+
+	void EventArchiveWriter::onMapCreated(uint32_t width, uint32_t height)
+	{
+		record(GameEvent{.kind = EventKind::MapCreated, .pos = core::Position{width, height}});
+	}
+
+	void EventArchiveWriter::onUnitSpawned(core::UnitId unit, std::string_view unitType, core::Position pos)
+	{
+		// Unit types outlive the pending rows (they are string literals, as for EventBus batches)
+		record(
+			GameEvent{.kind = EventKind::UnitSpawned, .unit = unit, .pos = pos, .unitType = unitType},
+			internUnitType(unitType));
+	}
+
+	void EventArchiveWriter::onMarchStarted(core::UnitId unit, core::Position from, core::Position target)
+	{
+		record(GameEvent{.kind = EventKind::MarchStarted, .unit = unit, .pos = from, .to = target});
+	}
+
+	void EventArchiveWriter::onUnitAttacked(
+		core::UnitId attacker, core::UnitId target, uint32_t damage, uint32_t targetHp)
+	{
+		record(GameEvent{
+			.kind = EventKind::UnitAttacked,
+			.unit = attacker,
+			.target = target,
+			.damage = damage,
+			.targetHp = targetHp});
+	}
+
+	void EventArchiveWriter::onUnitMoved(core::UnitId unit, core::Position from, core::Position to)
+	{
+		record(GameEvent{.kind = EventKind::UnitMoved, .unit = unit, .pos = from, .to = to});
+	}
+
+	void EventArchiveWriter::onUnitDied(core::UnitId unit)
+	{
+		record(GameEvent{.kind = EventKind::UnitDied, .unit = unit});
+	}
+
+	void EventArchiveWriter::onMarchEnded(core::UnitId unit, core::Position pos)
+	{
+		record(GameEvent{.kind = EventKind::MarchEnded, .unit = unit, .pos = pos});
+	}
+
+	EventArchiveReader::EventArchiveReader(const std::string& path) :
+			_file(path)
+	{
+		const auto bytes = _file.bytes();
+		if (bytes.size() < sizeof(Magic) + TrailerSize || std::memcmp(bytes.data(), Magic, sizeof(Magic)) != 0
+			|| std::memcmp(bytes.data() + bytes.size() - sizeof(Magic), Magic, sizeof(Magic)) != 0)
+		{
+			throw std::runtime_error("Not a complete event archive: " + path);
+		}
+
+		uint64_t footerOffset{};
+		std::memcpy(&footerOffset, bytes.data() + bytes.size() - TrailerSize, sizeof(footerOffset));
+		if (footerOffset < sizeof(Magic) || footerOffset > bytes.size() - TrailerSize)
+		{
+			throw std::runtime_error("Corrupt event archive footer: " + path);
+		}
+
+		core::SnapshotReader reader(bytes.subspan(footerOffset, bytes.size() - TrailerSize - footerOffset));
+		_unitTypes.resize(reader.read<uint32_t>());
+		for (auto& name : _unitTypes)
+		{
+			reader.visit("unitType", name);
+		}
+		_blocks.resize(reader.read<uint64_t>());
+		for (auto& block : _blocks)
+		{
+			const auto kind = reader.read<uint8_t>();
+			if (kind >= core::EventKindCount)
+			{
+				throw std::runtime_error("Corrupt event archive index: " + path);
+			}
+			block.kind = static_cast<EventKind>(kind);
+			block.count = reader.read<uint32_t>();
+			block.minTick = reader.read<uint64_t>();
+			block.maxTick = reader.read<uint64_t>();
+			block.minUnit = reader.read<core::UnitId>();
+			block.maxUnit = reader.read<core::UnitId>();
+			block.offset = reader.read<uint64_t>();
+			block.size = reader.read<uint64_t>();
+			if (block.offset > footerOffset || block.size > footerOffset - block.offset)
+			{
+				throw std::runtime_error("Corrupt event archive index: " + path);
+			}
+		}
+	}
+
+	void EventArchiveReader::decodeBlock(const ArchiveBlockInfo& block, std::vector<ArchivedEvent>& rows) const
+	{
+		rows.assign(block.count, ArchivedEvent{0, GameEvent{.kind = block.kind}});
+		VarintReader reader(_file.bytes().subspan(block.offset, block.size));
+		uint64_t tick = block.minTick;
+		for (auto& row : rows)
+		{
+			tick += reader.read();
+			row.tick = tick;
+		}
+
+		for (const auto field : columnsOf(block.kind))
+		{
+			int64_t previous = 0;
+			for (auto& row : rows)
+			{
+				const uint64_t value = reader.read();
+				if (isUnitField(field))
+				{
+					previous += zigzagDecode(value);
+					fieldOf(row, field) = static_cast<uint32_t>(previous);
+				}
+				else if (field == Field::UnitType)
+				{
+					if (value >= _unitTypes.size())
+					{
+						throw std::runtime_error("Corrupt event archive block: unknown unit type");
+					}
+					row.unitTypeIndex = static_cast<uint32_t>(value);
+					row.event.unitType = _unitTypes[value];
+				}
+				else
+				{
+					fieldOf(row, field) = static_cast<uint32_t>(value);
+				}
+			}
+		}
+	}
+
+	ArchiveQueryStats EventArchiveReader::query(
+		const ArchiveQuery& query, core::FunctionRef<void(const ArchivedEvent&)> visitor) const
+	{
+		ArchiveQueryStats stats;
+		std::vector<ArchivedEvent> rows;
+		for (const auto& block : _blocks)
+		{
+			const bool mayMatch = (query.kinds & core::eventBit(block.kind)) && block.maxTick >= query.fromTick
+								  && block.minTick <= query.toTick
+								  && (!query.unit
+									  || (block.kind != EventKind::MapCreated && *query.unit >= block.minUnit
+										  && *query.unit <= block.maxUnit));
+			if (!mayMatch)
+			{
+				++stats.blocksSkipped;
+				continue;
+			}
+
+			++stats.blocksRead;
+			decodeBlock(block, rows);
+			// Rows are in tick order: find the range instead of testing every row
+			const auto first = std::partition_point(
+				rows.begin(), rows.end(), [&](const ArchivedEvent& row) { return row.tick < query.fromTick; });
+			for (auto row = first; row != rows.end() && row->tick <= query.toTick; ++row)
+			{
+				if (!query.unit || namesUnit(row->event, *query.unit))
+				{
+					visitor(*row);
+				}
+			}
+		}
+		return stats;
+	}
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "../../Core/EventBus.hpp"
+#include "../../Core/FunctionRef.hpp"
+#include "../../Core/IGameEvents.hpp"
+#include "MappedFile.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sw::io
+{
+	// Event archives (.swa) store events by type in blocks of up to EventArchiveWriter::BlockEvents rows.
+	// Each block holds one column per field: ticks and unit IDs as varint deltas (unit IDs zigzag-encoded),
+	// other fields as plain varints. A footer indexes every block with its tick and unit ID ranges, so queries
+	// skip blocks without decoding them:
+	//     "SWARC001", blocks, footer (unit type names, block index), u64 footer offset, "SWARC001"
+	struct ArchivedEvent
+	{
+		uint64_t tick;
+		core::GameEvent event;
+		// UnitSpawned: index of event.unitType in the archive's unit type names
+		uint32_t unitTypeIndex{};
+	};
+
+	struct ArchiveBlockInfo
+	{
+		core::EventKind kind;
+		uint32_t count;
+		uint64_t minTick;
+		uint64_t maxTick;
+		// Over every unit field of the rows (attacker and target for attacks); 0..0 for map events
+		core::UnitId minUnit;
+		core::UnitId maxUnit;
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	/// @brief Event sink that writes an event archive.
+	/// Rows are buffered per event type and written a block at a time; finish() (or the destructor) writes the
+	/// partly filled blocks and the footer.
+	class EventArchiveWriter final : public core::IGameEvents
+	{
+	public:
+		static constexpr uint32_t BlockEvents = 4096;
+
+	private:
+		std::ofstream _stream;
+		std::string _path;
+		// Tick the events belong to, kept current by the caller (as for GameLogger)
+		const uint64_t& _tick;
+		std::array<std::vector<ArchivedEvent>, core::EventKindCount> _pending;
+		std::vector<ArchiveBlockInfo> _blocks;
+		// Interned names; rows store their index
+		std::vector<std::string> _unitTypes;
+		uint64_t _offset{};
+		bool _finished{false};
+
+		void record(const core::GameEvent& event, uint32_t unitTypeIndex = 0);
+		void writeBlock(core::EventKind kind);
+		uint32_t internUnitType(std::string_view unitType);
+
+	public:
+		EventArchiveWriter(const std::string& path, const uint64_t& tick);
+		~EventArchiveWriter() override;
+
+		EventArchiveWriter(const EventArchiveWriter&) = delete;
+		EventArchiveWriter& operator=(const EventArchiveWriter&) = delete;
+
+		// Writes the remaining rows and the footer; throws std::runtime_error if the file could not be written
+		void finish();
+
+		void onMapCreated(uint32_t width, uint32_t height) override;
+		void onUnitSpawned(core::UnitId unit, std::string_view unitType, core::Position pos) override;
+		void onMarchStarted(core::UnitId unit, core::Position from, core::Position target) override;
+		void onUnitAttacked(core::UnitId attacker, core::UnitId target, uint32_t damage, uint32_t targetHp) override;
+		void onUnitMoved(core::UnitId unit, core::Position from, core::Position to) override;
+		void onUnitDied(core::UnitId unit) override;
+		void onMarchEnded(core::UnitId unit, core::Position pos) override;
+	};
+
+	struct ArchiveQuery
+	{
+		core::EventMask kinds{core::AllEvents};
+		// Inclusive tick range
+		uint64_t fromTick{0};
+		uint64_t toTick{std::numeric_limits<uint64_t>::max()};
+		// Matches events naming the unit in any role (e.g. attacker or target)
+		std::optional<core::UnitId> unit;
+	};
+
+	struct ArchiveQueryStats
+	{
+		size_t blocksRead{};
+		size_t blocksSkipped{};
+	};
+
+	/// @brief Reads an event archive through a memory mapping; only blocks that may match a query are decoded.
+	class EventArchiveReader
+	{
+	private:
+		MappedFile _file;
+		std::vector<std::string> _unitTypes;
+		std::vector<ArchiveBlockInfo> _blocks;
+
+		void decodeBlock(const ArchiveBlockInfo& block, std::vector<ArchivedEvent>& rows) const;
+
+	public:
+		// Throws std::runtime_error if the file is not a complete archive
+		explicit EventArchiveReader(const std::string& path);
+
+		[[nodiscard]]
+		const std::vector<ArchiveBlockInfo>& getBlocks() const noexcept
+		{
+			return _blocks;
+		}
+
+		// Visits matching events block by block: by tick within an event type, types in file order.
+		// Unit type views stay valid while the reader lives.
+		ArchiveQueryStats query(
+			const ArchiveQuery& query, core::FunctionRef<void(const ArchivedEvent&)> visitor) const;
+	};
+}
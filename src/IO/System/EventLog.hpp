@@ -1,23 +1,70 @@
 #pragma once
 
-#include "details/PrintFieldVisitor.hpp"
+#include "details/FormatFieldVisitor.hpp"
 
-#include <iostream>
-#include <typeindex>
-#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
 namespace sw
 {
+	/// @brief Writes `[tick] NAME field=value ... ` lines.
+	/// Lines are rendered into a reusable buffer and handed to the stream in blocks; call flush() where a reader
+	/// may be waiting on the output (the destructor flushes too).
 	class EventLog
 	{
+	private:
+		static constexpr size_t BlockSize = size_t{64} << 10;
+
+		std::ostream& _stream;
+		std::string _buffer;
+
 	public:
+		explicit EventLog(std::ostream& stream) :
+				_stream(stream)
+		{
+			_buffer.reserve(BlockSize + 256);
+		}
+
+		EventLog(const EventLog&) = delete;
+		EventLog& operator=(const EventLog&) = delete;
+
+		~EventLog()
+		{
+			flush();
+		}
+
 		template <class TEvent>
 		void log(uint64_t tick, TEvent&& event)
 		{
-			std::cout << "[" << tick << "] " << TEvent::Name << " ";
-			PrintFieldVisitor visitor(std::cout);
+			using Event = std::remove_cvref_t<TEvent>;
+			static constexpr std::string_view name = Event::Name;
+
+			_buffer += '[';
+			FormatFieldVisitor::appendNumber(_buffer, tick);
+			_buffer += "] ";
+			_buffer += name;
+			_buffer += ' ';
+			FormatFieldVisitor visitor(_buffer, details::fieldPrefixes<Event>());
 			event.visit(visitor);
-			std::cout << std::endl;
+			_buffer += '\n';
+
+			if (_buffer.size() >= BlockSize)
+			{
+				_stream.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+				_buffer.clear();
+			}
+		}
+
+		// Writes buffered lines and flushes the stream
+		void flush()
+		{
+			_stream.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+			_buffer.clear();
+			_stream.flush();
 		}
 	};
 }
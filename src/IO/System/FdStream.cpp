@@ -0,0 +1,103 @@
+#include "FdStream.hpp"
+
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <cerrno>
+	#include <unistd.h>
+	#define SW_HAS_FD_IO 1
+#endif
+
+namespace sw::io
+{
+	namespace
+	{
+		constexpr size_t BufferSize = 64 * 1024;
+	}
+
+	FdStreamBuf::FdStreamBuf(int fd) :
+			_fd(fd),
+			_input(BufferSize),
+			_output(BufferSize)
+	{
+#if !defined(SW_HAS_FD_IO)
+		throw std::runtime_error("File descriptor streams are not supported on this platform");
+#endif
+		setg(_input.data(), _input.data(), _input.data());
+		setp(_output.data(), _output.data() + _output.size());
+	}
+
+	FdStreamBuf::~FdStreamBuf()
+	{
+		flushOutput();
+	}
+
+	FdStreamBuf::int_type FdStreamBuf::underflow()
+	{
+#if defined(SW_HAS_FD_IO)
+		if (gptr() < egptr())
+		{
+			return traits_type::to_int_type(*gptr());
+		}
+
+		ssize_t count;
+		do
+		{
+			count = ::read(_fd, _input.data(), _input.size());
+		} while (count < 0 && errno == EINTR);
+
+		if (count <= 0)
+		{
+			return traits_type::eof();
+		}
+		setg(_input.data(), _input.data(), _input.data() + count);
+		return traits_type::to_int_type(*gptr());
+#else
+		return traits_type::eof();
+#endif
+	}
+
+	FdStreamBuf::int_type FdStreamBuf::overflow(int_type ch)
+	{
+		if (!flushOutput())
+		{
+			return traits_type::eof();
+		}
+		if (!traits_type::eq_int_type(ch, traits_type::eof()))
+		{
+			*pptr() = traits_type::to_char_type(ch);
+			pbump(1);
+		}
+		return traits_type::not_eof(ch);
+	}
+
+	int FdStreamBuf::sync()
+	{
+		return flushOutput() ? 0 : -1;
+	}
+
+	bool FdStreamBuf::flushOutput()
+	{
+#if defined(SW_HAS_FD_IO)
+		const char* data = pbase();
+		const char* end = pptr();
+		while (data < end)
+		{
+			const ssize_t count = ::write(_fd, data, static_cast<size_t>(end - data));
+			if (count < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				return false;
+			}
+			data += count;
+		}
+		setp(_output.data(), _output.data() + _output.size());
+		return true;
+#else
+		return false;
+#endif
+	}
+}
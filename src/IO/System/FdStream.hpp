@@ -0,0 +1,31 @@
+#pragma once
+
+#include <streambuf>
+#include <vector>
+
+namespace sw::io
+{
+	/// @brief Buffered std::streambuf over a POSIX file descriptor (socket or pipe); one object serves both an
+	/// std::istream and an std::ostream. The descriptor is not owned. Elsewhere construction throws.
+	class FdStreamBuf : public std::streambuf
+	{
+	private:
+		int _fd;
+		std::vector<char> _input;
+		std::vector<char> _output;
+
+		bool flushOutput();
+
+	protected:
+		int_type underflow() override;
+		int_type overflow(int_type ch) override;
+		int sync() override;
+
+	public:
+		explicit FdStreamBuf(int fd);
+		~FdStreamBuf() override;
+
+		FdStreamBuf(const FdStreamBuf&) = delete;
+		FdStreamBuf& operator=(const FdStreamBuf&) = delete;
+	};
+}
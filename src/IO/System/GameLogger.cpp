@@ -8,8 +8,6 @@
 #include "../Events/UnitMoved.hpp"
 #include "../Events/UnitSpawned.hpp"
 
-#include <string>
-
 namespace sw::io
 {
 	GameLogger::GameLogger(sw::EventLog& log, uint64_t& tickRef) :
@@ -24,7 +22,7 @@ namespace sw::io
 
 	void GameLogger::onUnitSpawned(sw::core::UnitId unit, std::string_view unitType, sw::core::Position pos)
 	{
-		_log.log(_tick, UnitSpawned{unit, std::string(unitType), pos.x, pos.y});
+		_log.log(_tick, UnitSpawned{unit, unitType, pos.x, pos.y});
 	}
 
 	void GameLogger::onMarchStarted(sw::core::UnitId unit, sw::core::Position from, sw::core::Position target)
@@ -0,0 +1,300 @@
+#include "LogIndex.hpp"
+
+#include "Varint.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace sw::io
+{
+	namespace
+	{
+		static_assert(std::endian::native == std::endian::little, "Log indexes are read by direct copy");
+
+		constexpr char Magic[8] = {'S', 'W', 'L', 'I', 'D', 'X', '0', '1'};
+		constexpr size_t HeaderSize = sizeof(Magic) + 4 * sizeof(uint64_t);
+		constexpr size_t TickEntrySize = 2 * sizeof(uint64_t);
+		constexpr size_t UnitEntrySize = 2 * sizeof(uint32_t) + sizeof(uint64_t);
+
+		struct Posting
+		{
+			std::vector<std::byte> offsets;
+			uint64_t last{};
+			uint32_t count{};
+		};
+
+		template <typename T>
+		T readAt(std::span<const std::byte> bytes, size_t offset)
+		{
+			T value{};
+			std::memcpy(&value, bytes.data() + offset, sizeof(T));
+			return value;
+		}
+
+		template <typename T>
+		void writeRaw(std::ofstream& stream, const T& value)
+		{
+			stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		std::string_view asText(std::span<const std::byte> bytes)
+		{
+			return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+		}
+
+		// Line starting at `offset`, without its '\n'
+		std::string_view lineAt(std::string_view text, size_t offset)
+		{
+			const size_t end = text.find('\n', offset);
+			return text.substr(offset, (end == std::string_view::npos ? text.size() : end) - offset);
+		}
+
+		// Tick of a `[tick] ...` line; std::nullopt for other lines
+		std::optional<uint64_t> parseTick(std::string_view line, std::string_view& rest)
+		{
+			if (!line.starts_with('['))
+			{
+				return std::nullopt;
+			}
+			uint64_t tick{};
+			const char* end = line.data() + line.size();
+			const auto [next, error] = std::from_chars(line.data() + 1, end, tick);
+			if (error != std::errc{} || next == end || *next != ']')
+			{
+				return std::nullopt;
+			}
+			rest = std::string_view(next + 1, end);
+			return tick;
+		}
+
+		bool isUnitField(std::string_view key)
+		{
+			return key == "unitId" || key.ends_with("UnitId");
+		}
+	}
+
+	void buildLogIndex(const std::string& logPath, const std::string& indexPath)
+	{
+		MappedFile log(logPath);
+		const auto text = asText(log.bytes());
+
+		std::vector<std::pair<uint64_t, uint64_t>> ticks;
+		std::unordered_map<core::UnitId, Posting> postings;
+		uint64_t lineNumber = 0;
+		for (size_t offset = 0; offset < text.size();)
+		{
+			const auto line = lineAt(text, offset);
+			++lineNumber;
+			std::string_view fields;
+			if (const auto tick = parseTick(line, fields))
+			{
+				if (ticks.empty() || ticks.back().first != *tick)
+				{
+					if (!ticks.empty() && *tick < ticks.back().first)
+					{
+						throw std::runtime_error("line " + std::to_string(lineNumber) + ": tick goes backwards");
+					}
+					ticks.emplace_back(*tick, offset);
+				}
+
+				// " NAME key=value key=value "
+				while (!fields.empty())
+				{
+					const size_t space = fields.find(' ');
+					const auto token = fields.substr(0, space);
+					fields.remove_prefix(space == std::string_view::npos ? fields.size() : space + 1);
+					const size_t equals = token.find('=');
+					if (equals == std::string_view::npos || !isUnitField(token.substr(0, equals)))
+					{
+						continue;
+					}
+
+					core::UnitId unit{};
+					const auto value = token.substr(equals + 1);
+					const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), unit);
+					if (error != std::errc{} || end != value.data() + value.size())
+					{
+						throw std::runtime_error(
+							"line " + std::to_string(lineNumber) + ": invalid unit ID: " + std::string(value));
+					}
+					auto& posting = postings[unit];
+					// A line naming the unit twice is listed once
+					if (posting.count == 0 || posting.last != offset)
+					{
+						appendVarint(posting.offsets, offset - posting.last);
+						posting.last = offset;
+						++posting.count;
+					}
+				}
+			}
+			offset += line.size() + 1;
+		}
+
+		std::vector<core::UnitId> units;
+		units.reserve(postings.size());
+		uint64_t postingsSize = 0;
+		for (const auto& [unit, posting] : postings)
+		{
+			units.push_back(unit);
+			postingsSize += posting.offsets.size();
+		}
+		std::sort(units.begin(), units.end());
+
+		std::ofstream stream(indexPath, std::ios::binary | std::ios::trunc);
+		if (!stream.is_open())
+		{
+			throw std::runtime_error("Failed to open file: " + indexPath);
+		}
+		stream.write(Magic, sizeof(Magic));
+		writeRaw(stream, static_cast<uint64_t>(text.size()));
+		writeRaw(stream, static_cast<uint64_t>(ticks.size()));
+		writeRaw(stream, static_cast<uint64_t>(units.size()));
+		writeRaw(stream, postingsSize);
+		for (const auto& [tick, offset] : ticks)
+		{
+			writeRaw(stream, tick);
+			writeRaw(stream, offset);
+		}
+		uint64_t postingsOffset = 0;
+		for (const auto unit : units)
+		{
+			const auto& posting = postings[unit];
+			writeRaw(stream, unit);
+			writeRaw(stream, posting.count);
+			writeRaw(stream, postingsOffset);
+			postingsOffset += posting.offsets.size();
+		}
+		for (const auto unit : units)
+		{
+			const auto& offsets = postings[unit].offsets;
+			stream.write(reinterpret_cast<const char*>(offsets.data()), static_cast<std::streamsize>(offsets.size()));
+		}
+		if (!stream)
+		{
+			throw std::runtime_error("Failed to write log index: " + indexPath);
+		}
+	}
+
+	IndexedLog::IndexedLog(const std::string& logPath, const std::string& indexPath) :
+			_log(logPath),
+			_index(indexPath)
+	{
+		const auto bytes = _index.bytes();
+		if (bytes.size() < HeaderSize || std::memcmp(bytes.data(), Magic, sizeof(Magic)) != 0)
+		{
+			throw std::runtime_error("Not a log index: " + indexPath);
+		}
+		if (readAt<uint64_t>(bytes, sizeof(Magic)) != _log.bytes().size())
+		{
+			throw std::runtime_error("Log index is out of date: " + indexPath);
+		}
+
+		_tickCount = readAt<uint64_t>(bytes, sizeof(Magic) + sizeof(uint64_t));
+		_unitCount = readAt<uint64_t>(bytes, sizeof(Magic) + 2 * sizeof(uint64_t));
+		const auto postingsSize = readAt<uint64_t>(bytes, sizeof(Magic) + 3 * sizeof(uint64_t));
+		// Bound the counts by the payload before multiplying, so corrupt headers cannot wrap the sizes around
+		const uint64_t payloadSize = bytes.size() - HeaderSize;
+		if (_tickCount > payloadSize / TickEntrySize || _unitCount > payloadSize / UnitEntrySize)
+		{
+			throw std::runtime_error("Log index size does not match its header: " + indexPath);
+		}
+		const uint64_t ticksSize = _tickCount * TickEntrySize;
+		const uint64_t unitsSize = _unitCount * UnitEntrySize;
+		if (ticksSize > payloadSize - unitsSize || payloadSize - ticksSize - unitsSize != postingsSize)
+		{
+			throw std::runtime_error("Log index size does not match its header: " + indexPath);
+		}
+		_ticks = bytes.subspan(HeaderSize, ticksSize);
+		_units = bytes.subspan(HeaderSize + ticksSize, unitsSize);
+		_postings = bytes.subspan(HeaderSize + ticksSize + unitsSize);
+	}
+
+	void IndexedLog::forEachLineInTicks(
+		uint64_t fromTick, uint64_t toTick, core::FunctionRef<void(std::string_view)> visitor) const
+	{
+		// First tick entry >= fromTick
+		uint64_t low = 0;
+		uint64_t high = _tickCount;
+		while (low < high)
+		{
+			const uint64_t mid = low + (high - low) / 2;
+			if (readAt<uint64_t>(_ticks, mid * TickEntrySize) < fromTick)
+			{
+				low = mid + 1;
+			}
+			else
+			{
+				high = mid;
+			}
+		}
+		if (low == _tickCount)
+		{
+			return;
+		}
+
+		const auto text = asText(_log.bytes());
+		for (size_t offset = readAt<uint64_t>(_ticks, low * TickEntrySize + sizeof(uint64_t)); offset < text.size();)
+		{
+			const auto line = lineAt(text, offset);
+			std::string_view fields;
+			const auto tick = parseTick(line, fields);
+			if (tick && *tick > toTick)
+			{
+				return;
+			}
+			if (tick)
+			{
+				visitor(line);
+			}
+			offset += line.size() + 1;
+		}
+	}
+
+	void IndexedLog::forEachLineOfUnit(core::UnitId unit, core::FunctionRef<void(std::string_view)> visitor) const
+	{
+		uint64_t low = 0;
+		uint64_t high = _unitCount;
+		while (low < high)
+		{
+			const uint64_t mid = low + (high - low) / 2;
+			if (readAt<core::UnitId>(_units, mid * UnitEntrySize) < unit)
+			{
+				low = mid + 1;
+			}
+			else
+			{
+				high = mid;
+			}
+		}
+		if (low == _unitCount || readAt<core::UnitId>(_units, low * UnitEntrySize) != unit)
+		{
+			return;
+		}
+
+		const auto count = readAt<uint32_t>(_units, low * UnitEntrySize + sizeof(core::UnitId));
+		const auto postingsOffset = readAt<uint64_t>(_units, low * UnitEntrySize + 2 * sizeof(uint32_t));
+		if (postingsOffset > _postings.size())
+		{
+			throw std::runtime_error("Corrupt log index postings");
+		}
+		const auto text = asText(_log.bytes());
+		VarintReader reader(_postings.subspan(postingsOffset));
+		uint64_t offset = 0;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			offset += reader.read();
+			if (offset >= text.size())
+			{
+				throw std::runtime_error("Corrupt log index postings");
+			}
+			visitor(lineAt(text, offset));
+		}
+	}
+}
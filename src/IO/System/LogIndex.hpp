@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../../Core/FunctionRef.hpp"
+#include "../../Core/Types.hpp"
+#include "MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace sw::io
+{
+	// Sidecar index for a text event log (`[tick] EVENT field=value ...` lines):
+	//     "SWLIDX01", u64 log size, u64 tick count, u64 unit count, u64 postings size,
+	//     tick entries (u64 tick, u64 offset of its first line), ascending by tick,
+	//     unit entries (u32 unit, u32 line count, u64 postings offset), ascending by unit,
+	//     postings: per unit, the offsets of lines naming it (any `unitId` / `...UnitId` field) as varint deltas.
+	// Fixed-size tables are binary-searched in the mapped file, so lookups touch a few pages of index and log.
+
+	// Builds the index of `logPath` in one pass over the mapped log and writes it to `indexPath`.
+	// Throws std::runtime_error on unreadable files, malformed lines or ticks that go backwards.
+	void buildLogIndex(const std::string& logPath, const std::string& indexPath);
+
+	/// @brief A text event log opened together with its index.
+	class IndexedLog
+	{
+	private:
+		MappedFile _log;
+		MappedFile _index;
+		uint64_t _tickCount{};
+		uint64_t _unitCount{};
+		std::span<const std::byte> _ticks;
+		std::span<const std::byte> _units;
+		std::span<const std::byte> _postings;
+
+	public:
+		// Throws std::runtime_error if the index is missing, malformed or was built for a log of another size
+		IndexedLog(const std::string& logPath, const std::string& indexPath);
+
+		// Visits the lines (without '\n') whose tick lies in [fromTick, toTick], in log order
+		void forEachLineInTicks(
+			uint64_t fromTick, uint64_t toTick, core::FunctionRef<void(std::string_view)> visitor) const;
+
+		// Visits the lines naming `unit`, in log order
+		void forEachLineOfUnit(core::UnitId unit, core::FunctionRef<void(std::string_view)> visitor) const;
+
+		[[nodiscard]]
+		uint64_t getTickCount() const noexcept
+		{
+			return _tickCount;
+		}
+
+		[[nodiscard]]
+		uint64_t getUnitCount() const noexcept
+		{
+			return _unitCount;
+		}
+	};
+}
@@ -0,0 +1,101 @@
+#include "MappedFile.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#define SW_HAS_MMAP 1
+#endif
+
+namespace sw::io
+{
+	MappedFile::MappedFile(const std::string& path)
+	{
+#if defined(SW_HAS_MMAP)
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			throw std::runtime_error("Failed to open file: " + path);
+		}
+
+		struct stat info{};
+		if (::fstat(fd, &info) != 0)
+		{
+			::close(fd);
+			throw std::runtime_error("Failed to stat file: " + path);
+		}
+
+		if (!S_ISREG(info.st_mode))
+		{
+			// Pipes and devices report no size and cannot be mapped: read them to the end instead
+			constexpr size_t ChunkSize = size_t{64} << 10;
+			for (;;)
+			{
+				const size_t used = _buffer.size();
+				_buffer.resize(used + ChunkSize);
+				const ssize_t count = ::read(fd, _buffer.data() + used, ChunkSize);
+				if (count < 0 && errno == EINTR)
+				{
+					_buffer.resize(used);
+					continue;
+				}
+				if (count < 0)
+				{
+					::close(fd);
+					throw std::runtime_error("Failed to read file: " + path);
+				}
+				_buffer.resize(used + static_cast<size_t>(count));
+				if (count == 0)
+				{
+					break;
+				}
+			}
+			::close(fd);
+			_data = _buffer.data();
+			_size = _buffer.size();
+			return;
+		}
+
+		_size = static_cast<size_t>(info.st_size);
+		if (_size > 0)
+		{
+			void* mapping = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping == MAP_FAILED)
+			{
+				::close(fd);
+				throw std::runtime_error("Failed to map file: " + path);
+			}
+			_mapping = mapping;
+			_data = static_cast<const std::byte*>(mapping);
+		}
+		::close(fd);
+#else
+		std::ifstream stream(path, std::ios::binary | std::ios::ate);
+		if (!stream.is_open())
+		{
+			throw std::runtime_error("Failed to open file: " + path);
+		}
+
+		_buffer.resize(static_cast<size_t>(stream.tellg()));
+		stream.seekg(0);
+		stream.read(reinterpret_cast<char*>(_buffer.data()), static_cast<std::streamsize>(_buffer.size()));
+		_data = _buffer.data();
+		_size = _buffer.size();
+#endif
+	}
+
+	MappedFile::~MappedFile()
+	{
+#if defined(SW_HAS_MMAP)
+		if (_mapping)
+		{
+			::munmap(_mapping, _size);
+		}
+#endif
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace sw::io
+{
+	/// @brief Read-only view of a whole file.
+	/// Memory-mapped on POSIX systems; elsewhere, and for pipes and other non-regular files, the file is read into an
+	/// owned buffer.
+	class MappedFile
+	{
+	private:
+		const std::byte* _data{};
+		size_t _size{};
+		void* _mapping{};
+		std::vector<std::byte> _buffer;
+
+	public:
+		explicit MappedFile(const std::string& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		[[nodiscard]]
+		std::span<const std::byte> bytes() const noexcept
+		{
+			return {_data, _size};
+		}
+	};
+}
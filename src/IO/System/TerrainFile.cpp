@@ -0,0 +1,71 @@
+#include "TerrainFile.hpp"
+
+#include "MappedFile.hpp"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace sw::io
+{
+	namespace
+	{
+		static_assert(std::endian::native == std::endian::little, "Terrain files are read by direct copy");
+
+		constexpr char Magic[8] = {'S', 'W', 'T', 'E', 'R', 'R', '0', '1'};
+		constexpr size_t HeaderSize = sizeof(Magic) + 2 * sizeof(uint32_t);
+	}
+
+	core::CellBitmap loadTerrain(const std::string& path)
+	{
+		MappedFile file(path);
+		const auto bytes = file.bytes();
+		if (bytes.size() < HeaderSize || std::memcmp(bytes.data(), Magic, sizeof(Magic)) != 0)
+		{
+			throw std::runtime_error("Not a terrain file: " + path);
+		}
+
+		uint32_t width{};
+		uint32_t height{};
+		std::memcpy(&width, bytes.data() + sizeof(Magic), sizeof(width));
+		std::memcpy(&height, bytes.data() + sizeof(Magic) + sizeof(width), sizeof(height));
+
+		// Check the payload against the header before allocating: rows are padded to whole words, as in CellBitmap
+		const uint64_t rowWords = (uint64_t{width} + 63) / 64;
+		const uint64_t payloadBytes = bytes.size() - HeaderSize;
+		if (payloadBytes % sizeof(uint64_t) != 0 || (height != 0 && rowWords > payloadBytes / sizeof(uint64_t) / height)
+			|| rowWords * height * sizeof(uint64_t) != payloadBytes)
+		{
+			throw std::runtime_error("Terrain file size does not match its header: " + path);
+		}
+
+		core::CellBitmap terrain(width, height);
+		const auto words = terrain.words();
+
+		std::memcpy(words.data(), bytes.data() + HeaderSize, words.size_bytes());
+		terrain.clearPadding();
+		return terrain;
+	}
+
+	void saveTerrain(const std::string& path, const core::CellBitmap& terrain)
+	{
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+		if (!stream.is_open())
+		{
+			throw std::runtime_error("Failed to open file: " + path);
+		}
+
+		const uint32_t width = terrain.getWidth();
+		const uint32_t height = terrain.getHeight();
+		const auto words = terrain.words();
+		stream.write(Magic, sizeof(Magic));
+		stream.write(reinterpret_cast<const char*>(&width), sizeof(width));
+		stream.write(reinterpret_cast<const char*>(&height), sizeof(height));
+		stream.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(words.size_bytes()));
+		if (!stream)
+		{
+			throw std::runtime_error("Failed to write terrain file: " + path);
+		}
+	}
+}
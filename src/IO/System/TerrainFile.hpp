@@ -0,0 +1,16 @@
+#pragma once
+
+#include "../../Core/CellBitmap.hpp"
+
+#include <string>
+
+namespace sw::io
+{
+	// Binary terrain map:
+	//   8 bytes  magic "SWTERR01"
+	//   uint32   width, uint32 height (little-endian)
+	//   height rows of ceil(width / 64) little-endian uint64 words; bit (x % 64) of word (x / 64) marks cell (x, y)
+	// The payload is CellBitmap's own memory layout, so loading is a single copy out of the mapped file.
+	core::CellBitmap loadTerrain(const std::string& path);
+	void saveTerrain(const std::string& path, const core::CellBitmap& terrain);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace sw::io
+{
+	// LEB128: 7 bits per byte, low groups first, high bit set on all but the last byte
+	inline void appendVarint(std::vector<std::byte>& out, uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			out.push_back(static_cast<std::byte>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<std::byte>(value));
+	}
+
+	// Maps small signed deltas to small unsigned values: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+	[[nodiscard]]
+	constexpr uint64_t zigzagEncode(int64_t value) noexcept
+	{
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	[[nodiscard]]
+	constexpr int64_t zigzagDecode(uint64_t value) noexcept
+	{
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
+	/// @brief Sequential varint decoder over a byte range; throws std::runtime_error past the end.
+	class VarintReader
+	{
+	private:
+		std::span<const std::byte> _bytes;
+		size_t _offset{};
+
+	public:
+		explicit VarintReader(std::span<const std::byte> bytes) :
+				_bytes(bytes)
+		{}
+
+		[[nodiscard]]
+		bool atEnd() const noexcept
+		{
+			return _offset == _bytes.size();
+		}
+
+		uint64_t read()
+		{
+			uint64_t value = 0;
+			for (uint32_t shift = 0; shift < 64; shift += 7)
+			{
+				if (_offset == _bytes.size())
+				{
+					throw std::runtime_error("Truncated varint");
+				}
+				const auto byte = static_cast<uint8_t>(_bytes[_offset++]);
+				value |= uint64_t{byte & 0x7Fu} << shift;
+				if ((byte & 0x80) == 0)
+				{
+					return value;
+				}
+			}
+			throw std::runtime_error("Varint is too long");
+		}
+	};
+}
@@ -1,23 +1,56 @@
 #pragma once
 
-#include <iostream>
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
 namespace sw
 {
+	// Decodes whitespace-separated fields straight from the command line, in `visit` order
 	class CommandParserVisitor
 	{
 	private:
-		std::istream& _stream;
+		std::string_view _command;
+		std::string_view _args;
+
+		std::string_view nextToken(const char* name)
+		{
+			const auto begin = _args.find_first_not_of(" \t\r");
+			if (begin == std::string_view::npos)
+			{
+				throw std::runtime_error("Missing " + std::string(name) + " for " + std::string(_command));
+			}
+			_args.remove_prefix(begin);
+			const auto token = _args.substr(0, _args.find_first_of(" \t\r"));
+			_args.remove_prefix(token.size());
+			return token;
+		}
 
 	public:
-		CommandParserVisitor(std::istream& stream) :
-				_stream(stream)
+		CommandParserVisitor(std::string_view command, std::string_view args) :
+				_command(command),
+				_args(args)
 		{}
 
 		template <class TField>
-		void visit(const char*, TField& field)
+		void visit(const char* name, TField& field)
 		{
-			_stream >> field;
+			const auto token = nextToken(name);
+			if constexpr (std::is_integral_v<TField>)
+			{
+				const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), field);
+				if (error != std::errc{} || end != token.data() + token.size())
+				{
+					throw std::runtime_error(
+						"Invalid " + std::string(name) + " for " + std::string(_command) + ": " + std::string(token));
+				}
+			}
+			else
+			{
+				field = TField(token);
+			}
 		}
 	};
 }
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sw
+{
+	namespace details
+	{
+		// Collects the field names an event's visit() reports, in order
+		class FieldNameVisitor
+		{
+		private:
+			std::vector<std::string>& _prefixes;
+
+		public:
+			explicit FieldNameVisitor(std::vector<std::string>& prefixes) :
+					_prefixes(prefixes)
+			{}
+
+			template <typename T>
+			void visit(const char* name, const T&)
+			{
+				_prefixes.push_back(std::string(name) + '=');
+			}
+		};
+
+		// "name=" for every field of TEvent, built once per event type
+		template <class TEvent>
+		const std::vector<std::string>& fieldPrefixes()
+		{
+			static const std::vector<std::string> prefixes = []
+			{
+				std::vector<std::string> names;
+				FieldNameVisitor visitor(names);
+				TEvent{}.visit(visitor);
+				return names;
+			}();
+			return prefixes;
+		}
+	}
+
+	// Appends `name=value ` for each visited field to a reusable buffer; numbers go through std::to_chars.
+	// Byte-compatible with PrintFieldVisitor.
+	class FormatFieldVisitor
+	{
+	private:
+		std::string& _buffer;
+		const std::vector<std::string>& _prefixes;
+		size_t _field{};
+
+		void appendPrefix()
+		{
+			_buffer += _prefixes[_field++];
+		}
+
+	public:
+		FormatFieldVisitor(std::string& buffer, const std::vector<std::string>& prefixes) :
+				_buffer(buffer),
+				_prefixes(prefixes)
+		{}
+
+		template <std::integral T>
+		void visit(const char*, const T& value)
+		{
+			appendPrefix();
+			appendNumber(_buffer, value);
+			_buffer += ' ';
+		}
+
+		void visit(const char*, std::string_view value)
+		{
+			appendPrefix();
+			_buffer += value;
+			_buffer += ' ';
+		}
+
+		template <std::integral T>
+		static void appendNumber(std::string& buffer, T value)
+		{
+			char digits[24];
+			const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+			buffer.append(digits, result.ptr);
+		}
+	};
+}
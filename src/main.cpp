@@ -1,187 +1,233 @@
+#include "App/Checkpoint.hpp"
+#include "App/CompiledScenario.hpp"
+#include "App/DecisionLog.hpp"
+#include "App/EventStats.hpp"
+#include "App/HashTrace.hpp"
+#include "App/Options.hpp"
+#include "App/ScenarioRunner.hpp"
+#include "App/Server.hpp"
+#include "App/Simulation.hpp"
 #include "Core/GameWorld.hpp"
 #include "Core/IGameEvents.hpp"
-#include "Features/Behaviors/Utils.hpp"
-#include "Features/Components.hpp"
-#include "Features/Hunter.hpp"
-#include "Features/Swordsman.hpp"
-#include "IO/Commands/CreateMap.hpp"
-#include "IO/Commands/March.hpp"
-#include "IO/Commands/SpawnHunter.hpp"
-#include "IO/Commands/SpawnSwordsman.hpp"
-#include "IO/Events/MapCreated.hpp"
-#include "IO/System/CommandParser.hpp"
+#include "Core/NullEvents.hpp"
+#include "IO/System/EventArchive.hpp"
 #include "IO/System/EventLog.hpp"
 #include "IO/System/GameLogger.hpp"
+#include "IO/System/MappedFile.hpp"
 
+#include <filesystem>
 #include <fstream>
-#include <functional>
 #include <iostream>
 #include <memory>
+#include <random>
 #include <stdexcept>
 #include <string_view>
-#include <vector>
 
 using namespace sw;
 using namespace sw::core;
-using namespace sw::features;
 
 int main(int argc, char** argv)
 {
-	if (argc != 2)
+	app::Options options;
+	try
 	{
-		std::cerr << "Usage: " << argv[0] << " <scenario_file>" << std::endl;
-		return 1;
+		options = app::parseOptions(argc, argv);
 	}
-
-	std::ifstream stream(argv[1]);
-	if (!stream.is_open())
+	catch (const std::invalid_argument& e)
 	{
-		std::cerr << "Failed to open file: " << argv[1] << std::endl;
+		std::cerr << e.what() << std::endl << app::usage(argv[0]) << std::endl;
 		return 1;
 	}
 
-	io::CommandParser parser;
-	sw::EventLog logger;
-	uint64_t tick = 1;
-
-	// Create event adapter
-	auto eventAdapter = std::make_shared<io::GameLogger>(logger, tick);
+	if (options.serve || !options.serveSocketPath.empty())
+	{
+		// --- Server Mode ---
 
-	std::unique_ptr<GameWorld> map;
+		try
+		{
+			app::Server server(app::ServerOptions{options.workers});
+			if (!options.serveSocketPath.empty())
+			{
+				server.serveSocket(options.serveSocketPath);
+			}
+			std::ios::sync_with_stdio(false);
+			std::cin.tie(nullptr);
+			return server.serve(std::cin, std::cout) ? 0 : 1;
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Server error: " << e.what() << std::endl;
+			return 1;
+		}
+	}
 
-	// --- Setup Command Handlers ---
+	app::SimulationOptions simulation;
+	simulation.fastForward = options.fastForward;
+	simulation.fastForwardSilent = options.fastForwardSilent;
+	simulation.checkpointEvery = options.checkpointEvery;
+	simulation.onCheckpoint = [&](const GameWorld& world, uint64_t nextTick)
+	{
+		app::writeCheckpoint(options.checkpointPath, world, nextTick);
+	};
 
-	parser
-		.add<io::CreateMap>(
-			[&](auto command)
-			{
-				map = std::make_unique<GameWorld>(command.width, command.height);
-				eventAdapter->onMapCreated(command.width, command.height);
-			})
-		.add<io::SpawnSwordsman>(
-			[&](auto command)
+	if (options.resumePath.empty())
+	{
+		// --- Run Scenario ---
+
+		std::random_device entropy;
+		app::ScenarioOptions scenario;
+		scenario.seed = options.seed ? *options.seed : (uint64_t{entropy()} << 32) | entropy();
+		scenario.baseDirectory = std::filesystem::path(options.scenarioPath).parent_path();
+		scenario.hashTrace = options.hashTrace;
+		scenario.quiet = options.quiet;
+		scenario.logFromTick = options.logFromTick;
+		scenario.gridLayout = options.gridLayout.value_or(GridLayout::RowMajor);
+		scenario.parseThreads = options.parseThreads;
+		scenario.simulation = std::move(simulation);
+		app::EventStats stats;
+		std::unique_ptr<io::EventArchiveWriter> archive;
+		if (options.stats || !options.archivePath.empty())
+		{
+			scenario.subscribe = [&](EventBus& bus, const uint64_t& tick)
 			{
-				if (!map)
+				if (options.stats)
 				{
-					throw std::runtime_error("Map not created");
+					bus.subscribe(stats);
 				}
-
-				Position pos{command.x, command.y};
-				if (sw::features::utils::isCellBlocked(*map, pos))
+				if (!options.archivePath.empty())
 				{
-					throw std::runtime_error("Spawn position blocked");
+					archive = std::make_unique<io::EventArchiveWriter>(options.archivePath, tick);
+					bus.subscribe(*archive);
 				}
+			};
+		}
 
-				auto unit = std::make_unique<Swordsman>(
-					command.unitId, command.hp, command.strength);
+		std::unique_ptr<app::DecisionRecorder> recorder;
+		std::unique_ptr<app::DecisionReplayer> replayer;
+		try
+		{
+			if (!options.recordDecisionsPath.empty())
+			{
+				recorder = std::make_unique<app::DecisionRecorder>(options.recordDecisionsPath);
+				scenario.choices = recorder.get();
+			}
+			else if (!options.replayDecisionsPath.empty())
+			{
+				replayer = std::make_unique<app::DecisionReplayer>(options.replayDecisionsPath);
+				scenario.choices = replayer.get();
+			}
 
-				map->addUnit(std::move(unit), pos);
-				eventAdapter->onUnitSpawned(command.unitId, "Swordsman", pos);
-			})
-		.add<io::SpawnHunter>(
-			[&](auto command)
+			app::ScenarioRunner runner;
+			if (options.scenarioPath == "-")
+			{
+				// Streams the scenario from stdin, e.g. tick-tagged commands from a live controller
+				runner.run(std::cin, scenario, std::cout);
+			}
+			else if (!std::filesystem::is_regular_file(options.scenarioPath))
 			{
-				if (!map)
+				// FIFOs and process substitutions are streamed like stdin rather than read to their end first
+				std::ifstream stream(options.scenarioPath);
+				if (!stream.is_open())
 				{
-					throw std::runtime_error("Map not created");
+					throw std::runtime_error("Failed to open file: " + options.scenarioPath);
 				}
-
-				Position pos{command.x, command.y};
-				if (sw::features::utils::isCellBlocked(*map, pos))
+				runner.run(stream, scenario, std::cout);
+			}
+			else if (!options.scenarioCacheDirectory.empty())
+			{
+				const auto compiled = app::loadCachedScenario(options.scenarioPath, options.scenarioCacheDirectory);
+				runner.runCompiled(compiled.bytes(), scenario, std::cout);
+			}
+			else
+			{
+				io::MappedFile file(options.scenarioPath);
+				const auto bytes = file.bytes();
+				if (app::isCompiledScenario(bytes))
 				{
-					throw std::runtime_error("Spawn position blocked");
+					runner.runCompiled(bytes, scenario, std::cout);
 				}
-
-				auto unit = std::make_unique<Hunter>(
-					command.unitId,
-					command.hp,
-					command.agility,
-					command.strength,
-					command.range);
-
-				map->addUnit(std::move(unit), pos);
-				eventAdapter->onUnitSpawned(command.unitId, "Hunter", pos);
-			})
-		.add<io::March>(
-			[&](auto command)
+				else
+				{
+					const std::string_view text(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+					runner.run(text, scenario, std::cout);
+				}
+			}
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << e.what() << std::endl;
+			return 1;
+		}
+		if (archive || recorder || replayer)
+		{
+			try
 			{
-				if (!map)
+				if (archive)
 				{
-					throw std::runtime_error("Map not created");
+					archive->finish();
 				}
-
-				if (command.targetX >= map->getWidth() || command.targetY >= map->getHeight())
+				if (recorder)
+				{
+					recorder->finish();
+				}
+				if (replayer)
 				{
-					throw std::out_of_range("March target is out of map bounds");
+					replayer->finish();
 				}
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << e.what() << std::endl;
+				return 1;
+			}
+		}
+		if (options.stats)
+		{
+			stats.write(std::cerr);
+		}
+		return 0;
+	}
 
-				auto& unit = map->getUnitById(command.unitId);
-				unit.template addComponent<MarchComponent>(Position{command.targetX, command.targetY});
-				auto pos = map->getUnitPosition(command.unitId);
-				eventAdapter->onMarchStarted(command.unitId, pos, Position{command.targetX, command.targetY});
-			});
+	// --- Resume Checkpoint ---
 
-	// --- Parse Scenario ---
+	sw::EventLog logger(std::cout);
+	uint64_t tick = 1;
+	io::GameLogger eventAdapter(logger, tick);
+	// Hash traces and quiet runs replace the event log
+	NullEvents nullEvents;
+	const bool headless = options.hashTrace || options.quiet;
 
+	std::unique_ptr<GameWorld> map;
 	try
 	{
-		parser.parse(stream);
+		auto snapshot = app::readCheckpoint(options.resumePath);
+		map = std::move(snapshot.world);
+		tick = snapshot.tick;
 	}
 	catch (const std::exception& e)
 	{
-		std::cerr << "Error parsing commands: " << e.what() << std::endl;
-		return 1;
-	}
-
-	if (!map)
-	{
-		std::cerr << "Map was not created!" << std::endl;
+		std::cerr << "Error loading checkpoint: " << e.what() << std::endl;
 		return 1;
 	}
 
 	// --- Simulation Loop ---
 
-	// Increment tick before simulation starts (Setup was tick 1)
-	tick++;
-
 	try
 	{
-		while (true)
+		if (options.hashTrace)
 		{
-			bool anyAction = false;
-
-			sw::core::IGameEvents& events = *eventAdapter;
-
-			map->forEachUnit(
-				[&](sw::core::Unit& unit)
-				{
-					if (unit.playTurn(*map, events))
-					{
-						anyAction = true;
-					}
-				});
-
-			// 2. Cleanup Dead
-			auto deadUnits = map->removeDeadUnits();
-			for (const auto& id : deadUnits)
-			{
-				events.onUnitDied(id);
-			}
-
-			// 3. Check End Conditions
-			const size_t aliveCount = map->getUnitCount();
-
-			if (aliveCount <= 1)
-			{
-				break;
-			}
-
-			if (!anyAction)
-			{
-				break;
-			}
-
-			tick++;
+			simulation.onTickEnd = [](const GameWorld& world, uint64_t playedTick)
+			{ app::writeHashLine(std::cout, playedTick, world.getStateHash()); };
+		}
+		if (headless)
+		{
+			// Nothing would see the moves of fast-forwarded ticks
+			simulation.fastForwardSilent = true;
+			app::runSimulation(*map, nullEvents, tick, simulation);
+		}
+		else
+		{
+			app::runSimulation(*map, eventAdapter, tick, simulation);
 		}
 	}
 	catch (const std::exception& e)
@@ -189,6 +235,10 @@ int main(int argc, char** argv)
 		std::cerr << "Simulation error: " << e.what() << std::endl;
 		return 1;
 	}
+	if (options.quiet)
+	{
+		app::writeBattleSummary(std::cout, *map, tick);
+	}
 
 	return 0;
 }
@@ -1,17 +1,55 @@
+#include "App/CompiledScenario.hpp"
+#include "App/DecisionLog.hpp"
+#include "App/EventStats.hpp"
+#include "App/HashTrace.hpp"
+#include "App/ScenarioRunner.hpp"
+#include "App/Server.hpp"
+#include "App/Simulation.hpp"
+#include "App/Timeline.hpp"
+#include "Core/CellBitmap.hpp"
+#include "Core/EventBus.hpp"
+#include "Core/FlowField.hpp"
 #include "Core/GameWorld.hpp"
 #include "Core/IGameEvents.hpp"
+#include "Core/NullEvents.hpp"
+#include "Core/Snapshot.hpp"
 #include "Features/Behaviors/Utils.hpp"
 #include "Features/Components.hpp"
 #include "Features/Hunter.hpp"
+#include "Features/Snapshot.hpp"
 #include "Features/Swordsman.hpp"
+#include "IO/Commands/LoadTerrain.hpp"
+#include "IO/Commands/March.hpp"
+#include "IO/Events/MapCreated.hpp"
+#include "IO/Events/MarchEnded.hpp"
+#include "IO/Events/MarchStarted.hpp"
+#include "IO/Events/UnitAttacked.hpp"
+#include "IO/Events/UnitDied.hpp"
+#include "IO/Events/UnitMoved.hpp"
+#include "IO/Events/UnitSpawned.hpp"
+#include "IO/System/CommandParser.hpp"
+#include "IO/System/EventArchive.hpp"
+#include "IO/System/EventLog.hpp"
+#include "IO/System/GameLogger.hpp"
+#include "IO/System/LogIndex.hpp"
+#include "IO/System/TerrainFile.hpp"
+#include "IO/System/details/PrintFieldVisitor.hpp"
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <span>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 // --- Minimal Test Framework ---
@@ -110,11 +148,11 @@ namespace
 		GameWorld world(5, 5);
 		TestEvents events;
 
-		auto u1 = std::make_unique<Swordsman>(1, 10, 1);
-		u1->addComponent<MarchComponent>(Position{0, 2});
+		auto u1 = makeSwordsman(1, 10, 1);
+		u1.addComponent<MarchComponent>(Position{0, 2});
 		
-		auto u2 = std::make_unique<Swordsman>(2, 10, 1);
-		u2->addComponent<MarchComponent>(Position{2, 0});
+		auto u2 = makeSwordsman(2, 10, 1);
+		u2.addComponent<MarchComponent>(Position{2, 0});
 
 		world.addUnit(std::move(u1), Position{0, 0});
 		world.addUnit(std::move(u2), Position{2, 2});
@@ -142,8 +180,8 @@ namespace
 		Position start{0, 0};
 		Position target{2, 2};
 
-		auto u1 = std::make_unique<Swordsman>(1, 10, 1);
-		u1->addComponent<MarchComponent>(target);
+		auto u1 = makeSwordsman(1, 10, 1);
+		u1.addComponent<MarchComponent>(target);
 		world.addUnit(std::move(u1), start);
 
 		world.getUnitById(1).playTurn(world, events);
@@ -170,12 +208,12 @@ namespace
 		TestEvents events;
 
 		// Mover at 0,0 wants to go to 2,0
-		auto mover = std::make_unique<Swordsman>(1, 10, 1);
-		mover->addComponent<MarchComponent>(Position{2, 0});
-		mover->removeComponent<StrengthComponent>(); // Disable attack
+		auto mover = makeSwordsman(1, 10, 1);
+		mover.addComponent<MarchComponent>(Position{2, 0});
+		mover.removeComponent<StrengthComponent>(); // Disable attack
 
 		// Blocker at 1,0 (Direct path)
-		auto blocker = std::make_unique<Swordsman>(2, 10, 1);
+		auto blocker = makeSwordsman(2, 10, 1);
 
 		world.addUnit(std::move(mover), Position{0, 0});
 		world.addUnit(std::move(blocker), Position{1, 0});
@@ -203,10 +241,10 @@ namespace
 		TestEvents events;
 
 		// Hunter at 0,0. Target at 2,0. Range 3.
-		auto hunter = std::make_unique<Hunter>(1, 10, 5, 1, 3);
-		hunter->removeComponent<AgilityComponent>(); // BREAK IT
+		auto hunter = makeHunter(1, 10, 5, 1, 3);
+		hunter.removeComponent<AgilityComponent>(); // BREAK IT
 		
-		auto target = std::make_unique<Swordsman>(2, 10, 1);
+		auto target = makeSwordsman(2, 10, 1);
 
 		world.addUnit(std::move(hunter), Position{0, 0});
 		world.addUnit(std::move(target), Position{2, 0});
@@ -225,8 +263,8 @@ namespace
 		GameWorld world(3, 1);
 		TestEvents events;
 
-		auto s1 = std::make_unique<Swordsman>(1, 10, 5);
-		auto s2 = std::make_unique<Swordsman>(2, 10, 1);
+		auto s1 = makeSwordsman(1, 10, 5);
+		auto s2 = makeSwordsman(2, 10, 1);
 
 		world.addUnit(std::move(s1), Position{0, 0});
 		world.addUnit(std::move(s2), Position{1, 0});
@@ -248,8 +286,8 @@ namespace
 		GameWorld world(3, 1);
 		TestEvents events;
 
-		auto s1 = std::make_unique<Swordsman>(1, 10, 10);
-		auto s2 = std::make_unique<Swordsman>(2, 10, 1); // 10 HP
+		auto s1 = makeSwordsman(1, 10, 10);
+		auto s2 = makeSwordsman(2, 10, 1); // 10 HP
 
 		world.addUnit(std::move(s1), Position{0, 0});
 		world.addUnit(std::move(s2), Position{1, 0});
@@ -278,10 +316,10 @@ namespace
 		using namespace sw::core;
 		using namespace sw::features;
 		GameWorld world(3, 1);
-		auto attacker = std::make_unique<Swordsman>(1, 10, 1);
-		auto target = std::make_unique<Swordsman>(2, 10, 1);
+		auto attacker = makeSwordsman(1, 10, 1);
+		auto target = makeSwordsman(2, 10, 1);
 		
-		target->removeComponent<HealthComponent>(); // Should become untargetable
+		target.removeComponent<HealthComponent>(); // Should become untargetable
 		
 		world.addUnit(std::move(attacker), Position{0, 0});
 		world.addUnit(std::move(target), Position{1, 0});
@@ -295,7 +333,7 @@ namespace
 		using namespace sw::features;
 		using namespace sw::core;
 
-		Swordsman unit(1, 10, 1);
+		auto unit = makeSwordsman(1, 10, 1);
 		bool threw = false;
 		try {
 			unit.addBehavior(nullptr);
@@ -304,6 +342,1873 @@ namespace
 		}
 		TEST_ASSERT(threw);
 	}
+
+	// Cell layers must follow units through add/move/removal
+	void testCellLayersTrackUnits()
+	{
+		using namespace sw::core;
+		using namespace sw::features;
+
+		GameWorld world(4, 4);
+		auto unit = makeSwordsman(1, 10, 1);
+		auto ghost = makeSwordsman(2, 10, 1);
+		ghost.removeComponent<BlockerComponent>();
+		ghost.removeComponent<HealthComponent>();
+
+		world.addUnit(std::move(unit), Position{1, 1});
+		world.addUnit(std::move(ghost), Position{3, 3});
+
+		TEST_ASSERT(world.testCell(CellLayer::Occupied, Position{1, 1}));
+		TEST_ASSERT(world.testCell(CellLayer::Blocker, Position{1, 1}));
+		TEST_ASSERT(world.testCell(CellLayer::Targetable, Position{1, 1}));
+		TEST_ASSERT(world.testCell(CellLayer::Occupied, Position{3, 3}));
+		TEST_ASSERT(!world.testCell(CellLayer::Blocker, Position{3, 3}));
+		TEST_ASSERT(!world.testCell(CellLayer::Targetable, Position{3, 3}));
+		TEST_ASSERT(!world.testCell(CellLayer::Occupied, Position{7, 7}));
+
+		world.moveUnit(1, Position{2, 2});
+		TEST_ASSERT(!world.testCell(CellLayer::Occupied, Position{1, 1}));
+		TEST_ASSERT(world.testCell(CellLayer::Blocker, Position{2, 2}));
+		TEST_ASSERT(world.anyCellInRange(CellLayer::Occupied, Position{3, 3}, 1, 1));
+		TEST_ASSERT(!world.anyCellInRange(CellLayer::Targetable, Position{2, 2}, 1, 3));
+
+		world.getUnitById(1).setDead(true);
+		world.removeDeadUnits();
+		TEST_ASSERT(!world.testCell(CellLayer::Occupied, Position{2, 2}));
+		TEST_ASSERT(!world.anyCellInRange(CellLayer::Occupied, Position{3, 3}, 1, 3));
+	}
+
+	// Word-level ring test must agree with a per-cell scan, including spans crossing 64-bit word boundaries
+	void testCellBitmapRingMatchesScan()
+	{
+		using namespace sw::core;
+
+		const uint32_t width = 300;
+		const uint32_t height = 40;
+		CellBitmap bitmap(width, height);
+		for (uint32_t i = 0; i < 60; ++i)
+		{
+			bitmap.set(Position{(i * 97 + 13) % width, (i * 31 + 7) % height});
+		}
+
+		auto scan = [&](Position c, uint32_t minRange, uint32_t maxRange)
+		{
+			for (uint32_t y = 0; y < height; ++y)
+			{
+				for (uint32_t x = 0; x < width; ++x)
+				{
+					const uint32_t dist = static_cast<uint32_t>(
+						std::max(std::abs((int)x - (int)c.x), std::abs((int)y - (int)c.y)));
+					if (dist >= minRange && dist <= maxRange && bitmap.test(Position{x, y}))
+					{
+						return true;
+					}
+				}
+			}
+			return false;
+		};
+
+		for (uint32_t cx = 0; cx < width; cx += 23)
+		{
+			for (uint32_t cy = 0; cy < height; cy += 7)
+			{
+				for (uint32_t maxRange : {1u, 2u, 5u, 40u, 200u})
+				{
+					for (uint32_t minRange : {0u, 1u, 2u, 4u})
+					{
+						const Position c{cx, cy};
+						TEST_ASSERT(bitmap.anyInRing(c, minRange, maxRange) == scan(c, minRange, maxRange));
+					}
+				}
+			}
+		}
+	}
+
+	// Chunk-accelerated counts and range walks must match a brute-force scan, also after moves and deaths
+	void testChunkCountsMatchScan()
+	{
+		using namespace sw::core;
+		using namespace sw::features;
+
+		const uint32_t width = 150;
+		const uint32_t height = 90;
+		GameWorld world(width, height);
+		for (UnitId id = 1; id <= 120; ++id)
+		{
+			auto unit = makeSwordsman(id, 10, 1);
+			if (id % 5 == 0)
+			{
+				unit.removeComponent<HealthComponent>();
+			}
+			const Position pos{(id * 37) % width, (id * 53) % height};
+			if (!world.testCell(CellLayer::Occupied, pos))
+			{
+				world.addUnit(std::move(unit), pos);
+			}
+		}
+
+		auto bruteCount = [&](Position c, uint32_t minRange, uint32_t maxRange)
+		{
+			uint32_t count = 0;
+			world.forEachUnit(
+				[&](const Unit& unit)
+				{
+					const Position p = world.getUnitPosition(unit.getId());
+					const uint32_t dist = static_cast<uint32_t>(
+						std::max(std::abs((int)p.x - (int)c.x), std::abs((int)p.y - (int)c.y)));
+					if (utils::hasHealth(unit) && dist >= minRange && dist <= maxRange)
+					{
+						++count;
+					}
+				});
+			return count;
+		};
+
+		auto verify = [&]()
+		{
+			for (uint32_t cx = 0; cx < width; cx += 17)
+			{
+				for (uint32_t cy = 0; cy < height; cy += 13)
+				{
+					for (uint32_t maxRange : {1u, 15u, 16u, 40u, 100u})
+					{
+						const Position c{cx, cy};
+						const uint32_t expected = bruteCount(c, 2, maxRange);
+						TEST_ASSERT_EQ(world.countUnitsInRange(CellLayer::Targetable, c, 2, maxRange), expected);
+						TEST_ASSERT(world.anyCellInRange(CellLayer::Targetable, c, 2, maxRange) == (expected > 0));
+
+						std::vector<UnitId> scanned;
+						std::vector<UnitId> swept;
+						world.forEachUnitInRange(
+							CellLayer::Targetable,
+							c,
+							2,
+							maxRange,
+							RangeStrategy::CellScan,
+							[&](const Unit& u) { scanned.push_back(u.getId()); });
+						world.forEachUnitInRange(
+							CellLayer::Targetable,
+							c,
+							2,
+							maxRange,
+							RangeStrategy::PositionSweep,
+							[&](const Unit& u) { swept.push_back(u.getId()); });
+						TEST_ASSERT_EQ(static_cast<uint32_t>(scanned.size()), expected);
+						TEST_ASSERT(scanned == swept);
+					}
+				}
+			}
+		};
+
+		verify();
+
+		// Move a few units across chunk borders and kill some
+		world.forEachUnit(
+			[&](Unit& unit)
+			{
+				const Position p = world.getUnitPosition(unit.getId());
+				const Position to{(p.x + 19) % width, p.y};
+				if (unit.getId() % 3 == 0 && !world.testCell(CellLayer::Occupied, to))
+				{
+					world.moveUnit(unit.getId(), to);
+				}
+				if (unit.getId() % 7 == 0)
+				{
+					unit.setDead(true);
+				}
+			});
+		world.removeDeadUnits();
+
+		verify();
+	}
+
+	// Sparse maps with long ranges should sweep positions; short ranges should scan cells
+	void testRangeStrategyAdapts()
+	{
+		using namespace sw::core;
+		using namespace sw::features;
+
+		GameWorld world(1000, 1000);
+		world.addUnit(makeHunter(1, 10, 5, 1, 300), Position{500, 500});
+		world.addUnit(makeSwordsman(2, 10, 1), Position{700, 650});
+		world.addUnit(makeSwordsman(3, 10, 1), Position{501, 501});
+		// Far-away crowd: keeps the map sparse around the hunter but makes sweeping tiny ranges unprofitable
+		for (UnitId id = 10; id < 210; ++id)
+		{
+			world.addUnit(makeSwordsman(id, 10, 1), Position{id, 0});
+		}
+
+		const auto& stats = world.getRangeQueryStats();
+
+		auto far = utils::getTargetsInRange(world.getUnitById(1), world, 2, 300);
+		TEST_ASSERT_EQ(stats.positionSweeps, (uint64_t)1);
+		TEST_ASSERT_EQ(far.size(), (size_t)1);
+		TEST_ASSERT_EQ(far[0]->getId(), (UnitId)2);
+
+		auto near = utils::getTargetsInRange(world.getUnitById(1), world, 1, 1);
+		TEST_ASSERT_EQ(stats.cellScans, (uint64_t)1);
+		TEST_ASSERT_EQ(near.size(), (size_t)1);
+		TEST_ASSERT_EQ(near[0]->getId(), (UnitId)3);
+	}
+
+	// Random::getItem picks targets by index, so units sharing a cell must come in the same order either way
+	void testRangeStrategiesAgreeOnSharedCells()
+	{
+		using namespace sw::core;
+		using namespace sw::features;
+
+		GameWorld world(10, 10);
+		for (UnitId id = 1; id <= 4; ++id)
+		{
+			world.addUnit(makeSwordsman(id, 10, 1), Position{5, 5});
+		}
+		world.addUnit(makeSwordsman(5, 10, 1), Position{6, 5});
+		world.addUnit(makeSwordsman(6, 10, 1), Position{6, 5});
+		// Leaving and re-entering puts a unit at the back of its cell's list
+		world.moveUnit(1, Position{5, 6});
+		world.moveUnit(1, Position{5, 5});
+		world.moveUnit(5, Position{7, 7});
+		world.moveUnit(5, Position{6, 5});
+
+		auto collect = [&](CellLayer layer, RangeStrategy strategy)
+		{
+			std::vector<UnitId> ids;
+			world.forEachUnitInRange(
+				layer, Position{3, 5}, 1, 3, strategy, [&](const Unit& unit) { ids.push_back(unit.getId()); });
+			return ids;
+		};
+		for (const auto layer : {CellLayer::Occupied, CellLayer::Targetable})
+		{
+			const auto scanned = collect(layer, RangeStrategy::CellScan);
+			TEST_ASSERT(scanned == (std::vector<UnitId>{2, 3, 4, 1, 6, 5}));
+			TEST_ASSERT(collect(layer, RangeStrategy::PositionSweep) == scanned);
+		}
+	}
+
+	// Storage layout must not change what queries return or in which order
+	void testTiledLayoutMatchesRowMajor()
+	{
+		using namespace sw::core;
+		using namespace sw::features;
+
+		// Odd sizes leave partial edge tiles
+		const uint32_t width = 45;
+		const uint32_t height = 21;
+		GameWorld rows(width, height, GridLayout::RowMajor);
+		GameWorld tiles(width, height, GridLayout::Tiled);
+		TEST_ASSERT(tiles.getGridLayout() == GridLayout::Tiled);
+
+		for (UnitId id = 1; id <= 200; ++id)
+		{
+			const Position pos{(id * 29) % width, (id * 11) % height};
+			if (!rows.testCell(CellLayer::Occupied, pos))
+			{
+				rows.addUnit(makeSwordsman(id, 10, 1), pos);
+				tiles.addUnit(makeSwordsman(id, 10, 1), pos);
+			}
+		}
+		// Stack a second unit onto a cell in the last partial tile
+		rows.addUnit(makeSwordsman(500, 10, 1), Position{width - 1, height - 1});
+		tiles.addUnit(makeSwordsman(500, 10, 1), Position{width - 1, height - 1});
+
+		auto collect = [](const GameWorld& world, Position c, uint32_t maxRange)
+		{
+			std::vector<UnitId> ids;
+			world.forEachUnitInRange(
+				CellLayer::Occupied,
+				c,
+				0,
+				maxRange,
+				RangeStrategy::CellScan,
+				[&](const Unit& u) { ids.push_back(u.getId()); });
+			return ids;
+		};
+
+		for (uint32_t x = 0; x < width; x += 4)
+		{
+			for (uint32_t y = 0; y < height; y += 3)
+			{
+				for (uint32_t maxRange : {0u, 1u, 9u})
+				{
+					TEST_ASSERT(collect(rows, Position{x, y}, maxRange) == collect(tiles, Position{x, y}, maxRange));
+				}
+			}
+		}
+	}
+
+	// Units keep their addresses and creation order while others die, across storage chunk boundaries
+	void testUnitStorageStableAcrossRemoval()
+	{
+		using namespace sw::core;
+		using namespace sw::features;
+
+		GameWorld world(40, 40);
+		std::vector<const Unit*> handles;
+		for (UnitId id = 1; id <= 300; ++id)
+		{
+			handles.push_back(&world.addUnit(makeSwordsman(id, 10, 1), Position{id % 40, id / 40}));
+		}
+
+		// Kill everything in the first storage chunk plus every third unit elsewhere
+		world.forEachUnit(
+			[](Unit& unit)
+			{
+				if (unit.getId() <= 64 || unit.getId() % 3 == 0)
+				{
+					unit.setDead(true);
+				}
+			});
+		const auto removed = world.removeDeadUnits();
+		TEST_ASSERT_EQ(removed.front(), (UnitId)1);
+		TEST_ASSERT(std::is_sorted(removed.begin(), removed.end()));
+
+		std::vector<UnitId> order;
+		world.forEachUnit([&](const Unit& unit) { order.push_back(unit.getId()); });
+		TEST_ASSERT_EQ(order.size(), world.getUnitCount());
+		TEST_ASSERT(std::is_sorted(order.begin(), order.end()));
+
+		for (UnitId id : order)
+		{
+			TEST_ASSERT(&world.getUnitById(id) == handles[id - 1]);
+		}
+
+		world.addUnit(makeSwordsman(1000, 10, 1), Position{39, 39});
+		order.clear();
+		world.forEachUnit([&](const Unit& unit) { order.push_back(unit.getId()); });
+		TEST_ASSERT_EQ(order.back(), (UnitId)1000);
+	}
+
+	// FunctionRef must call through to the referenced lambda, keep its state and forward return values
+	void testFunctionRefForwardsCalls()
+	{
+		using namespace sw::core;
+
+		int calls = 0;
+		auto counter = [&](int step) { calls += step; };
+		FunctionRef<void(int)> visit = counter;
+		visit(2);
+		visit(3);
+		TEST_ASSERT_EQ(calls, 5);
+
+		const auto isEven = [](int value) { return value % 2 == 0; };
+		FunctionRef<bool(int)> predicate = isEven;
+		TEST_ASSERT(predicate(4));
+		TEST_ASSERT(!predicate(7));
+
+		GameWorld world(3, 1);
+		world.addUnit(sw::features::makeSwordsman(1, 10, 1), Position{1, 0});
+		TEST_ASSERT(world.anyUnitAt(Position{1, 0}, [](const Unit& unit) { return unit.getId() == 1; }));
+		TEST_ASSERT(!world.anyUnitAt(Position{0, 0}, [](const Unit&) { return true; }));
+	}
+
+	// Replaying blocker changes must give the same distances as building the field from scratch
+	void testFlowFieldIncrementalMatchesRebuild()
+	{
+		using namespace sw::core;
+
+		const uint32_t width = 23;
+		const uint32_t height = 17;
+		const Position target{11, 8};
+		CellBitmap blockers(width, height);
+		FlowFieldCache cache;
+		cache.get(target, blockers);
+
+		uint32_t seed = 12345;
+		auto next = [&]() { return seed = seed * 1103515245u + 12345u, (seed >> 8); };
+		for (int round = 0; round < 200; ++round)
+		{
+			const Position cell{next() % width, next() % height};
+			blockers.assign(cell, !blockers.test(cell));
+			cache.noteCellChanged(cell);
+
+			const FlowField& field = cache.get(target, blockers);
+			FlowFieldCache fresh;
+			const FlowField& expected = fresh.get(target, blockers);
+			for (uint32_t y = 0; y < height; ++y)
+			{
+				for (uint32_t x = 0; x < width; ++x)
+				{
+					TEST_ASSERT_EQ(field.getDistance(Position{x, y}), expected.getDistance(Position{x, y}));
+				}
+			}
+		}
+		TEST_ASSERT_EQ(cache.getStats().builds, (uint64_t)1);
+		TEST_ASSERT(cache.getStats().incrementalUpdates > 0);
+
+		// A byte budget of two fields evicts the least recently used one even below the field count limit
+		FlowFieldCache small(FlowFieldCache::DefaultCapacity, 2 * width * height * sizeof(uint32_t));
+		small.get(Position{0, 0}, blockers);
+		small.get(Position{1, 0}, blockers);
+		small.get(Position{0, 0}, blockers);
+		small.get(Position{2, 0}, blockers);
+		TEST_ASSERT_EQ(small.getStats().builds, (uint64_t)3);
+		small.get(Position{0, 0}, blockers);
+		TEST_ASSERT_EQ(small.getStats().builds, (uint64_t)3);
+		small.get(Position{1, 0}, blockers);
+		TEST_ASSERT_EQ(small.getStats().builds, (uint64_t)4);
+	}
+
+	// Marchers whose straight step is blocked route around a wall, sharing one field for their common target
+	void testMarchDetoursAroundWall()
+	{
+		using namespace sw::core;
+		using namespace sw::features;
+
+		GameWorld world(20, 10);
+		TestEvents events;
+
+		// Wall at x = 10 with a single gap at the bottom row
+		for (uint32_t y = 0; y < 9; ++y)
+		{
+			auto wall = makeSwordsman(100 + y, 10, 1);
+			wall.removeComponent<StrengthComponent>();
+			world.addUnit(std::move(wall), Position{10, y});
+		}
+
+		for (UnitId id : {1u, 2u})
+		{
+			auto marcher = makeSwordsman(id, 10, 1);
+			marcher.removeComponent<StrengthComponent>();
+			marcher.addComponent<MarchComponent>(Position{15, 2});
+			world.addUnit(std::move(marcher), Position{5, id});
+		}
+
+		for (int tick = 0; tick < 40; ++tick)
+		{
+			bool anyAction = false;
+			world.forEachUnit([&](Unit& unit) { anyAction = unit.playTurn(world, events) || anyAction; });
+			if (!anyAction)
+			{
+				break;
+			}
+		}
+
+		// The first arrival takes the target; the other waits next to it
+		const Position first = world.getUnitPosition(1);
+		const Position second = world.getUnitPosition(2);
+		const Position& waiting = first == Position{15, 2} ? second : first;
+		TEST_ASSERT(first == (Position{15, 2}) || second == (Position{15, 2}));
+		TEST_ASSERT(std::max(std::abs((int)waiting.x - 15), std::abs((int)waiting.y - 2)) == 1);
+		TEST_ASSERT_EQ(world.getFlowFieldStats().builds, (uint64_t)1);
+	}
+
+	// Terrain blocks movement like a blocker unit, is routed around, and stops hunters' line of sight
+	void testTerrainBlocksMovementAndSight()
+	{
+		using namespace sw::core;
+		using namespace sw::features;
+
+		GameWorld world(10, 5);
+		TestEvents events;
+		world.addTerrainRect(Position{5, 0}, Position{5, 3});
+		TEST_ASSERT(world.hasTerrain());
+		TEST_ASSERT(utils::isCellBlocked(world, Position{5, 2}));
+		TEST_ASSERT(!utils::isCellBlocked(world, Position{5, 4}));
+		TEST_ASSERT(!world.testCell(CellLayer::Occupied, Position{5, 2}));
+
+		world.addUnit(makeHunter(1, 10, 5, 1, 6), Position{2, 1});
+		world.addUnit(makeSwordsman(2, 10, 1), Position{8, 1});
+		RangeAttackBehavior shot;
+		TEST_ASSERT(!world.hasLineOfSight(Position{2, 1}, Position{8, 1}));
+		TEST_ASSERT(!shot.canExecute(world.getUnitById(1), world));
+
+		world.getUnitById(1).removeComponent<LineOfSightComponent>();
+		TEST_ASSERT(shot.canExecute(world.getUnitById(1), world));
+
+		// The swordsman walks around the wall through the open bottom row
+		auto& walker = world.getUnitById(2);
+		walker.removeComponent<StrengthComponent>();
+		walker.addComponent<MarchComponent>(Position{3, 1});
+		for (int tick = 0; tick < 20 && walker.getComponent<MarchComponent>(); ++tick)
+		{
+			TEST_ASSERT(walker.playTurn(world, events));
+			TEST_ASSERT(!world.isTerrain(world.getUnitPosition(2)));
+		}
+		TEST_ASSERT(world.getUnitPosition(2) == (Position{3, 1}));
+	}
+
+	// Side files load back bit for bit and keep blocker units on the Blocker layer
+	void testTerrainFileRoundTrip()
+	{
+		using namespace sw::core;
+		using namespace sw::features;
+
+		CellBitmap terrain(130, 3);
+		terrain.fillRect(60, 0, 70, 1);
+		terrain.set(Position{129, 2});
+
+		const std::string path = (std::filesystem::temp_directory_path() / "sw_terrain_test.bin").string();
+		sw::io::saveTerrain(path, terrain);
+		CellBitmap loaded = sw::io::loadTerrain(path);
+		std::filesystem::remove(path);
+
+		TEST_ASSERT_EQ(loaded.getWidth(), (uint32_t)130);
+		TEST_ASSERT_EQ(loaded.count(), (uint64_t)23);
+		TEST_ASSERT(std::equal(loaded.words().begin(), loaded.words().end(), terrain.words().begin()));
+
+		// A header claiming a huge map over an empty payload is rejected before anything is allocated
+		{
+			std::ofstream file(path, std::ios::binary);
+			const uint32_t side = 65535;
+			file.write("SWTERR01", 8);
+			file.write(reinterpret_cast<const char*>(&side), sizeof(side));
+			file.write(reinterpret_cast<const char*>(&side), sizeof(side));
+		}
+		bool rejected = false;
+		try {
+			sw::io::loadTerrain(path);
+		} catch (const std::runtime_error&) {
+			rejected = true;
+		}
+		std::filesystem::remove(path);
+		TEST_ASSERT(rejected);
+
+		GameWorld world(130, 3);
+		world.addUnit(makeSwordsman(1, 10, 1), Position{0, 0});
+		world.setTerrain(std::move(loaded));
+		TEST_ASSERT(world.testCell(CellLayer::Blocker, Position{0, 0}));
+		TEST_ASSERT(world.testCell(CellLayer::Blocker, Position{129, 2}));
+		TEST_ASSERT(!world.testCell(CellLayer::Blocker, Position{59, 0}));
+
+		bool threw = false;
+		try {
+			world.setTerrain(CellBitmap(10, 10));
+		} catch (const std::invalid_argument&) {
+			threw = true;
+		}
+		TEST_ASSERT(threw);
+	}
+
+	// Records gameplay events tagged with the current tick
+	struct TraceEvents final : public sw::core::IGameEvents
+	{
+		const uint64_t& tick;
+		std::vector<std::string> lines;
+
+		explicit TraceEvents(const uint64_t& t) :
+				tick(t)
+		{}
+
+		void log(const std::string& line)
+		{
+			lines.push_back(std::to_string(tick) + " " + line);
+		}
+
+		void onMapCreated(uint32_t, uint32_t) override {}
+		void onUnitSpawned(sw::core::UnitId, std::string_view, sw::core::Position) override {}
+		void onMarchStarted(sw::core::UnitId, sw::core::Position, sw::core::Position) override {}
+		void onUnitAttacked(sw::core::UnitId a, sw::core::UnitId t, uint32_t, uint32_t hp) override
+		{
+			log("attack " + std::to_string(a) + "->" + std::to_string(t) + " hp=" + std::to_string(hp));
+		}
+		void onUnitMoved(sw::core::UnitId u, sw::core::Position, sw::core::Position to) override
+		{
+			log("move " + std::to_string(u) + " " + std::to_string(to.x) + "," + std::to_string(to.y));
+		}
+		void onUnitDied(sw::core::UnitId u) override
+		{
+			log("died " + std::to_string(u));
+		}
+		void onMarchEnded(sw::core::UnitId u, sw::core::Position) override
+		{
+			log("ended " + std::to_string(u));
+		}
+	};
+
+	// Fast-forwarded marches must produce exactly the events of a tick-by-tick run
+	void testFastForwardMatchesTickByTick()
+	{
+		using namespace sw::core;
+		using namespace sw::features;
+
+		auto run = [](bool fastForward, sw::app::SimulationStats& stats)
+		{
+			GameWorld world(120, 60);
+			// Two duellists converge from afar, a hunter marches alone, a bystander idles out of reach
+			auto a = makeSwordsman(1, 10, 3);
+			a.addComponent<MarchComponent>(Position{60, 30});
+			world.addUnit(std::move(a), Position{0, 0});
+			auto b = makeSwordsman(2, 10, 4);
+			b.addComponent<MarchComponent>(Position{61, 30});
+			world.addUnit(std::move(b), Position{119, 59});
+			auto c = makeHunter(3, 10, 2, 1, 5);
+			c.addComponent<MarchComponent>(Position{10, 50});
+			world.addUnit(std::move(c), Position{100, 5});
+			world.addUnit(makeSwordsman(4, 10, 1), Position{0, 59});
+
+			uint64_t tick = 2;
+			TraceEvents events(tick);
+			sw::app::SimulationOptions options;
+			options.fastForward = fastForward;
+			stats = sw::app::runSimulation(world, events, tick, options);
+			return events.lines;
+		};
+
+		sw::app::SimulationStats plain;
+		sw::app::SimulationStats fast;
+		const auto expected = run(false, plain);
+		const auto actual = run(true, fast);
+
+		TEST_ASSERT(expected == actual);
+		TEST_ASSERT_EQ(plain.ticks, fast.ticks);
+		TEST_ASSERT_EQ(plain.fastForwardedTicks, (uint64_t)0);
+		TEST_ASSERT(fast.fastForwardedTicks > 50);
+		TEST_ASSERT(std::any_of(
+			expected.begin(),
+			expected.end(),
+			[](const std::string& line) { return line.find("died") != std::string::npos; }));
+	}
+
+	void testSnapshotResumeMatchesUninterrupted()
+	{
+		std::cout << "[Test] Snapshot Resume Matches Uninterrupted..." << std::endl;
+		using namespace sw::core;
+		using namespace sw::features;
+
+		GameWorld world(24, 24, GridLayout::Tiled);
+		world.getRandom().reseed(42);
+		world.addTerrainRect(Position{10, 0}, Position{10, 8});
+		// Hunters pick among several targets, so the outcome depends on the random stream
+		for (UnitId id = 1; id <= 4; ++id)
+		{
+			world.addUnit(makeHunter(id, 12, 2, 1, 20), Position{2 + id * 4, 20});
+		}
+		for (UnitId id = 5; id <= 8; ++id)
+		{
+			auto unit = makeSwordsman(id, 15, 2);
+			unit.addComponent<MarchComponent>(Position{id * 2, 19});
+			world.addUnit(std::move(unit), Position{id * 2, 2});
+		}
+		// Two non-blocking units share a cell; their order there must survive the round trip
+		for (UnitId id = 9; id <= 10; ++id)
+		{
+			auto ghost = makeSwordsman(id, 5, 1);
+			ghost.removeComponent<BlockerComponent>();
+			world.addUnit(std::move(ghost), Position{20, 10});
+		}
+		const UnitId swapped[] = {10, 9};
+		world.restoreCellOrder(Position{20, 10}, swapped);
+
+		uint64_t tick = 2;
+		TraceEvents events(tick);
+		std::vector<std::byte> saved;
+		uint64_t savedTick = 0;
+		sw::app::SimulationOptions options;
+		options.checkpointEvery = 6;
+		options.onCheckpoint = [&](const GameWorld& current, uint64_t nextTick)
+		{
+			if (saved.empty())
+			{
+				saved = saveSnapshot(current, nextTick, snapshotTypes());
+				savedTick = nextTick;
+			}
+		};
+		sw::app::runSimulation(world, events, tick, options);
+		TEST_ASSERT(!saved.empty());
+
+		auto snapshot = loadSnapshot(saved, snapshotTypes());
+		TEST_ASSERT_EQ(snapshot.tick, savedTick);
+		TEST_ASSERT(saveSnapshot(*snapshot.world, snapshot.tick, snapshotTypes()) == saved);
+
+		uint64_t resumedTick = snapshot.tick;
+		TraceEvents resumed(resumedTick);
+		sw::app::runSimulation(*snapshot.world, resumed, resumedTick);
+
+		std::vector<std::string> expected;
+		for (const auto& line : events.lines)
+		{
+			if (std::stoull(line) >= savedTick)
+			{
+				expected.push_back(line);
+			}
+		}
+		TEST_ASSERT(!expected.empty());
+		TEST_ASSERT(resumed.lines == expected);
+		TEST_ASSERT_EQ(resumedTick, tick);
+
+		// Truncated snapshots are rejected rather than misread
+		bool threw = false;
+		try
+		{
+			loadSnapshot(std::span(saved).first(saved.size() - 1), snapshotTypes());
+		}
+		catch (const std::runtime_error&)
+		{
+			threw = true;
+		}
+		TEST_ASSERT(threw);
+
+		// So are map sizes the payload cannot hold (magic, version and tick come first)
+		auto oversized = saved;
+		const uint32_t side = 65535;
+		std::memcpy(oversized.data() + 20, &side, sizeof(side));
+		std::memcpy(oversized.data() + 24, &side, sizeof(side));
+		threw = false;
+		try
+		{
+			loadSnapshot(oversized, snapshotTypes());
+		}
+		catch (const std::runtime_error&)
+		{
+			threw = true;
+		}
+		TEST_ASSERT(threw);
+
+		// Bools must be stored as 0 or 1
+		const std::byte flags[] = {std::byte{0}, std::byte{1}, std::byte{2}};
+		SnapshotReader reader(flags);
+		TEST_ASSERT(!reader.read<bool>());
+		TEST_ASSERT(reader.read<bool>());
+		threw = false;
+		try
+		{
+			reader.read<bool>();
+		}
+		catch (const std::runtime_error&)
+		{
+			threw = true;
+		}
+		TEST_ASSERT(threw);
+	}
+
+	void testForkedWorldsRunIndependently()
+	{
+		std::cout << "[Test] Forked Worlds Run Independently..." << std::endl;
+		using namespace sw::core;
+		using namespace sw::features;
+
+		GameWorld parent(64, 64);
+		parent.getRandom().reseed(7);
+		parent.addTerrainRect(Position{30, 0}, Position{30, 40});
+		for (UnitId id = 1; id <= 6; ++id)
+		{
+			auto unit = makeSwordsman(id, 20, 2);
+			unit.addComponent<MarchComponent>(Position{50, 10 + id});
+			parent.addUnit(std::move(unit), Position{5, 5 + id * 4});
+		}
+		parent.addUnit(makeHunter(7, 30, 3, 2, 12), Position{45, 12});
+
+		// Play a few ticks so the fork shares built flow fields and a mid-march state
+		uint64_t tick = 2;
+		TraceEvents warmup(tick);
+		for (int i = 0; i < 5; ++i, ++tick)
+		{
+			parent.forEachUnit([&](Unit& unit) { unit.playTurn(parent, warmup); });
+		}
+
+		constexpr size_t ForkCount = 4;
+		std::vector<std::unique_ptr<GameWorld>> forks;
+		for (size_t i = 0; i < ForkCount; ++i)
+		{
+			forks.push_back(parent.fork());
+		}
+		// What-if: the last fork sends unit 6 elsewhere
+		forks.back()->getUnitById(6).getComponent<MarchComponent>()->target = Position{5, 60};
+
+		auto play = [](GameWorld& world, uint64_t start)
+		{
+			uint64_t current = start;
+			TraceEvents events(current);
+			sw::app::runSimulation(world, events, current);
+			return events.lines;
+		};
+
+		std::vector<std::vector<std::string>> traces(ForkCount);
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < ForkCount; ++i)
+		{
+			threads.emplace_back([&, i] { traces[i] = play(*forks[i], tick); });
+		}
+		const auto expected = play(parent, tick);
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		TEST_ASSERT(!expected.empty());
+		for (size_t i = 0; i + 1 < ForkCount; ++i)
+		{
+			TEST_ASSERT(traces[i] == expected);
+		}
+		TEST_ASSERT(traces.back() != expected);
+
+		// A fork made after the battle does not see later changes, and vice versa
+		auto late = parent.fork();
+		late->addTerrainRect(Position{0, 0}, Position{0, 0});
+		TEST_ASSERT(late->isTerrain(Position{0, 0}));
+		TEST_ASSERT(!parent.isTerrain(Position{0, 0}));
+		TEST_ASSERT_EQ(late->getUnitCount(), parent.getUnitCount());
+	}
+
+	void testStateHashTracksMutations()
+	{
+		std::cout << "[Test] State Hash Tracks Mutations..." << std::endl;
+		using namespace sw::core;
+		using namespace sw::features;
+
+		auto build = [](uint64_t seed)
+		{
+			auto world = std::make_unique<GameWorld>(32, 32);
+			world->getRandom().reseed(seed);
+			for (UnitId id = 1; id <= 5; ++id)
+			{
+				auto unit = makeSwordsman(id, 8, 2);
+				unit.addComponent<MarchComponent>(Position{16, 16});
+				world->addUnit(std::move(unit), Position{id * 6, 2});
+			}
+			world->addUnit(makeHunter(6, 10, 2, 1, 8), Position{16, 20});
+			return world;
+		};
+
+		// Same units in a different creation order hash the same
+		auto reference = build(1);
+		GameWorld reordered(32, 32);
+		reference->forEachUnit(
+			[&](const Unit& unit)
+			{
+				if (unit.getId() % 2 == 0)
+				{
+					reordered.addUnit(unit.clone(), reference->getUnitPosition(unit.getId()));
+				}
+			});
+		reference->forEachUnit(
+			[&](const Unit& unit)
+			{
+				if (unit.getId() % 2 != 0)
+				{
+					reordered.addUnit(unit.clone(), reference->getUnitPosition(unit.getId()));
+				}
+			});
+		TEST_ASSERT_EQ(reordered.getStateHash(), reference->getStateHash());
+
+		auto trace = [&](uint64_t seed)
+		{
+			auto world = build(seed);
+			std::ostringstream out;
+			uint64_t tick = 2;
+			sw::core::NullEvents events;
+			sw::app::SimulationOptions options;
+			options.onTickEnd = [&](const GameWorld& current, uint64_t playedTick)
+			{
+				// Incremental updates (moves, damage, finished marches, deaths) match a full recomputation
+				TEST_ASSERT_EQ(current.getStateHash(), current.computeStateHash());
+				sw::app::writeHashLine(out, playedTick, current.getStateHash());
+			};
+			sw::app::runSimulation(*world, events, tick, options);
+			return out.str();
+		};
+
+		const auto first = trace(1);
+		std::istringstream a(first);
+		std::istringstream b(trace(1));
+		TEST_ASSERT(!sw::app::findFirstDivergence(a, b));
+
+		// Hunter 6 picks among several targets, so another seed changes the battle at some tick
+		std::istringstream c(first);
+		std::istringstream d(trace(2));
+		const auto divergence = sw::app::findFirstDivergence(c, d);
+		TEST_ASSERT(divergence.has_value());
+		TEST_ASSERT(first.find(std::to_string(divergence->tick) + " ") != std::string::npos);
+
+		// A march that switched to the flow field hashes apart from the same march still stepping straight
+		GameWorld marching(8, 8);
+		auto marcher = makeSwordsman(1, 8, 2);
+		marcher.addComponent<MarchComponent>(Position{7, 7});
+		marching.addUnit(std::move(marcher), Position{0, 0});
+		const auto straight = marching.getStateHash();
+		marching.getUnitById(1).getComponent<MarchComponent>()->detoured = true;
+		marching.syncUnitState(1);
+		TEST_ASSERT(marching.getStateHash() != straight);
+		TEST_ASSERT_EQ(marching.getStateHash(), marching.computeStateHash());
+	}
+
+	void testTimelineRewindsAndReplays()
+	{
+		std::cout << "[Test] Timeline Rewinds And Replays..." << std::endl;
+		using namespace sw::core;
+		using namespace sw::features;
+
+		auto build = []
+		{
+			auto world = std::make_unique<GameWorld>(32, 32);
+			world->getRandom().reseed(3);
+			for (UnitId id = 1; id <= 5; ++id)
+			{
+				auto unit = makeSwordsman(id, 8, 2);
+				unit.addComponent<MarchComponent>(Position{16, 16});
+				world->addUnit(std::move(unit), Position{id * 6, 2});
+			}
+			world->addUnit(makeHunter(6, 10, 2, 1, 8), Position{16, 20});
+			return world;
+		};
+
+		uint64_t tick = 2;
+		TraceEvents events(tick);
+		sw::app::Timeline timeline(build(), events, tick, sw::app::Timeline::Options{4, 64});
+		std::vector<uint64_t> hashes{timeline.getWorld().getStateHash()};
+		while (timeline.step())
+		{
+			hashes.push_back(timeline.getWorld().getStateHash());
+		}
+		hashes.push_back(timeline.getWorld().getStateHash());
+		const uint64_t last = tick - 1;
+		const auto original = events.lines;
+		TEST_ASSERT(std::any_of(
+			original.begin(),
+			original.end(),
+			[](const std::string& line) { return line.find("died") != std::string::npos; }));
+		TEST_ASSERT_EQ(timeline.getOldestTick(), uint64_t{1});
+
+		// Step back one tick at a time: quiet ticks are undone in place, ticks with deaths replay from a keyframe
+		for (uint64_t target = last; target-- > timeline.getOldestTick();)
+		{
+			timeline.rewindTo(target);
+			const auto& world = timeline.getWorld();
+			TEST_ASSERT_EQ(tick, target + 1);
+			TEST_ASSERT_EQ(world.getStateHash(), world.computeStateHash());
+			TEST_ASSERT_EQ(world.getStateHash(), hashes[target - 1]);
+			TEST_ASSERT_EQ(timeline.getRecordedHash(target), hashes[target - 1]);
+		}
+
+		// Playing forward again reproduces the original battle
+		timeline.rewindTo(1);
+		events.lines.clear();
+		while (timeline.step())
+		{
+		}
+		TEST_ASSERT(events.lines == original);
+		TEST_ASSERT_EQ(tick - 1, last);
+
+		bool threw = false;
+		try
+		{
+			timeline.rewindTo(last + 1);
+		}
+		catch (const std::out_of_range&)
+		{
+			threw = true;
+		}
+		TEST_ASSERT(threw);
+
+		// A short history forgets the oldest ticks
+		uint64_t shortTick = 2;
+		sw::core::NullEvents silent;
+		sw::app::Timeline bounded(build(), silent, shortTick, sw::app::Timeline::Options{2, 2});
+		while (bounded.step())
+		{
+		}
+		TEST_ASSERT(bounded.getOldestTick() + 4 >= last);
+		bounded.rewindTo(bounded.getOldestTick());
+		TEST_ASSERT_EQ(bounded.getWorld().getStateHash(), hashes[bounded.getOldestTick() - 1]);
+	}
+
+	void testServerAnswersFramedRequests()
+	{
+		std::cout << "[Test] Server Answers Framed Requests..." << std::endl;
+
+		const std::string scenario =
+			"CREATE_MAP 10 10\n"
+			"SPAWN_SWORDSMAN 1 0 0 5 2\n"
+			"SPAWN_HUNTER 2 9 0 10 5 1 4\n"
+			"SPAWN_SWORDSMAN 3 4 4 5 2\n"
+			"MARCH 1 9 0\n";
+		auto frame =
+			[](const std::string& id, const std::string& source, const std::string& flags, const std::string& payload)
+		{ return id + " " + source + " 7 " + flags + " " + std::to_string(payload.size()) + "\n" + payload; };
+		auto readResponses = [](const std::string& text)
+		{
+			std::map<std::string, std::pair<std::string, std::string>> responses;
+			std::istringstream stream(text);
+			std::string id, status;
+			size_t length = 0;
+			while (stream >> id >> status >> length)
+			{
+				stream.get();
+				std::string body(length, '\0');
+				stream.read(body.data(), static_cast<std::streamsize>(length));
+				responses[id] = {status, body};
+			}
+			return responses;
+		};
+		auto runDirectly = [&](bool hashTrace)
+		{
+			sw::app::ScenarioRunner runner;
+			sw::app::ScenarioOptions options;
+			options.seed = 7;
+			options.hashTrace = hashTrace;
+			std::istringstream stream(scenario);
+			std::ostringstream out;
+			runner.run(stream, options, out);
+			return out.str();
+		};
+
+		std::istringstream requests(
+			frame("a", "text", "-", scenario) + frame("b", "text", "hash-trace", scenario) + "\n" +
+			frame("c", "text", "-", "CREATE_MAP 4 4\nDANCE 1\n") + frame("d", "file", "-", "missing/scenario.txt") +
+			frame("e", "text", "fast-forward", scenario));
+		std::ostringstream out;
+		sw::app::Server server(sw::app::ServerOptions{2});
+		TEST_ASSERT(server.serve(requests, out));
+
+		auto responses = readResponses(out.str());
+		TEST_ASSERT_EQ(responses.size(), size_t{5});
+		const auto log = runDirectly(false);
+		TEST_ASSERT(log.find("UNIT_ATTACKED") != std::string::npos);
+		TEST_ASSERT(responses["a"] == std::make_pair(std::string("ok"), log));
+		TEST_ASSERT(responses["b"] == std::make_pair(std::string("ok"), runDirectly(true)));
+		TEST_ASSERT(responses["e"] == std::make_pair(std::string("ok"), log));
+		TEST_ASSERT(responses["c"].first == "error");
+		TEST_ASSERT(responses["c"].second.find("Unknown command: DANCE") != std::string::npos);
+		TEST_ASSERT(responses["d"].first == "error");
+		TEST_ASSERT(responses["d"].second.find("Failed to open file") != std::string::npos);
+
+		// A bad header ends the stream after answering what came before it
+		std::istringstream broken(frame("f", "text", "-", scenario) + "g text seven - 3\nabc");
+		std::ostringstream brokenOut;
+		TEST_ASSERT(!server.serve(broken, brokenOut));
+		responses = readResponses(brokenOut.str());
+		TEST_ASSERT(responses["f"] == std::make_pair(std::string("ok"), log));
+		TEST_ASSERT(responses["-"].first == "error");
+		TEST_ASSERT(!responses.contains("g"));
+	}
+
+	void testScenarioStreamsTaggedCommands()
+	{
+		std::cout << "[Test] Scenario Streams Tagged Commands..." << std::endl;
+
+		const std::string setup =
+			"CREATE_MAP 20 20\n"
+			"SPAWN_SWORDSMAN 1 0 0 5 2\n"
+			"SPAWN_SWORDSMAN 2 19 19 5 2\n";
+		auto play = [](const std::string& scenario, bool fastForward, std::string* error = nullptr)
+		{
+			sw::app::ScenarioRunner runner;
+			sw::app::ScenarioOptions options;
+			options.simulation.fastForward = fastForward;
+			std::istringstream stream(scenario);
+			std::ostringstream out;
+			try
+			{
+				runner.run(stream, options, out);
+			}
+			catch (const std::runtime_error& e)
+			{
+				TEST_ASSERT(error != nullptr);
+				*error = e.what();
+			}
+			return out.str();
+		};
+
+		// The battle is over at tick 2 until the march at tick 6; the order is changed mid-march at tick 9
+		const std::string scenario = setup +
+									 "@6 MARCH 1 10 0\n"
+									 "@6\n"
+									 "// comments stay allowed\n"
+									 "@9 MARCH 1 0 0\n"
+									 "@30 SPAWN_SWORDSMAN 3 5 5 5 2\n";
+		const auto log = play(scenario, false);
+		TEST_ASSERT(log.find("[6] MARCH_STARTED unitId=1 x=0 y=0 targetX=10") != std::string::npos);
+		TEST_ASSERT(log.find("[8] UNIT_MOVED unitId=1 x=3 y=0") != std::string::npos);
+		TEST_ASSERT(log.find("[9] MARCH_STARTED unitId=1 x=3 y=0 targetX=0") != std::string::npos);
+		TEST_ASSERT(log.find("[11] MARCH_ENDED unitId=1 x=0 y=0") != std::string::npos);
+		TEST_ASSERT(log.find("[30] UNIT_SPAWNED unitId=3") != std::string::npos);
+		// Fast-forward windows stop at scheduled ticks
+		TEST_ASSERT(play(scenario, true) == log);
+
+		// CRLF input: bare tags, blank and CR-only lines after the setup are accepted as in the setup
+		std::string crlf;
+		std::istringstream lines(scenario + "\n \t\n");
+		for (std::string line; std::getline(lines, line);)
+		{
+			crlf += line + "\r\n";
+		}
+		TEST_ASSERT(play(crlf, false) == log);
+
+		// Ticks are played as soon as their commands are read: a bad line only stops the battle when it is reached
+		std::string error;
+		const auto partial = play(setup + "@4 MARCH 1 10 0\n@7 DANCE\n", false, &error);
+		TEST_ASSERT(error.find("Unknown command: DANCE") != std::string::npos);
+		TEST_ASSERT(partial.find("[6] UNIT_MOVED unitId=1 x=3 y=0") != std::string::npos);
+		TEST_ASSERT(partial.find("[7]") == std::string::npos);
+
+		for (const std::string bad : {"@5 MARCH 1 10 0\n@4 MARCH 1 0 0\n", "@5 MARCH 1 10 0\nMARCH 1 0 0\n",
+									   "@5 CREATE_MAP 4 4\n", "@x MARCH 1 10 0\n"})
+		{
+			error.clear();
+			play(setup + bad, false, &error);
+			TEST_ASSERT(error.starts_with("Error parsing commands: "));
+		}
+
+		// A checkpoint cannot hold the commands still to come, so tagged scenarios refuse checkpoints up front
+		sw::app::ScenarioRunner runner;
+		sw::app::ScenarioOptions options;
+		options.simulation.checkpointEvery = 2;
+		bool saved = false;
+		options.simulation.onCheckpoint = [&](const sw::core::GameWorld&, uint64_t) { saved = true; };
+		std::istringstream stream(scenario);
+		std::ostringstream out;
+		error.clear();
+		try
+		{
+			runner.run(stream, options, out);
+		}
+		catch (const std::runtime_error& e)
+		{
+			error = e.what();
+		}
+		TEST_ASSERT(error.find("line 4: Checkpoints cannot be combined") != std::string::npos);
+		TEST_ASSERT(!saved);
+	}
+
+	void testCommandParserDispatch()
+	{
+		std::cout << "[Test] Command Parser Dispatch..." << std::endl;
+		using namespace sw::io;
+
+		std::vector<std::string> seen;
+		CommandParser<March, LoadTerrain> parser;
+		parser
+			.add<March>(
+				[&](March command)
+				{
+					seen.push_back(
+						std::to_string(command.unitId) + ":" + std::to_string(command.targetX) + "," +
+						std::to_string(command.targetY));
+				})
+			.add<LoadTerrain>([&](LoadTerrain command) { seen.push_back(command.path); });
+
+		TEST_ASSERT(parser.parseLine("MARCH 3 10 20"));
+		TEST_ASSERT(parser.parseLine("  LOAD_TERRAIN\tmaps/wall.swt  "));
+		TEST_ASSERT(!parser.parseLine("// MARCH 1 1 1"));
+		TEST_ASSERT(!parser.parseLine(" \t"));
+		TEST_ASSERT(seen == (std::vector<std::string>{"3:10,20", "maps/wall.swt"}));
+
+		auto error = [&](std::string_view line)
+		{
+			try
+			{
+				parser.parseLine(line);
+			}
+			catch (const std::runtime_error& e)
+			{
+				return std::string(e.what());
+			}
+			return std::string();
+		};
+		TEST_ASSERT(error("MARCHING 1 2 3") == "Unknown command: MARCHING");
+		TEST_ASSERT(error("MARCH 1 2") == "Missing targetY for MARCH");
+		TEST_ASSERT(error("MARCH 1 2 -3") == "Invalid targetY for MARCH: -3");
+		TEST_ASSERT_EQ(seen.size(), size_t{2});
+
+		bool threw = false;
+		try
+		{
+			parser.add<March>([](March) {});
+		}
+		catch (const std::runtime_error&)
+		{
+			threw = true;
+		}
+		TEST_ASSERT(threw);
+	}
+
+	void testParallelParseKeepsFileOrder()
+	{
+		std::cout << "[Test] Parallel Parse Keeps File Order..." << std::endl;
+		using namespace sw::io;
+
+		std::string text = "// generated\n";
+		for (uint32_t id = 1; id <= 500; ++id)
+		{
+			text += "MARCH " + std::to_string(id) + " " + std::to_string(id % 7) + " 1\n";
+			if (id % 50 == 0)
+			{
+				text += "\n";
+			}
+		}
+
+		std::vector<uint32_t> order;
+		CommandParser<March, LoadTerrain> parser;
+		parser.add<March>([&](March command) { order.push_back(command.unitId); });
+		const auto never = [](std::string_view) { return false; };
+
+		// Tiny chunks split the text into dozens of tasks
+		const auto parsed = parser.parseParallel(text, 4, never, 64);
+		TEST_ASSERT_EQ(parsed.offset, text.size());
+		TEST_ASSERT_EQ(parsed.lines, uint64_t{511});
+		TEST_ASSERT_EQ(order.size(), size_t{500});
+		TEST_ASSERT(std::is_sorted(order.begin(), order.end()));
+
+		// Parsing stops before the first stop line and reports where it is
+		order.clear();
+		const std::string head = "MARCH 1 0 0\nMARCH 2 0 0\n";
+		const auto isTag = [](std::string_view line) { return line.starts_with('@'); };
+		const auto stopped = parser.parseParallel(head + "@5 MARCH 3 0 0\nMARCH 4 0 0\n", 2, isTag, 8);
+		TEST_ASSERT_EQ(stopped.offset, head.size());
+		TEST_ASSERT_EQ(stopped.lines, uint64_t{2});
+		TEST_ASSERT(order == (std::vector<uint32_t>{1, 2}));
+
+		// Decode and handler errors name the global line; everything before it was applied
+		auto failAt = [&](const std::string& bad)
+		{
+			order.clear();
+			std::string broken = text;
+			broken.insert(broken.find("MARCH 300 "), bad + "\n");
+			try
+			{
+				parser.parseParallel(broken, 4, never, 64);
+			}
+			catch (const std::runtime_error& e)
+			{
+				return std::string(e.what());
+			}
+			return std::string();
+		};
+		TEST_ASSERT(failAt("MARCH 1 2") == "line 306: Missing targetY for MARCH");
+		TEST_ASSERT_EQ(order.size(), size_t{299});
+		TEST_ASSERT(failAt("LOAD_TERRAIN x.swt") == "line 306: No handler for command: LOAD_TERRAIN");
+		TEST_ASSERT_EQ(order.size(), size_t{299});
+	}
+
+	void testCompiledScenarioMatchesText()
+	{
+		std::cout << "[Test] Compiled Scenario Matches Text..." << std::endl;
+		using namespace sw::app;
+
+		const std::string text =
+			"// setup\n"
+			"CREATE_MAP 12 12\n"
+			"TERRAIN 5 0 5 8\n"
+			"SPAWN_SWORDSMAN 1 0 0 5 2\n"
+			"SPAWN_HUNTER 2 11 11 10 5 1 4\n"
+			"MARCH 1 11 0\n"
+			"@4 MARCH 2 0 11\n"
+			"@4\n"
+			"@9 SPAWN_SWORDSMAN 3 0 11 5 2\n";
+		ScenarioRunner runner;
+		ScenarioOptions options;
+		options.seed = 7;
+		auto playText = [&](const std::string& scenario)
+		{
+			std::ostringstream out;
+			runner.run(std::string_view(scenario), options, out);
+			return out.str();
+		};
+		auto playCompiled = [&](std::span<const std::byte> scenario)
+		{
+			std::ostringstream out;
+			runner.runCompiled(scenario, options, out);
+			return out.str();
+		};
+
+		const auto expected = playText(text);
+		const auto compiled = ScenarioRunner::compile(text);
+		TEST_ASSERT(isCompiledScenario(compiled));
+		TEST_ASSERT(playCompiled(compiled) == expected);
+
+		// The cache compiles once and follows edits to the source
+		const auto directory = std::filesystem::temp_directory_path() / "sw_scenario_cache_test";
+		std::filesystem::remove_all(directory);
+		const auto path = directory / "scenario.txt";
+		std::filesystem::create_directories(directory);
+		std::ofstream(path) << text;
+		const auto cache = directory / "cache";
+		TEST_ASSERT(playCompiled(loadCachedScenario(path, cache).bytes()) == expected);
+		TEST_ASSERT(playCompiled(loadCachedScenario(path, cache).bytes()) == expected);
+		TEST_ASSERT_EQ(static_cast<size_t>(std::distance(std::filesystem::directory_iterator(cache), {})), size_t{1});
+
+		const std::string edited = text + "@12 SPAWN_SWORDSMAN 4 11 0 5 2\n";
+		std::ofstream(path) << edited;
+		TEST_ASSERT(playCompiled(loadCachedScenario(path, cache).bytes()) == playText(edited));
+		std::filesystem::remove_all(directory);
+
+		// Decode errors surface at compile time; damaged input is rejected before any tick is played
+		std::string error;
+		try
+		{
+			ScenarioRunner::compile(text + "@10 MARCH 1\n");
+		}
+		catch (const std::runtime_error& e)
+		{
+			error = e.what();
+		}
+		TEST_ASSERT(error == "line 10: Missing targetX for MARCH");
+
+		auto broken = compiled;
+		broken.push_back(std::byte{0x7F});
+		error.clear();
+		try
+		{
+			playCompiled(broken);
+		}
+		catch (const std::runtime_error& e)
+		{
+			error = e.what();
+		}
+		TEST_ASSERT(error.starts_with("Error parsing commands: record "));
+	}
+
+	void testFormationCommandsMatchSingleSpawns()
+	{
+		std::cout << "[Test] Formation Commands Match Single Spawns..." << std::endl;
+
+		auto play = [](const std::string& scenario, std::string* error = nullptr)
+		{
+			sw::app::ScenarioRunner runner;
+			sw::app::ScenarioOptions options;
+			options.seed = 11;
+			std::ostringstream out;
+			try
+			{
+				runner.run(std::string_view(scenario), options, out);
+			}
+			catch (const std::runtime_error& e)
+			{
+				TEST_ASSERT(error != nullptr);
+				*error = e.what();
+			}
+			return out.str();
+		};
+
+		std::string singles = "CREATE_MAP 16 16\n";
+		uint32_t id = 1;
+		for (uint32_t y = 1; y <= 5; y += 2)
+		{
+			for (uint32_t x = 2; x <= 8; x += 2)
+			{
+				singles += "SPAWN_SWORDSMAN " + std::to_string(id++) + " " + std::to_string(x) + " " + std::to_string(y)
+						   + " 5 2\n";
+			}
+		}
+		singles += "SPAWN_HUNTER 13 15 15 10 5 1 4\nSPAWN_HUNTER 14 15 14 10 5 1 4\n";
+		for (id = 1; id <= 8; ++id)
+		{
+			singles += "MARCH " + std::to_string(id) + " 15 0\n";
+		}
+
+		const std::string formations = "CREATE_MAP 16 16\n"
+									   "SPAWN_SWORDSMAN_FORMATION 1 2 1 4 3 2 5 2\n"
+									   "SPAWN_HUNTER_FORMATION 13 15 15 1 1 1 10 5 1 4\n"
+									   "SPAWN_HUNTER_FORMATION 14 15 14 1 1 1 10 5 1 4\n"
+									   "MARCH_RANGE 1 8 15 0\n";
+		const auto expected = play(singles);
+		TEST_ASSERT(expected.find("[1] UNIT_SPAWNED unitId=12 unitType=Swordsman x=8 y=5") != std::string::npos);
+		TEST_ASSERT(play(formations) == expected);
+
+		// A formation that hits an occupied cell, the map edge or a taken ID spawns nothing
+		for (const std::string bad : {"SPAWN_SWORDSMAN_FORMATION 20 0 0 3 1 1 5 2\n",
+									   "SPAWN_SWORDSMAN_FORMATION 20 14 0 2 1 2 5 2\n",
+									   "SPAWN_SWORDSMAN_FORMATION 12 0 10 2 1 1 5 2\n",
+									   "SPAWN_SWORDSMAN_FORMATION 20 0 10 0 1 1 5 2\n",
+									   "MARCH_RANGE 1 30 0 0\n"})
+		{
+			std::string error;
+			const auto log = play("CREATE_MAP 16 16\nSPAWN_SWORDSMAN 12 2 0 5 2\n" + bad, &error);
+			TEST_ASSERT(error.starts_with("Error parsing commands: line 3: "));
+			TEST_ASSERT(log.find("unitId=20") == std::string::npos);
+			TEST_ASSERT(log.find("MARCH_STARTED") == std::string::npos);
+		}
+	}
+
+	// Records for each turn whether it was played with the NullEvents sink itself
+	struct SinkProbeBehavior final : public sw::core::Behavior<SinkProbeBehavior>
+	{
+		std::vector<bool>& quietTurns;
+
+		explicit SinkProbeBehavior(std::vector<bool>& turns) :
+				quietTurns(turns)
+		{}
+
+		bool canExecute(const sw::core::Unit&, const sw::core::IGameWorld&) const override
+		{
+			return true;
+		}
+
+		template <typename TEvents>
+		void act(sw::core::Unit&, sw::core::IGameWorld&, TEvents&)
+		{
+			quietTurns.push_back(std::is_same_v<TEvents, sw::core::NullEvents>);
+		}
+	};
+
+	void testQuietRunPrintsSummary()
+	{
+		std::cout << "[Test] Quiet Run Prints Summary..." << std::endl;
+		using namespace sw::app;
+		using namespace sw::core;
+		using namespace sw::features;
+
+		const std::string scenario = "CREATE_MAP 10 10\n"
+									 "SPAWN_SWORDSMAN 1 0 0 5 2\n"
+									 "SPAWN_SWORDSMAN 2 9 0 5 1\n"
+									 "MARCH 1 9 0\n";
+		ScenarioRunner runner;
+		auto play = [&](bool quiet, bool fastForward)
+		{
+			ScenarioOptions options;
+			options.quiet = quiet;
+			options.simulation.fastForward = fastForward;
+			std::ostringstream out;
+			runner.run(std::string_view(scenario), options, out);
+			return out.str();
+		};
+
+		const auto log = play(false, false);
+		TEST_ASSERT(log.find("UNIT_DIED unitId=2") != std::string::npos);
+		const auto lastTick = log.substr(log.rfind("\n[") + 2, log.find(']', log.rfind("\n[")) - log.rfind("\n[") - 2);
+		TEST_ASSERT(play(true, false) == "Battle ended at tick " + lastTick + ": unit 1 wins\n");
+		TEST_ASSERT(play(true, true) == play(true, false));
+
+		// Headless runs leave the world exactly as a logged run does
+		GameWorld logged(10, 10);
+		GameWorld headless(10, 10);
+		for (auto* world : {&logged, &headless})
+		{
+			world->addUnit(makeSwordsman(1, 5, 2), {0, 0});
+			world->addUnit(makeHunter(2, 5, 2, 1, 4), {5, 5});
+			world->addUnit(makeSwordsman(3, 5, 1), {9, 9});
+		}
+		std::ostringstream discarded;
+		sw::EventLog eventLog(discarded);
+		uint64_t loggedTick = 1;
+		sw::io::GameLogger logger(eventLog, loggedTick);
+		NullEvents nullEvents;
+		uint64_t headlessTick = 1;
+		runSimulation(logged, logger, loggedTick);
+		runSimulation(headless, nullEvents, headlessTick);
+		TEST_ASSERT_EQ(loggedTick, headlessTick);
+		TEST_ASSERT_EQ(logged.getStateHash(), headless.getStateHash());
+
+		// Headless runs hand behaviors the NullEvents sink itself, so no event goes through a virtual IGameEvents call
+		std::vector<bool> quietTurns;
+		GameWorld probed(4, 4);
+		Unit probe(1);
+		probe.addBehavior(std::make_unique<SinkProbeBehavior>(quietTurns));
+		probed.addUnit(std::move(probe), {0, 0});
+		uint64_t probedTick = 1;
+		runSimulation(probed, nullEvents, probedTick);
+		playTick(probed, logger);
+		TEST_ASSERT(quietTurns == (std::vector<bool>{true, false}));
+	}
+
+	void testEventBusRoutesByKind()
+	{
+		std::cout << "[Test] Event Bus Routes By Kind..." << std::endl;
+		using namespace sw::core;
+
+		struct DeathRecorder final : IGameEvents
+		{
+			std::vector<UnitId> died;
+			uint32_t other{};
+
+			void onMapCreated(uint32_t, uint32_t) override
+			{
+				++other;
+			}
+			void onUnitSpawned(UnitId, std::string_view, Position) override
+			{
+				++other;
+			}
+			void onMarchStarted(UnitId, Position, Position) override
+			{
+				++other;
+			}
+			void onUnitAttacked(UnitId, UnitId, uint32_t, uint32_t) override
+			{
+				++other;
+			}
+			void onUnitMoved(UnitId, Position, Position) override
+			{
+				++other;
+			}
+			void onUnitDied(UnitId unit) override
+			{
+				died.push_back(unit);
+			}
+			void onMarchEnded(UnitId, Position) override
+			{
+				++other;
+			}
+		};
+
+		struct BatchRecorder final : IEventBatchSink
+		{
+			std::vector<size_t> batchSizes;
+			std::vector<GameEvent> events;
+
+			void onEvents(std::span<const GameEvent> batch) override
+			{
+				batchSizes.push_back(batch.size());
+				events.insert(events.end(), batch.begin(), batch.end());
+			}
+		};
+
+		EventBus bus;
+		DeathRecorder deaths;
+		BatchRecorder batches;
+		bus.subscribe(deaths, eventBit(EventKind::UnitDied));
+		bus.subscribe(batches, eventBit(EventKind::UnitAttacked) | eventBit(EventKind::UnitDied));
+
+		bus.onUnitMoved(1, {0, 0}, {1, 0});
+		bus.onUnitAttacked(1, 2, 3, 0);
+		bus.onUnitDied(2);
+		TEST_ASSERT(deaths.died == std::vector<UnitId>{2});
+		TEST_ASSERT_EQ(deaths.other, uint32_t{0});
+		TEST_ASSERT(batches.events.empty());
+
+		bus.flush();
+		bus.flush();
+		TEST_ASSERT(batches.batchSizes == std::vector<size_t>{2});
+		TEST_ASSERT(batches.events[0].kind == EventKind::UnitAttacked);
+		TEST_ASSERT_EQ(batches.events[0].targetHp, uint32_t{0});
+		TEST_ASSERT_EQ(batches.events[1].unit, UnitId{2});
+
+		// A stats sink next to the log leaves the log unchanged and sees one batch per played tick
+		const std::string scenario = "CREATE_MAP 10 10\n"
+									 "SPAWN_SWORDSMAN 1 0 0 5 2\n"
+									 "SPAWN_SWORDSMAN 2 9 0 5 1\n"
+									 "MARCH 1 9 0\n";
+		sw::app::ScenarioRunner runner;
+		sw::app::ScenarioOptions options;
+		std::ostringstream plain;
+		runner.run(std::string_view(scenario), options, plain);
+
+		sw::app::EventStats stats;
+		BatchRecorder ticks;
+		options.subscribe = [&](EventBus& events, const uint64_t&)
+		{
+			events.subscribe(stats);
+			events.subscribe(ticks, eventBit(EventKind::UnitMoved));
+		};
+		std::ostringstream withStats;
+		runner.run(std::string_view(scenario), options, withStats);
+		TEST_ASSERT(withStats.str() == plain.str());
+		TEST_ASSERT_EQ(stats.count(EventKind::UnitSpawned), uint64_t{2});
+		TEST_ASSERT_EQ(stats.count(EventKind::UnitDied), uint64_t{1});
+		TEST_ASSERT_EQ(stats.getDamage(), uint64_t{10});
+		// Batches are shared, so they also carry the kinds the stats sink asked for
+		const auto isMove = [](const GameEvent& event) { return event.kind == EventKind::UnitMoved; };
+		const auto moves = std::count_if(ticks.events.begin(), ticks.events.end(), isMove);
+		TEST_ASSERT_EQ(static_cast<uint64_t>(moves), stats.count(EventKind::UnitMoved));
+		const auto nonEmpty = [](size_t size) { return size > 0; };
+		TEST_ASSERT(std::all_of(ticks.batchSizes.begin(), ticks.batchSizes.end(), nonEmpty));
+	}
+
+	void testEventLogMatchesStreamFormat()
+	{
+		std::cout << "[Test] Event Log Matches Stream Format..." << std::endl;
+		using namespace sw::io;
+
+		std::ostringstream expected;
+		std::ostringstream actual;
+		auto both = [&](uint64_t tick, auto event)
+		{
+			expected << "[" << tick << "] " << event.Name << " ";
+			sw::PrintFieldVisitor visitor(expected);
+			event.visit(visitor);
+			expected << "\n";
+			sw::EventLog log(actual);
+			log.log(tick, event);
+		};
+		both(1, MapCreated{10, 20});
+		both(1, UnitSpawned{7, "Hunter", 0, 4294967295u});
+		both(18446744073709551615ull, UnitAttacked{1, 2, 3, 0});
+		both(42, UnitMoved{3, 9, 0});
+		both(43, UnitDied{3});
+		both(44, MarchStarted{1, 2, 3, 4, 5});
+		both(45, MarchEnded{1, 4, 5});
+		TEST_ASSERT(actual.str() == expected.str());
+		const std::string widest = "[1] UNIT_SPAWNED unitId=7 unitType=Hunter x=0 y=4294967295 \n";
+		TEST_ASSERT(actual.str().find(widest) != std::string::npos);
+
+		// Lines stay buffered until a block fills up or the log is flushed
+		std::ostringstream buffered;
+		sw::EventLog log(buffered);
+		log.log(1, UnitDied{1});
+		TEST_ASSERT(buffered.str().empty());
+		log.flush();
+		TEST_ASSERT(buffered.str() == "[1] UNIT_DIED unitId=1 \n");
+	}
+
+	void testEventArchiveQueriesSkipBlocks()
+	{
+		std::cout << "[Test] Event Archive Queries Skip Blocks..." << std::endl;
+		using namespace sw::core;
+		using namespace sw::io;
+
+		const std::string path = (std::filesystem::temp_directory_path() / "sw_archive_test.swa").string();
+		constexpr uint32_t Ticks = 3 * EventArchiveWriter::BlockEvents;
+		{
+			uint64_t tick = 1;
+			EventArchiveWriter writer(path, tick);
+			writer.onMapCreated(100, 50);
+			writer.onUnitSpawned(1, "Swordsman", {0, 0});
+			writer.onUnitSpawned(2, "Hunter", {99, 49});
+			for (tick = 2; tick < 2 + Ticks; ++tick)
+			{
+				const auto attacker = static_cast<UnitId>(tick);
+				writer.onUnitAttacked(attacker, attacker + 1, 3, static_cast<uint32_t>(tick % 7));
+				writer.onUnitMoved(2, {1, 1}, {static_cast<uint32_t>(tick % 100), 2});
+			}
+			writer.onUnitDied(2);
+			writer.finish();
+		}
+
+		EventArchiveReader archive(path);
+		std::vector<ArchivedEvent> rows;
+		auto collect = [&](const ArchiveQuery& query)
+		{
+			rows.clear();
+			return archive.query(query, [&](const ArchivedEvent& row) { rows.push_back(row); });
+		};
+
+		auto stats = collect({});
+		TEST_ASSERT_EQ(rows.size(), size_t{4} + 2 * Ticks);
+		TEST_ASSERT_EQ(stats.blocksSkipped, size_t{0});
+		// Rows come block by block; spawns were written with the last blocks
+		const auto isSpawn = [](const ArchivedEvent& row) { return row.event.kind == EventKind::UnitSpawned; };
+		const auto spawn = std::find_if(rows.begin(), rows.end(), isSpawn);
+		TEST_ASSERT(spawn != rows.end() && spawn->event.unitType == "Swordsman");
+		TEST_ASSERT((spawn + 1)->event.unitType == "Hunter" && (spawn + 1)->event.pos.x == 99);
+		TEST_ASSERT_EQ(spawn->unitTypeIndex, uint32_t{0});
+		TEST_ASSERT_EQ((spawn + 1)->unitTypeIndex, uint32_t{1});
+		TEST_ASSERT_EQ((spawn + 1)->event.damage, uint32_t{0});
+
+		// Attacks naming unit 5000 lie in one block; other types and ticks are skipped unread
+		ArchiveQuery query;
+		query.kinds = eventBit(EventKind::UnitAttacked);
+		query.unit = 5000;
+		stats = collect(query);
+		TEST_ASSERT_EQ(rows.size(), size_t{2});
+		TEST_ASSERT_EQ(rows[0].tick, uint64_t{4999});
+		TEST_ASSERT_EQ(rows[0].event.target, UnitId{5000});
+		TEST_ASSERT_EQ(rows[1].event.unit, UnitId{5000});
+		TEST_ASSERT_EQ(rows[1].event.targetHp, uint32_t{5000 % 7});
+		TEST_ASSERT_EQ(stats.blocksRead, size_t{1});
+
+		query = {};
+		query.fromTick = 100;
+		query.toTick = 101;
+		stats = collect(query);
+		TEST_ASSERT_EQ(rows.size(), size_t{4});
+		TEST_ASSERT(rows[0].event.kind == EventKind::UnitAttacked && rows[2].event.kind == EventKind::UnitMoved);
+		TEST_ASSERT_EQ(rows[3].event.to.x, uint32_t{1});
+		TEST_ASSERT_EQ(stats.blocksRead, size_t{2});
+		std::filesystem::remove(path);
+	}
+
+	void testLogIndexSeeksTicksAndUnits()
+	{
+		std::cout << "[Test] Log Index Seeks Ticks And Units..." << std::endl;
+		using namespace sw::io;
+
+		const auto directory = std::filesystem::temp_directory_path();
+		const std::string logPath = (directory / "sw_log_index_test.log").string();
+		const std::string indexPath = (directory / "sw_log_index_test.log.idx").string();
+		{
+			std::ofstream file(logPath, std::ios::binary);
+			sw::EventLog log(file);
+			log.log(1, MapCreated{20, 20});
+			for (uint32_t unit = 1; unit <= 10; ++unit)
+			{
+				log.log(1, UnitSpawned{unit, "Swordsman", unit, 0});
+			}
+			for (uint64_t tick = 2; tick <= 300; tick += 2)
+			{
+				const auto attacker = static_cast<uint32_t>(tick % 10 + 1);
+				log.log(tick, UnitAttacked{attacker, attacker % 10 + 1, 1, 5});
+				log.log(tick, UnitMoved{attacker, 3, 4});
+			}
+			log.flush();
+			file << "Battle ended at tick 300: no winner (10 units left)\n";
+		}
+		buildLogIndex(logPath, indexPath);
+
+		// Reference answers from a full scan
+		std::vector<std::string> lines;
+		{
+			std::ifstream file(logPath);
+			for (std::string line; std::getline(file, line);)
+			{
+				lines.push_back(line);
+			}
+		}
+		auto tickOf = [](const std::string& line) { return std::stoull(line.substr(1)); };
+
+		IndexedLog log(logPath, indexPath);
+		TEST_ASSERT_EQ(log.getTickCount(), uint64_t{151});
+		TEST_ASSERT_EQ(log.getUnitCount(), uint64_t{10});
+
+		std::vector<std::string> found;
+		auto collect = [&](std::string_view line) { found.emplace_back(line); };
+		log.forEachLineInTicks(99, 104, collect);
+		std::vector<std::string> expected;
+		std::copy_if(
+			lines.begin(),
+			lines.end(),
+			std::back_inserter(expected),
+			[&](const std::string& line)
+			{ return line.starts_with('[') && tickOf(line) >= 99 && tickOf(line) <= 104; });
+		TEST_ASSERT_EQ(found.size(), size_t{6});
+		TEST_ASSERT(found == expected);
+
+		found.clear();
+		log.forEachLineInTicks(301, 500, collect);
+		TEST_ASSERT(found.empty());
+
+		// Unit 4 is spawned and then only named as the target of unit 3
+		found.clear();
+		log.forEachLineOfUnit(4, collect);
+		expected.clear();
+		std::copy_if(
+			lines.begin(),
+			lines.end(),
+			std::back_inserter(expected),
+			[](const std::string& line)
+			{ return line.find("unitId=4 ") != std::string::npos || line.find("UnitId=4 ") != std::string::npos; });
+		TEST_ASSERT(!expected.empty());
+		TEST_ASSERT(found == expected);
+
+		found.clear();
+		log.forEachLineOfUnit(11, collect);
+		TEST_ASSERT(found.empty());
+
+		// An index built for a shorter log is refused
+		{
+			std::ofstream file(logPath, std::ios::binary | std::ios::app);
+			file << "[301] UNIT_DIED unitId=4 \n";
+		}
+		bool threw = false;
+		try
+		{
+			IndexedLog stale(logPath, indexPath);
+		}
+		catch (const std::runtime_error&)
+		{
+			threw = true;
+		}
+		TEST_ASSERT(threw);
+
+		// A tick count whose entry size wraps around to the real one is refused too
+		buildLogIndex(logPath, indexPath);
+		{
+			std::fstream file(indexPath, std::ios::binary | std::ios::in | std::ios::out);
+			file.seekg(16);
+			uint64_t ticks{};
+			file.read(reinterpret_cast<char*>(&ticks), sizeof(ticks));
+			ticks += uint64_t{1} << 60;
+			file.seekp(16);
+			file.write(reinterpret_cast<const char*>(&ticks), sizeof(ticks));
+		}
+		threw = false;
+		try
+		{
+			IndexedLog wrapped(logPath, indexPath);
+		}
+		catch (const std::runtime_error&)
+		{
+			threw = true;
+		}
+		TEST_ASSERT(threw);
+		std::filesystem::remove(logPath);
+		std::filesystem::remove(indexPath);
+	}
+
+	void testDecisionLogReplaysBattle()
+	{
+		std::cout << "[Test] Decision Log Replays Battle..." << std::endl;
+		// Unit 1 has four adjacent targets each tick, so its choices depend on the seed
+		const std::string scenario =
+			"CREATE_MAP 10 10\n"
+			"SPAWN_SWORDSMAN 1 5 5 40 1\n"
+			"SPAWN_SWORDSMAN 2 4 5 9 1\n"
+			"SPAWN_SWORDSMAN 3 6 5 9 1\n"
+			"SPAWN_SWORDSMAN 4 5 4 9 1\n"
+			"SPAWN_SWORDSMAN 5 5 6 9 1\n";
+		const std::string path = (std::filesystem::temp_directory_path() / "sw_decisions_test.swd").string();
+		auto play = [&](uint64_t seed, sw::core::IChoiceTape* choices, uint64_t logFromTick = 0)
+		{
+			sw::app::ScenarioRunner runner;
+			sw::app::ScenarioOptions options;
+			options.seed = seed;
+			options.choices = choices;
+			options.logFromTick = logFromTick;
+			std::ostringstream out;
+			runner.run(std::string_view(scenario), options, out);
+			return out.str();
+		};
+
+		std::string recorded;
+		{
+			sw::app::DecisionRecorder recorder(path);
+			recorded = play(1, &recorder);
+			recorder.finish();
+			TEST_ASSERT(recorder.getCount() > 10);
+		}
+		TEST_ASSERT(play(2, nullptr) != recorded);
+
+		// Another seed replays the same battle from the decisions alone
+		{
+			sw::app::DecisionReplayer replayer(path);
+			TEST_ASSERT(play(2, &replayer) == recorded);
+			replayer.finish();
+		}
+
+		// Headless up to tick 5, then the same lines as the full log
+		std::string expected;
+		std::istringstream lines(recorded);
+		for (std::string line; std::getline(lines, line);)
+		{
+			if (std::stoull(line.substr(1)) >= 5)
+			{
+				expected += line + "\n";
+			}
+		}
+		{
+			sw::app::DecisionReplayer replayer(path);
+			const auto tail = play(3, &replayer, 5);
+			TEST_ASSERT(!tail.empty());
+			TEST_ASSERT(tail == expected);
+		}
+
+		// The log holds one battle; a second replay runs out of choices
+		bool threw = false;
+		try
+		{
+			sw::app::DecisionReplayer replayer(path);
+			play(2, &replayer, 0);
+			play(2, &replayer, 0);
+		}
+		catch (const std::runtime_error&)
+		{
+			threw = true;
+		}
+		TEST_ASSERT(threw);
+		std::filesystem::remove(path);
+
+		// A deferred log keeps the checkpoint phase of a full run
+		auto checkpointTicks = [](uint64_t logFromTick)
+		{
+			sw::app::ScenarioRunner runner;
+			sw::app::ScenarioOptions options;
+			options.logFromTick = logFromTick;
+			options.simulation.fastForward = true;
+			options.simulation.checkpointEvery = 100;
+			std::vector<uint64_t> ticks;
+			options.simulation.onCheckpoint = [&](const sw::core::GameWorld&, uint64_t nextTick)
+			{ ticks.push_back(nextTick); };
+			std::ostringstream out;
+			runner.run(
+				std::string_view("CREATE_MAP 400 3\nSPAWN_SWORDSMAN 1 0 0 5 1\nSPAWN_SWORDSMAN 2 0 2 5 1\n"
+								 "MARCH 1 399 0\nMARCH 2 399 2\n"),
+				options,
+				out);
+			return ticks;
+		};
+		const auto full = checkpointTicks(0);
+		TEST_ASSERT_EQ(full.size(), size_t{3});
+		TEST_ASSERT(checkpointTicks(150) == full);
+	}
 }
 
 int main()
@@ -317,6 +2222,35 @@ int main()
 		testUnitDeathCycle();
 		testImplicitTargetingHealthComponent();
 		testAddBehaviorRejectsNull();
+		testCellLayersTrackUnits();
+		testCellBitmapRingMatchesScan();
+		testChunkCountsMatchScan();
+		testRangeStrategyAdapts();
+		testRangeStrategiesAgreeOnSharedCells();
+		testTiledLayoutMatchesRowMajor();
+		testUnitStorageStableAcrossRemoval();
+		testFunctionRefForwardsCalls();
+		testFlowFieldIncrementalMatchesRebuild();
+		testMarchDetoursAroundWall();
+		testTerrainBlocksMovementAndSight();
+		testTerrainFileRoundTrip();
+		testFastForwardMatchesTickByTick();
+		testSnapshotResumeMatchesUninterrupted();
+		testForkedWorldsRunIndependently();
+		testStateHashTracksMutations();
+		testTimelineRewindsAndReplays();
+		testServerAnswersFramedRequests();
+		testScenarioStreamsTaggedCommands();
+		testCommandParserDispatch();
+		testParallelParseKeepsFileOrder();
+		testCompiledScenarioMatchesText();
+		testFormationCommandsMatchSingleSpawns();
+		testQuietRunPrintsSummary();
+		testEventBusRoutesByKind();
+		testEventLogMatchesStreamFormat();
+		testEventArchiveQueriesSkipBlocks();
+		testLogIndexSeeksTicksAndUnits();
+		testDecisionLogReplaysBattle();
 		
 		std::cout << "All extended unit tests passed!" << std::endl;
 	} catch (const std::exception& e) {
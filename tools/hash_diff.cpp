@@ -0,0 +1,63 @@
+// Reports the first tick at which two hash traces (sw_battle_test --hash-trace) diverge.
+// Usage: sw_hash_diff <expected_trace> <actual_trace>
+// Exit code: 0 if the traces match, 1 on divergence, 2 on bad input.
+#include "App/HashTrace.hpp"
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+	void printHash(const std::optional<uint64_t>& hash)
+	{
+		if (hash)
+		{
+			std::printf("%016llx", static_cast<unsigned long long>(*hash));
+		}
+		else
+		{
+			std::printf("(run ended)");
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <expected_trace> <actual_trace>" << std::endl;
+		return 2;
+	}
+
+	std::ifstream expected(argv[1]);
+	std::ifstream actual(argv[2]);
+	if (!expected.is_open() || !actual.is_open())
+	{
+		std::cerr << "Failed to open file: " << (expected.is_open() ? argv[2] : argv[1]) << std::endl;
+		return 2;
+	}
+
+	try
+	{
+		const auto divergence = sw::app::findFirstDivergence(expected, actual);
+		if (!divergence)
+		{
+			std::printf("Traces match\n");
+			return 0;
+		}
+
+		std::printf("First divergence at tick %llu: expected ", static_cast<unsigned long long>(divergence->tick));
+		printHash(divergence->expected);
+		std::printf(", actual ");
+		printHash(divergence->actual);
+		std::printf("\n");
+		return 1;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 2;
+	}
+}
@@ -0,0 +1,119 @@
+// Random access into text event logs (sw_battle_test output) through a sidecar index.
+// `build` writes the index in one pass over the log; `tick` and `unit` seek straight to the matching lines,
+// (re)building <log>.idx first when it is missing or older than the log.
+// Usage: sw_log_index build <log> [index]
+//        sw_log_index tick <log> <from> [to]
+//        sw_log_index unit <log> <id>
+// Exit code: 0 on success, 1 on bad usage or an unreadable log or index.
+#include "IO/System/LogIndex.hpp"
+
+#include <charconv>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+	uint64_t parseNumber(std::string_view text)
+	{
+		uint64_t value{};
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (error != std::errc{} || end != text.data() + text.size())
+		{
+			throw std::invalid_argument("Invalid number: " + std::string(text));
+		}
+		return value;
+	}
+
+	bool isIndexCurrent(const std::string& logPath, const std::string& indexPath)
+	{
+		std::error_code error;
+		const auto indexTime = std::filesystem::last_write_time(indexPath, error);
+		return !error && indexTime >= std::filesystem::last_write_time(logPath);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const std::string usage = std::string("Usage: ") + argv[0] + " build <log> [index]\n       " + argv[0]
+							  + " tick <log> <from> [to]\n       " + argv[0] + " unit <log> <id>";
+	std::string_view mode;
+	std::string logPath;
+	std::string indexPath;
+	uint64_t from{};
+	uint64_t to{};
+	try
+	{
+		if (argc < 3)
+		{
+			throw std::invalid_argument("Missing arguments");
+		}
+		mode = argv[1];
+		logPath = argv[2];
+		indexPath = logPath + ".idx";
+		if (mode == "build" && argc <= 4)
+		{
+			if (argc == 4)
+			{
+				indexPath = argv[3];
+			}
+		}
+		else if (mode == "tick" && (argc == 4 || argc == 5))
+		{
+			from = parseNumber(argv[3]);
+			to = argc == 5 ? parseNumber(argv[4]) : from;
+		}
+		else if (mode == "unit" && argc == 4)
+		{
+			from = parseNumber(argv[3]);
+		}
+		else
+		{
+			throw std::invalid_argument("Unexpected arguments");
+		}
+	}
+	catch (const std::invalid_argument& e)
+	{
+		std::cerr << e.what() << std::endl << usage << std::endl;
+		return 1;
+	}
+
+	try
+	{
+		if (mode == "build" || !isIndexCurrent(logPath, indexPath))
+		{
+			sw::io::buildLogIndex(logPath, indexPath);
+		}
+		const sw::io::IndexedLog log(logPath, indexPath);
+		if (mode == "build")
+		{
+			std::cerr << log.getTickCount() << " ticks, " << log.getUnitCount() << " units indexed" << std::endl;
+			return 0;
+		}
+
+		std::ios::sync_with_stdio(false);
+		auto print = [](std::string_view line)
+		{
+			std::cout.write(line.data(), static_cast<std::streamsize>(line.size()));
+			std::cout.put('\n');
+		};
+		if (mode == "tick")
+		{
+			log.forEachLineInTicks(from, to, print);
+		}
+		else
+		{
+			log.forEachLineOfUnit(static_cast<sw::core::UnitId>(from), print);
+		}
+		std::cout.flush();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
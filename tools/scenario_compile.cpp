@@ -0,0 +1,34 @@
+// Compiles a text scenario into the binary form sw_battle_test plays without parsing (see App/CompiledScenario.hpp).
+// Usage: sw_scenario_compile <scenario_file> <output.swb>
+// Exit code: 0 on success, 1 on bad usage or a scenario that does not parse.
+#include "App/CompiledScenario.hpp"
+#include "App/ScenarioRunner.hpp"
+#include "IO/System/MappedFile.hpp"
+
+#include <exception>
+#include <iostream>
+#include <string_view>
+
+int main(int argc, char** argv)
+{
+	if (argc != 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <scenario_file> <output.swb>" << std::endl;
+		return 1;
+	}
+
+	try
+	{
+		sw::io::MappedFile file(argv[1]);
+		const auto bytes = file.bytes();
+		const std::string_view text(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+		const auto compiled = sw::app::ScenarioRunner::compile(text, sw::app::describeScenarioFile(argv[1], text));
+		sw::app::writeCompiledScenario(argv[2], compiled);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << argv[1] << ": " << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}